@@ -6,6 +6,7 @@
 #include "Core/Log.h"
 #include "GLFW/glfw3.h"
 #include "Managers/TransformsManager.h"
+#include "Core/Memory/MemoryStats.h"
 #include "imgui.h"
 
 DefineClassInfo(CamInput, Framework::Component);
@@ -99,5 +100,8 @@ CamInput::Update()
 
         static bool show_metrics = true;
         ImGui::ShowMetricsWindow(&show_metrics);
+
+        static bool show_memory = true;
+        Memory::ShowStatsWindow(&show_memory);
     }
 }
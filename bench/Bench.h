@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+
+// Small helpers shared by the benchmark executables, results are printed as
+// one JSON object per line (or CSV with --csv) so they can be diffed and plotted.
+namespace Bench {
+
+inline uint64_t
+Now()
+{
+    return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// xorshift64*, deterministic across platforms so runs are comparable.
+class Random {
+private:
+    uint64_t state;
+public:
+    Random(uint64_t seed = 0x9e3779b97f4a7c15ull) : state(seed ? seed : 1) { }
+
+    uint64_t Next()
+    {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 0x2545f4914f6cdd1dull;
+    }
+
+    uint32_t Range(uint32_t min, uint32_t max) // [min, max]
+    {
+        return min + uint32_t(this->Next() % (uint64_t(max - min) + 1));
+    }
+};
+
+// Per operation latencies, ns/op comes from a separate untimed run since
+// reading the clock around every op adds its own overhead.
+class Samples {
+private:
+    std::vector<uint32_t> ns;
+public:
+    void Reserve(size_t count) { ns.reserve(count); }
+    void Clear() { ns.clear(); }
+    void Add(uint64_t t) { ns.push_back(uint32_t(t > 0xffffffffull ? 0xffffffffull : t)); }
+    void Append(const Samples &other) { ns.insert(ns.end(), other.ns.begin(), other.ns.end()); }
+    size_t Count() const { return ns.size(); }
+
+    void Sort() { std::sort(ns.begin(), ns.end()); }
+
+    // Samples must be sorted.
+    uint32_t Percentile(double p) const
+    {
+        if (ns.empty())
+            return 0;
+        size_t index = size_t(p * double(ns.size() - 1) + 0.5);
+        return ns[index];
+    }
+};
+
+struct Options {
+    bool csv;
+    uint32_t ops;
+    uint32_t repeat;
+    const char *filter;
+
+    Options() : csv(false), ops(100000), repeat(3), filter(nullptr) { }
+
+    // Returns the index of the first argument it didn't recognize, or argc.
+    int Parse(int argc, char **argv)
+    {
+        int i = 1;
+        for (; i < argc; ++i) {
+            if (0 == strcmp(argv[i], "--csv"))
+                csv = true;
+            else if (0 == strcmp(argv[i], "--ops") && i + 1 < argc)
+                ops = uint32_t(strtoul(argv[++i], nullptr, 10));
+            else if (0 == strcmp(argv[i], "--repeat") && i + 1 < argc)
+                repeat = uint32_t(strtoul(argv[++i], nullptr, 10));
+            else if (0 == strcmp(argv[i], "--filter") && i + 1 < argc)
+                filter = argv[++i];
+            else
+                break;
+        }
+        return i;
+    }
+
+    bool Match(const char *subject, const char *pattern) const
+    {
+        return nullptr == filter || strstr(subject, filter) != nullptr || strstr(pattern, filter) != nullptr;
+    }
+};
+
+// Overhead of one Now() pair, reported so latencies can be read net of it.
+inline uint32_t
+MeasureTimerOverhead()
+{
+    Samples samples;
+    samples.Reserve(10000);
+    for (int i = 0; i < 10000; ++i) {
+        uint64_t t0 = Now();
+        samples.Add(Now() - t0);
+    }
+    samples.Sort();
+    return samples.Percentile(0.5);
+}
+
+inline void
+PrintHeader(const Options &options)
+{
+    if (options.csv)
+        printf("suite,subject,pattern,ops,ns_per_op,p50,p90,p99,p999,max,timer_ns\n");
+}
+
+inline void
+Report(const Options &options, const char *suite, const char *subject, const char *pattern,
+       uint64_t ops, uint64_t totalNs, Samples &samples, uint32_t timerNs)
+{
+    samples.Sort();
+
+    double nsPerOp = ops > 0 ? double(totalNs) / double(ops) : 0.0;
+    if (options.csv) {
+        printf("%s,%s,%s,%llu,%.2f,%u,%u,%u,%u,%u,%u\n", suite, subject, pattern,
+            (unsigned long long)ops, nsPerOp,
+            samples.Percentile(0.5), samples.Percentile(0.9), samples.Percentile(0.99),
+            samples.Percentile(0.999), samples.Percentile(1.0), timerNs);
+    } else {
+        printf("{\"suite\":\"%s\",\"subject\":\"%s\",\"pattern\":\"%s\",\"ops\":%llu,\"ns_per_op\":%.2f,"
+            "\"p50\":%u,\"p90\":%u,\"p99\":%u,\"p999\":%u,\"max\":%u,\"timer_ns\":%u}\n", suite, subject, pattern,
+            (unsigned long long)ops, nsPerOp,
+            samples.Percentile(0.5), samples.Percentile(0.9), samples.Percentile(0.99),
+            samples.Percentile(0.999), samples.Percentile(1.0), timerNs);
+    }
+    fflush(stdout);
+}
+
+} // namespace Bench
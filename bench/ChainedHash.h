@@ -0,0 +1,519 @@
+#pragma once
+
+#include <functional>
+#include "Core/Collections/Array.h"
+
+// The chained Hash<T> the open addressing one replaced, kept so bench_hash can compare them.
+namespace Bench {
+
+using Framework::Allocator;
+using Framework::Array;
+
+struct ChainedHashEntry {
+	uint32_t key;
+	uint32_t index;
+	uint32_t prev;
+	uint32_t next;
+};
+
+template <typename T>
+class ChainedHash {
+private:
+    static const uint32_t kEndOfList = 0xffffffff;
+
+    Array<uint32_t> map;
+	Array<ChainedHashEntry> entries;
+    Array<T> data;
+
+    bool IsFull() const;
+    void Grow();
+
+	const ChainedHashEntry* FindFirst(uint32_t key) const;
+	ChainedHashEntry* FindFirst(uint32_t key);
+	const ChainedHashEntry* FindNext(const ChainedHashEntry *entry) const;
+	ChainedHashEntry* FindNext(ChainedHashEntry *entry);
+
+	ChainedHashEntry* Insert(uint32_t key, const T& item);
+	void Erase(ChainedHashEntry *entry);
+public:
+    ChainedHash(Allocator &allocator);
+    ChainedHash(Allocator &allocator, uint32_t initialMapSize);
+    ChainedHash(const ChainedHash<T> &other);
+    ChainedHash(ChainedHash<T> &&other);
+
+    ChainedHash<T>& operator =(const ChainedHash<T> &other);
+    ChainedHash<T>& operator =(ChainedHash<T> &&other);
+
+    ChainedHash<T> Rehash(uint32_t newMapSize);
+
+    Allocator& GetAllocator() const;
+    uint32_t Count() const;
+    uint32_t Count(uint32_t key) const;
+    bool IsEmpty() const;
+
+    const T* Begin() const;
+    T* Begin();
+    const T* End() const;
+    T* End();
+
+    T* Get(uint32_t key);
+    const T* Get(uint32_t key) const;
+    Array<T*> GetAll(uint32_t key, Allocator &allocator);
+
+    T* Find(uint32_t key, std::function<bool(const T&)> f);
+    Array<T*> FindAll(uint32_t key, Allocator &allocator, std::function<bool(const T&)> f);
+
+    T* Next(T *item);
+    const T* Next(const T *item) const;
+
+    void Clear();
+    void Add(uint32_t key, const T& item);
+    void Set(uint32_t key, const T& item);
+
+    void Remove(T *item);
+    void RemoveIf(uint32_t key, std::function<bool(const T&)> f);
+    void RemoveAll(uint32_t key);
+};
+
+template <typename T>
+inline
+ChainedHash<T>::ChainedHash(Allocator &allocator)
+: map(allocator),
+  entries(allocator),
+  data(allocator)
+{ }
+
+template <typename T>
+inline
+ChainedHash<T>::ChainedHash(Allocator &allocator, uint32_t initialMapSize)
+: map(allocator, initialMapSize),
+  entries(allocator),
+  data(allocator)
+{
+    map.Resize(initialMapSize);
+    for (uint32_t i = 0; i < initialMapSize; ++i)
+        map[i] = kEndOfList;
+}
+
+template <typename T>
+inline
+ChainedHash<T>::ChainedHash(const ChainedHash<T> &other)
+: map(other.map),
+  entries(other.entries),
+  data(other.data)
+{ }
+
+template <typename T>
+inline
+ChainedHash<T>::ChainedHash(ChainedHash<T> &&other)
+: map(std::forward<Array<uint32_t>>(other.map)),
+  entries(std::forward<Array<ChainedHashEntry>>(other.entries)),
+  data(std::forward<Array<T>>(other.data))
+{ }
+
+template <typename T>
+inline ChainedHash<T>&
+ChainedHash<T>::operator =(const ChainedHash<T> &other)
+{
+    map = other.map;
+    entries = other.entries;
+    data = other.data;
+    return (*this);
+}
+
+template <typename T>
+inline ChainedHash<T>&
+ChainedHash<T>::operator =(ChainedHash<T> &&other)
+{
+    map = std::forward<Array<uint32_t>>(other.map);
+	entries = std::forward<Array<ChainedHashEntry>>(other.entries);
+	data = std::forward<Array<T>>(other.data);
+    return (*this);
+}
+
+template <typename T>
+inline bool
+ChainedHash<T>::IsFull() const
+{
+    const float maxLoadFactor = 0.7f;
+    return (0 == map.Count() || entries.Count() >= (map.Count() * maxLoadFactor));
+}
+
+template <typename T>
+inline void
+ChainedHash<T>::Grow()
+{
+    (*this) = this->Rehash(map.Count() * 2 + 8);
+}
+
+template <typename T>
+inline ChainedHash<T>
+ChainedHash<T>::Rehash(uint32_t newMapSize)
+{
+    ChainedHash<T> h(map.GetAllocator(), newMapSize);
+	ChainedHashEntry *entry = entries.Begin(), *end = entries.End();
+    for (; entry < end; ++entry)
+        h.Insert(entry->key, data[entry->index]);
+    return h;
+}
+
+template <typename T>
+inline const ChainedHashEntry*
+ChainedHash<T>::FindFirst(uint32_t key) const
+{
+    if (map.IsEmpty())
+        return nullptr;
+
+    uint32_t hash  = key % map.Count(),
+             index = map[hash];
+
+    if (kEndOfList == index)
+        return nullptr;
+    else {
+        while (entries[index].key != key) {
+            index = entries[index].next;
+
+            if (kEndOfList == index)
+                return nullptr;
+        }
+
+        return entries.Begin() + index;
+    }
+}
+
+template <typename T>
+inline ChainedHashEntry*
+ChainedHash<T>::FindFirst(uint32_t key)
+{
+    if (map.IsEmpty())
+        return nullptr;
+
+    uint32_t hash  = key % map.Count(),
+             index = map[hash];
+
+    if (kEndOfList == index)
+        return nullptr;
+    else {
+        while (entries[index].key != key) {
+            index = entries[index].next;
+            
+            if (kEndOfList == index)
+                return nullptr;
+        }
+
+        return entries.Begin() + index;
+    }
+}
+
+template <typename T>
+inline const ChainedHashEntry*
+ChainedHash<T>::FindNext(const ChainedHashEntry *entry) const
+{
+    uint32_t next = entry->next;
+    if (kEndOfList == next || entries[next].key != entry->key)
+        return nullptr;
+    return entries.Begin() + next;
+}
+
+template <typename T>
+inline ChainedHashEntry*
+ChainedHash<T>::FindNext(ChainedHashEntry *entry)
+{
+    uint32_t next = entry->next;
+    if (kEndOfList == next || entries[next].key != entry->key)
+        return nullptr;
+    return entries.Begin() + next;
+}
+
+template <typename T>
+inline ChainedHashEntry*
+ChainedHash<T>::Insert(uint32_t key, const T& item)
+{
+    if (this->IsFull())
+        this->Grow();
+
+	entries.PushBack(ChainedHashEntry());
+    data.PushBack(item);
+
+	ChainedHashEntry &entry = entries.Back();
+
+    uint32_t entryIndex = &entry - entries.Begin(),
+             entryHash  = key % map.Count();
+
+    entry.key   = key;
+    entry.index = entryIndex;
+    entry.prev  = kEndOfList;
+    entry.next  = kEndOfList;
+
+    ChainedHashEntry *firstEntry = this->FindFirst(key);
+    if (nullptr == firstEntry)
+        firstEntry = (kEndOfList == map[entryHash] ? nullptr : entries.Begin() + map[entryHash]);
+
+    if (nullptr == firstEntry) {
+        map[entryHash] = entryIndex;
+    } else {
+        entry.prev = firstEntry->prev;
+        if (kEndOfList == entry.prev)
+            map[entryHash] = entryIndex;
+        else
+            entries[entry.prev].next = entryIndex;
+
+        entry.next = firstEntry->index;
+        firstEntry->prev = entryIndex;
+    }
+
+    return &entry;
+}
+
+template <typename T>
+inline void
+ChainedHash<T>::Erase(ChainedHashEntry *entry)
+{
+    if (kEndOfList == entry->prev)
+        map[entry->key % map.Count()] = entry->next;
+    else
+        entries[entry->prev].next = entry->next;
+
+    if (entry->next != kEndOfList)
+        entries[entry->next].prev = entry->prev;
+
+    int index     = entry->index,
+        lastIndex = entries.Count() - 1;
+
+    if (index == lastIndex) {
+        entries.PopBack();
+        data.PopBack();
+        return;
+    }
+
+    entries[index] = entries[lastIndex];
+    Framework::Memory::Move(data.Begin() + index, data.Begin() + lastIndex, 1);
+
+    entries.PopBack();
+    data.PopBack();
+
+	ChainedHashEntry *movedEntry = entries.Begin() + index;
+    movedEntry->index = index;
+    if (kEndOfList == movedEntry->prev)
+        map[movedEntry->key % map.Count()] = index;
+    else
+        entries[movedEntry->prev].next = index;
+    if (movedEntry->next != kEndOfList)
+        entries[movedEntry->next].prev = index;
+}
+
+template <typename T>
+Allocator&
+ChainedHash<T>::GetAllocator() const
+{
+    return map.GetAllocator();
+}
+
+template <typename T>
+inline uint32_t
+ChainedHash<T>::Count() const
+{
+    return entries.Count();
+}
+
+template <typename T>
+inline uint32_t
+ChainedHash<T>::Count(uint32_t key) const
+{
+	ChainedHashEntry *entry = this->FindFirst(key);
+    uint32_t counter = 0;
+    while (entry != nullptr) {
+        ++counter;
+        entry = this->FindNext(entry);
+    }
+    return counter;
+}
+
+template <typename T>
+inline bool
+ChainedHash<T>::IsEmpty() const
+{
+    return entries.IsEmpty();
+}
+
+template <typename T>
+inline const T*
+ChainedHash<T>::Begin() const
+{
+    return data.Begin();
+}
+
+template <typename T>
+inline T*
+ChainedHash<T>::Begin()
+{
+    return data.Begin();
+}
+
+template <typename T>
+inline const T*
+ChainedHash<T>::End() const
+{
+    return data.End();
+}
+
+template <typename T>
+inline T*
+ChainedHash<T>::End()
+{
+    return data.End();
+}
+
+template <typename T>
+inline T*
+ChainedHash<T>::Get(uint32_t key)
+{
+	const ChainedHashEntry *entry = this->FindFirst(key);
+    if (nullptr == entry)
+        return nullptr;
+    else
+        return data.Begin() + entry->index;
+}
+
+template <typename T>
+inline const T*
+ChainedHash<T>::Get(uint32_t key) const
+{
+	const ChainedHashEntry *entry = this->FindFirst(key);
+    if (nullptr == entry)
+        return nullptr;
+    else
+        return data.Begin() + entry->index;
+}
+
+template <typename T>
+inline Array<T*>
+ChainedHash<T>::GetAll(uint32_t key, Allocator &allocator)
+{
+    Array<T*> array(allocator);
+	ChainedHashEntry *entry = this->FindFirst(key);
+    while (entry != nullptr) {
+        array.PushBack(data.Begin() + entry->index);
+        entry = this->FindNext(entry);
+    }
+    return array;
+}
+
+template <typename T>
+inline T*
+ChainedHash<T>::Find(uint32_t key, std::function<bool(const T&)> f)
+{
+	ChainedHashEntry *entry = this->FindFirst(key);
+    while (entry != nullptr) {
+        if (f(data[entry->index]))
+            return data.Begin() + entry->index;
+        entry = this->FindNext(entry);
+    }
+    return nullptr;
+}
+
+template <typename T>
+inline Array<T*>
+ChainedHash<T>::FindAll(uint32_t key, Allocator &allocator, std::function<bool(const T&)> f)
+{
+    Array<T*> array(allocator);
+	ChainedHashEntry *entry = this->FindFirst(key);
+    while (entry != nullptr) {
+        if (f(data[entry->index]))
+            array.PushBack(data.Begin() + entry->index);
+        entry = this->FindNext(entry);
+    }
+    return array;
+}
+
+template <typename T>
+inline T*
+ChainedHash<T>::Next(T *item)
+{
+    uint32_t index = item - data.Begin();
+    assert(index < data.Count());
+	ChainedHashEntry *entry = entries.Begin() + index;
+    entry = this->FindNext(entry);
+    if (nullptr == entry)
+        return nullptr;
+    else
+        return data.Begin() + entry->index;
+}
+
+template <typename T>
+inline const T*
+ChainedHash<T>::Next(const T *item) const
+{
+    uint32_t index = item - data.Begin();
+    assert(index < data.Count());
+	const ChainedHashEntry *entry = entries.Begin() + index;
+    entry = this->FindNext(entry);
+    if (nullptr == entry)
+        return nullptr;
+    else
+        return data.Begin() + entry->index;
+}
+
+template <typename T>
+inline void
+ChainedHash<T>::Clear()
+{
+    for (uint32_t i = 0, l = map.Count(); i < l; ++i)
+        map[i] = kEndOfList;
+    entries.Clear();
+    data.Clear();
+}
+
+template <typename T>
+inline void
+ChainedHash<T>::Add(uint32_t key, const T& item)
+{
+    this->Insert(key, item);
+}
+
+template <typename T>
+inline void
+ChainedHash<T>::Set(uint32_t key, const T& item)
+{
+	ChainedHashEntry *entry = this->FindFirst(key);
+    if (nullptr == entry)
+        this->Insert(key, item);
+    else
+        data[entry->index] = item;
+}
+
+template <typename T>
+inline void
+ChainedHash<T>::Remove(T *item)
+{
+    assert(item >= data.Begin() && item < data.End());
+	ChainedHashEntry *entry = entries.Begin() + (item - data.Begin());
+    this->Erase(entry);
+}
+
+template <typename T>
+inline void
+ChainedHash<T>::RemoveIf(uint32_t key, std::function<bool(const T&)> f)
+{
+	const ChainedHashEntry *entry = this->FindFirst(key);
+    while (entry != nullptr) {
+		const ChainedHashEntry *tmp = entry;
+        entry = this->FindNext(entry);
+        if (f(data[tmp->index]))
+            this->Erase(tmp);
+    }
+}
+
+template <typename T>
+inline void
+ChainedHash<T>::RemoveAll(uint32_t key)
+{
+	ChainedHashEntry *entry = this->FindFirst(key);
+    while (entry != nullptr) {
+		ChainedHashEntry *tmp = entry;
+        entry = this->FindNext(entry);
+        this->Erase(tmp);
+    }
+}
+
+} // namespace Bench
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "Core/Collections/Array.h"
+
+// The chained id -> index table BasePool used before generational ids, kept so bench_handles can compare them.
+// Entries mirror the objects, entry i belongs to object i.
+namespace Bench {
+
+using Framework::Allocator;
+using Framework::Array;
+
+class HashedIds {
+private:
+    static const uint32_t kEndOfList = 0xffffffff;
+
+    struct Entry {
+        uint32_t id;
+        uint32_t index;
+        uint32_t prev;
+        uint32_t next;
+    };
+
+    Array<uint32_t> map;
+    Array<Entry> entries;
+
+    bool IsFull() const
+    {
+        return (0 == map.Count() || entries.Count() >= (map.Count() * 0.7f));
+    }
+
+    void Rehash(uint32_t newMapSize)
+    {
+        Array<uint32_t> ids(entries.GetAllocator(), entries.Count());
+        for (const Entry *entry = entries.Begin(); entry < entries.End(); ++entry)
+            ids.PushBack(entry->id);
+
+        map.Resize(newMapSize);
+        for (uint32_t i = 0; i < newMapSize; ++i)
+            map[i] = kEndOfList;
+
+        entries.Clear();
+        for (const uint32_t *id = ids.Begin(); id < ids.End(); ++id)
+            this->Link(*id);
+    }
+
+    void Link(uint32_t id)
+    {
+        entries.PushBack(Entry());
+        Entry &entry = entries.Back();
+
+        uint32_t entryIndex = &entry - entries.Begin(),
+                 entryHash  = id % map.Count();
+
+        entry.id    = id;
+        entry.index = entryIndex;
+        entry.prev  = kEndOfList;
+        entry.next  = map[entryHash];
+
+        map[entryHash] = entryIndex;
+        if (entry.next != kEndOfList)
+            entries[entry.next].prev = entryIndex;
+    }
+public:
+    HashedIds(Allocator &allocator)
+    : map(allocator),
+      entries(allocator)
+    { }
+
+    // The new id gets the next object index.
+    void Insert(uint32_t id)
+    {
+        if (this->IsFull())
+            this->Rehash(map.Count() * 2 + 8);
+        this->Link(id);
+    }
+
+    // Like BasePool::Remove, the last entry moves into the hole as the last object does.
+    void Remove(uint32_t index)
+    {
+        Entry *entry = entries.Begin() + index;
+        if (kEndOfList == entry->prev)
+            map[entry->id % map.Count()] = entry->next;
+        else
+            entries[entry->prev].next = entry->next;
+
+        if (entry->next != kEndOfList)
+            entries[entry->next].prev = entry->prev;
+
+        uint32_t lastIndex = entries.Count() - 1;
+        if (index == lastIndex) {
+            entries.PopBack();
+            return;
+        }
+
+        entries[index] = entries[lastIndex];
+        entries.PopBack();
+
+        Entry *movedEntry = entries.Begin() + index;
+        movedEntry->index = index;
+        if (kEndOfList == movedEntry->prev)
+            map[movedEntry->id % map.Count()] = index;
+        else
+            entries[movedEntry->prev].next = index;
+
+        if (movedEntry->next != kEndOfList)
+            entries[movedEntry->next].prev = index;
+    }
+
+    // Object index of id, or kEndOfList.
+    uint32_t Find(uint32_t id) const
+    {
+        if (0 == entries.Count())
+            return kEndOfList;
+
+        uint32_t mapIndex = map[id % map.Count()];
+        while (mapIndex != kEndOfList) {
+            const Entry *entry = entries.Begin() + mapIndex;
+            if (entry->id == id)
+                return entry->index;
+            mapIndex = entry->next;
+        }
+        return kEndOfList;
+    }
+};
+
+} // namespace Bench
@@ -0,0 +1,205 @@
+#include <algorithm>
+#include <vector>
+#include "Core/Memory/Memory.h"
+#include "Core/Memory/MallocAllocator.h"
+#include "Core/Pool/Pool.h"
+#include "Core/Pool/BaseObject.h"
+#include "HashedIds.h"
+#include "Bench.h"
+
+// Compares handle dereference through the generational slots of BasePool, contiguous and chunked,
+// with the hashed ids it replaced:
+//   bench_handles [--csv] [--ops N] [--repeat N] [--filter name]
+// --ops is the number of live objects. Stale ids are checked first, the run fails if any resolves.
+
+using namespace Framework;
+
+class Body : public BaseObject {
+    DeclareClassInfo;
+public:
+    float position[3];
+    float velocity[3];
+
+    Body() : position(), velocity() { }
+};
+
+DefineClassInfo(Body, Framework::BaseObject);
+
+// Same footprint as Body, objects in BasePool carry a vtable, the pool and the id.
+struct PlainBody {
+    uint32_t id;
+    float position[3];
+    float velocity[3];
+    uint8_t padding[sizeof(Body) - 28];
+};
+
+enum Pattern {
+    Iterate,    // handles in creation order, like walking a HandleList
+    Scattered,  // handles in random order
+    Stale       // handles of destroyed objects
+};
+
+// Creates 2 * ops objects and destroys half of them at random, so the survivors are shuffled
+// around the storage as they would be after some play.
+static void
+Churn(uint32_t ops, std::vector<uint32_t> &live, std::vector<uint32_t> &dead, std::vector<uint32_t> &order)
+{
+    Bench::Random rnd(1);
+
+    std::vector<uint32_t> all(ops * 2);
+    for (uint32_t i = 0; i < ops * 2; ++i)
+        all[i] = i;
+    for (uint32_t i = ops * 2 - 1; i > 0; --i)
+        std::swap(all[i], all[rnd.Range(0, i)]);
+
+    dead.assign(all.begin(), all.begin() + ops);
+    live.assign(all.begin() + ops, all.end());
+    std::sort(live.begin(), live.end());
+
+    order.resize(ops);
+    for (uint32_t i = 0; i < ops; ++i)
+        order[i] = i;
+    for (uint32_t i = ops - 1; i > 0; --i)
+        std::swap(order[i], order[rnd.Range(0, i)]);
+}
+
+static uint64_t
+RunPool(uint32_t ops, Pattern pattern, BasePool::Storage storage)
+{
+    std::vector<uint32_t> live, dead, order;
+    Churn(ops, live, dead, order);
+
+    Pool<Body> pool(Memory::GetAllocator<MallocAllocator>(), storage);
+    std::vector<Handle<Body>> created(ops * 2);
+    for (uint32_t i = 0; i < ops * 2; ++i)
+        created[i] = pool.NewInstance();
+    for (uint32_t i : dead)
+        pool.DeleteInstance(created[i]);
+
+    std::vector<Handle<Body>> handles(ops);
+    for (uint32_t i = 0; i < ops; ++i)
+        handles[i] = created[Stale == pattern ? dead[i] : live[Scattered == pattern ? order[i] : i]];
+
+    float sum = 0.0f;
+    uint64_t t0 = Bench::Now();
+    for (const Handle<Body> &handle : handles) {
+        Body *body = handle.Get();
+        if (body != nullptr)
+            sum += body->position[0];
+    }
+    uint64_t t = Bench::Now() - t0;
+
+    volatile float sink = sum;
+    (void)sink;
+    return t;
+}
+
+static uint64_t
+RunHashed(uint32_t ops, Pattern pattern)
+{
+    std::vector<uint32_t> live, dead, order;
+    Churn(ops, live, dead, order);
+
+    Bench::HashedIds ids(Memory::GetAllocator<MallocAllocator>());
+    std::vector<PlainBody> bodies;
+    bodies.reserve(ops * 2);
+    for (uint32_t i = 0; i < ops * 2; ++i) {
+        bodies.push_back(PlainBody{ i, { }, { }, { } });
+        ids.Insert(i);
+    }
+    for (uint32_t i : dead) {
+        uint32_t index = ids.Find(i);
+        ids.Remove(index);
+        bodies[index] = bodies.back();
+        bodies.pop_back();
+    }
+
+    std::vector<uint32_t> handles(ops);
+    for (uint32_t i = 0; i < ops; ++i)
+        handles[i] = Stale == pattern ? dead[i] : live[Scattered == pattern ? order[i] : i];
+
+    float sum = 0.0f;
+    uint64_t t0 = Bench::Now();
+    for (uint32_t id : handles) {
+        uint32_t index = ids.Find(id);
+        if (index != 0xffffffff)
+            sum += bodies[index].position[0];
+    }
+    uint64_t t = Bench::Now() - t0;
+
+    volatile float sink = sum;
+    (void)sink;
+    return t;
+}
+
+// Recycles one slot past its last generation, stale ids must never resolve, free slot or not.
+static bool
+CheckStaleIds(BasePool::Storage storage)
+{
+    Pool<Body> pool(Memory::GetAllocator<MallocAllocator>(), storage);
+    Handle<Body> keep = pool.NewInstance();
+
+    std::vector<uint32_t> stale;
+    for (uint32_t i = 0; i < 3000; ++i) {
+        Handle<Body> handle = pool.NewInstance();
+        uint32_t id = handle->GetInstanceID();
+        if (std::find(stale.begin(), stale.end(), id) != stale.end())
+            return false;
+
+        pool.DeleteInstance(handle);
+        stale.push_back(id);
+        if (pool.Get(stale.front()) != nullptr || pool.Get(id) != nullptr)
+            return false;
+    }
+    for (uint32_t id : stale) {
+        if (pool.Get(id) != nullptr)
+            return false;
+    }
+    return keep.Get() != nullptr;
+}
+
+int
+main(int argc, char **argv)
+{
+    Bench::Options options;
+    options.Parse(argc, argv);
+
+    Memory::InitializeMemory();
+    Memory::InitAllocator<MallocAllocator>();
+
+    if (!CheckStaleIds(BasePool::Contiguous) || !CheckStaleIds(BasePool::Chunked)) {
+        fprintf(stderr, "stale ids resolve after their slot was recycled\n");
+        return 1;
+    }
+
+    static const char *subjectNames[] = { "generational", "chunked", "hashed" };
+    static const char *patternNames[] = { "iterate", "scattered", "stale" };
+
+    uint32_t timerNs = Bench::MeasureTimerOverhead();
+    Bench::PrintHeader(options);
+
+    for (uint32_t pattern = Iterate; pattern <= Stale; ++pattern) {
+        for (uint32_t subject = 0; subject < 3; ++subject) {
+            if (!options.Match(subjectNames[subject], patternNames[pattern]))
+                continue;
+
+            // One sample per pass, latencies are whole passes over the handles.
+            Bench::Samples samples;
+            uint64_t best = ~0ull;
+            for (uint32_t i = 0; i < options.repeat; ++i) {
+                uint64_t t;
+                if (subject < 2)
+                    t = RunPool(options.ops, Pattern(pattern), 0 == subject ? BasePool::Contiguous : BasePool::Chunked);
+                else
+                    t = RunHashed(options.ops, Pattern(pattern));
+                samples.Add(t);
+                best = t < best ? t : best;
+            }
+
+            Bench::Report(options, "handles", subjectNames[subject], patternNames[pattern], options.ops, best, samples, timerNs);
+        }
+    }
+
+    Memory::ShutdownMemory();
+    return 0;
+}
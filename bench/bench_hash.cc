@@ -0,0 +1,179 @@
+#include <vector>
+#include "Core/Memory/Memory.h"
+#include "Core/Memory/MallocAllocator.h"
+#include "Core/Collections/Hash.h"
+#include "ChainedHash.h"
+#include "Bench.h"
+
+// Compares Hash<T> with the chained implementation it replaced:
+//   bench_hash [--csv] [--ops N] [--repeat N] [--filter name]
+// --ops is the number of items in the table.
+
+using namespace Framework;
+
+struct Item {
+    uint32_t key;
+    uint32_t value[3];
+};
+
+enum KeyKind {
+    RandomKeys,     // already hashed, like StringHash
+    SequentialKeys  // ids
+};
+
+static std::vector<uint32_t>
+MakeKeys(uint32_t count, KeyKind kind, uint64_t seed)
+{
+    Bench::Random rnd(seed);
+    std::vector<uint32_t> keys(count);
+    for (uint32_t i = 0; i < count; ++i)
+        keys[i] = RandomKeys == kind ? uint32_t(rnd.Next()) : i;
+    return keys;
+}
+
+#define TIMED(_samples, _op) \
+    do { \
+        if (nullptr == _samples) { _op; } \
+        else { uint64_t t0 = Bench::Now(); _op; _samples->Add(Bench::Now() - t0); } \
+    } while (0)
+
+// Each run sets its table up untimed and returns the ns spent in the measured loop.
+template <typename H>
+static uint64_t
+RunInsert(const std::vector<uint32_t> &keys, Bench::Samples *samples)
+{
+    H hash(Memory::GetAllocator<MallocAllocator>());
+
+    uint64_t t0 = Bench::Now();
+    for (uint32_t key : keys)
+        TIMED(samples, hash.Add(key, Item{ key }));
+    return Bench::Now() - t0;
+}
+
+template <typename H>
+static uint64_t
+RunLookup(const std::vector<uint32_t> &keys, const std::vector<uint32_t> &lookups, Bench::Samples *samples)
+{
+    H hash(Memory::GetAllocator<MallocAllocator>());
+    for (uint32_t key : keys)
+        hash.Add(key, Item{ key });
+
+    uint32_t found = 0;
+    uint64_t t0 = Bench::Now();
+    for (uint32_t key : lookups)
+        TIMED(samples, found += (hash.Get(key) != nullptr));
+    uint64_t t = Bench::Now() - t0;
+
+    volatile uint32_t sink = found;
+    (void)sink;
+    return t;
+}
+
+template <typename H>
+static uint64_t
+RunMultimap(const std::vector<uint32_t> &keys, Bench::Samples *samples)
+{
+    // Few keys with many items each, walked with Get/Next.
+    H hash(Memory::GetAllocator<MallocAllocator>());
+    for (uint32_t i = 0, count = uint32_t(keys.size()); i < count; ++i)
+        hash.Add(keys[i] & 0xff, Item{ keys[i] });
+
+    uint64_t sum = 0;
+    uint64_t t0 = Bench::Now();
+    for (uint32_t key = 0; key < 256; ++key)
+        TIMED(samples, for (Item *item = hash.Get(key); item != nullptr; item = hash.Next(item)) sum += item->key);
+    uint64_t t = Bench::Now() - t0;
+
+    volatile uint64_t sink = sum;
+    (void)sink;
+    return t;
+}
+
+template <typename H>
+static uint64_t
+RunChurn(const std::vector<uint32_t> &keys, Bench::Samples *samples)
+{
+    // Table stays at half the keys, each op removes the oldest one and adds a new one.
+    H hash(Memory::GetAllocator<MallocAllocator>());
+    uint32_t count = uint32_t(keys.size()), half = count / 2;
+    for (uint32_t i = 0; i < half; ++i)
+        hash.Add(keys[i], Item{ keys[i] });
+
+    uint64_t t0 = Bench::Now();
+    for (uint32_t i = half; i < count; ++i) {
+        TIMED(samples, {
+            hash.Remove(hash.Get(keys[i - half]));
+            hash.Add(keys[i], Item{ keys[i] });
+        });
+    }
+    return Bench::Now() - t0;
+}
+
+template <typename F>
+static void
+Measure(const Bench::Options &options, uint32_t timerNs, const char *subject, const char *pattern, uint64_t ops, F run)
+{
+    if (!options.Match(subject, pattern))
+        return;
+
+    uint64_t best = ~0ull;
+    for (uint32_t i = 0; i < options.repeat; ++i) {
+        uint64_t t = run(nullptr);
+        best = t < best ? t : best;
+    }
+
+    Bench::Samples samples;
+    samples.Reserve(size_t(ops));
+    run(&samples);
+
+    Bench::Report(options, "hash", subject, pattern, ops, best, samples, timerNs);
+}
+
+template <typename H>
+static void
+RunAll(const Bench::Options &options, uint32_t timerNs, const char *subject)
+{
+    static const char *kindNames[] = { "random", "sequential" };
+
+    char pattern[64];
+    for (uint32_t kind = RandomKeys; kind <= SequentialKeys; ++kind) {
+        std::vector<uint32_t> keys = MakeKeys(options.ops, KeyKind(kind), 1),
+                              misses = MakeKeys(options.ops, RandomKeys, 2);
+        for (uint32_t &key : misses)
+            key |= 0x80000000; // sequential keys never get there, random ones rarely do
+
+        snprintf(pattern, sizeof(pattern), "insert_%s", kindNames[kind]);
+        Measure(options, timerNs, subject, pattern, options.ops, [&](Bench::Samples *s) { return RunInsert<H>(keys, s); });
+
+        snprintf(pattern, sizeof(pattern), "hit_%s", kindNames[kind]);
+        Measure(options, timerNs, subject, pattern, options.ops, [&](Bench::Samples *s) { return RunLookup<H>(keys, keys, s); });
+
+        snprintf(pattern, sizeof(pattern), "miss_%s", kindNames[kind]);
+        Measure(options, timerNs, subject, pattern, options.ops, [&](Bench::Samples *s) { return RunLookup<H>(keys, misses, s); });
+
+        snprintf(pattern, sizeof(pattern), "churn_%s", kindNames[kind]);
+        Measure(options, timerNs, subject, pattern, options.ops - options.ops / 2, [&](Bench::Samples *s) { return RunChurn<H>(keys, s); });
+    }
+
+    std::vector<uint32_t> keys = MakeKeys(options.ops, RandomKeys, 3);
+    Measure(options, timerNs, subject, "multimap", 256, [&](Bench::Samples *s) { return RunMultimap<H>(keys, s); });
+}
+
+int
+main(int argc, char **argv)
+{
+    Bench::Options options;
+    options.Parse(argc, argv);
+
+    Memory::InitializeMemory();
+    Memory::InitAllocator<MallocAllocator>();
+
+    uint32_t timerNs = Bench::MeasureTimerOverhead();
+    Bench::PrintHeader(options);
+
+    RunAll<Hash<Item>>(options, timerNs, "Hash");
+    RunAll<Bench::ChainedHash<Item>>(options, timerNs, "Chained");
+
+    Memory::ShutdownMemory();
+    return 0;
+}
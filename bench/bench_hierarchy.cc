@@ -0,0 +1,137 @@
+#include <vector>
+#include "Core/Memory/Memory.h"
+#include "Core/Memory/MallocAllocator.h"
+#include "Core/Memory/ScratchAllocator.h"
+#include "Core/SmartPtr.h"
+#include "Managers/TransformsManager.h"
+#include "Math/Quaternion.h"
+#include "Math/Vector3.h"
+#include "Bench.h"
+
+// Compares hierarchy edits in TransformsManager applied one at a time with the same edits
+// queued between BeginEdit and EndEdit:
+//   bench_hierarchy [--csv] [--repeat N] [--filter name]
+// Scenes are objects of kObjectSize transforms, a root and its children, at 10k, 100k and 1M.
+// Each edit spawns a kEditSize prefab under an object in the middle of the scene, or moves
+// kEditSize children to other objects, --ops is ignored. Single edits aren't run at 1M.
+
+using namespace Framework;
+
+static const uint32_t kObjectSize = 64;
+static const uint32_t kEditSize = 1000;
+
+enum Pattern {
+    Spawn,   // a prefab, its root under an object and the rest a random tree below it
+    Reparent // object children moved to random objects
+};
+
+enum Subject {
+    SingleSubject,
+    BatchedSubject
+};
+
+static void
+Build(uint32_t count, std::vector<uint32_t> &ids, TransformsManager &manager)
+{
+    manager.BeginEdit();
+    ids.resize(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t parent = 0 == (i % kObjectSize) ? TransformsManager::kParentNull : ids[i - (i % kObjectSize)];
+        ids[i] = manager.RegisterTransform(nullptr, Math::Vector3::Zero, Math::Quaternion::Identity, Math::Vector3::One, parent);
+    }
+    manager.EndEdit();
+    manager.OnRender();
+}
+
+static uint64_t
+Run(Pattern pattern, Subject subject, Bench::Random &rnd, const std::vector<uint32_t> &ids, TransformsManager &manager)
+{
+    uint32_t objects = uint32_t(ids.size()) / kObjectSize;
+    std::vector<uint32_t> edited(kEditSize), parents(kEditSize);
+    for (uint32_t i = 0; i < kEditSize; ++i) {
+        if (Spawn == pattern) {
+            parents[i] = 0 == i ? ids[(objects / 2) * kObjectSize] : rnd.Range(0, i - 1);
+        } else {
+            edited[i] = ids[rnd.Range(0, objects - 1) * kObjectSize + rnd.Range(1, kObjectSize - 1)];
+            parents[i] = ids[rnd.Range(0, objects - 1) * kObjectSize];
+        }
+    }
+
+    uint64_t t0 = Bench::Now();
+    if (BatchedSubject == subject)
+        manager.BeginEdit();
+
+    for (uint32_t i = 0; i < kEditSize; ++i) {
+        if (Spawn == pattern) {
+            uint32_t parent = 0 == i ? parents[i] : edited[parents[i]];
+            edited[i] = manager.RegisterTransform(nullptr, Math::Vector3::Zero, Math::Quaternion::Identity, Math::Vector3::One, parent);
+        } else {
+            manager.SetParent(edited[i], parents[i]);
+        }
+    }
+
+    if (BatchedSubject == subject)
+        manager.EndEdit();
+    uint64_t t = Bench::Now() - t0;
+
+    if (Spawn == pattern) {
+        manager.BeginEdit();
+        for (uint32_t id : edited)
+            manager.UnregisterTransform(nullptr, id);
+        manager.EndEdit();
+    }
+    manager.OnRender();
+
+    return t;
+}
+
+int
+main(int argc, char **argv)
+{
+    Bench::Options options;
+    options.Parse(argc, argv);
+
+    Memory::InitializeMemory();
+    Memory::InitAllocator<MallocAllocator>();
+    Memory::InitAllocator<ScratchAllocator>(&Memory::GetAllocator<MallocAllocator>(), 4 * 1024 * 1024);
+
+    static const char *subjectNames[] = { "single", "batched" };
+    static const char *patternNames[] = { "spawn", "reparent" };
+    static const uint32_t counts[] = { 10000, 100000, 1000000 };
+
+    uint32_t timerNs = Bench::MeasureTimerOverhead();
+    Bench::PrintHeader(options);
+
+    char pattern[64];
+    for (uint32_t count : counts) {
+        std::vector<uint32_t> ids;
+        SmartPtr<TransformsManager> manager = SmartPtr<TransformsManager>::MakeNew<MallocAllocator>();
+        Build(count, ids, *manager);
+
+        for (uint32_t p = Spawn; p <= Reparent; ++p) {
+            snprintf(pattern, sizeof(pattern), "%s_%u", patternNames[p], count);
+            for (uint32_t subject = SingleSubject; subject <= BatchedSubject; ++subject) {
+                if (!options.Match(subjectNames[subject], pattern) || (SingleSubject == subject && count > 100000))
+                    continue;
+
+                Bench::Random rnd(1);
+                Bench::Samples samples;
+                uint64_t best = ~0ull;
+                for (uint32_t i = 0; i < options.repeat; ++i) {
+                    uint64_t t = Run(Pattern(p), Subject(subject), rnd, ids, *manager);
+                    samples.Add(t);
+                    best = t < best ? t : best;
+                }
+
+                Bench::Report(options, "hierarchy", subjectNames[subject], pattern, kEditSize, best, samples, timerNs);
+            }
+        }
+
+        manager.Reset();
+        RefCounted::GC.Collect();
+    }
+
+    Memory::ShutdownMemory();
+
+    return 0;
+}
@@ -0,0 +1,399 @@
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <unordered_map>
+#include "Core/Memory/Memory.h"
+#include "Core/Memory/MallocAllocator.h"
+#include "Core/Memory/LinearAllocator.h"
+#include "Core/Memory/BlocksAllocator.h"
+#include "Core/Memory/ScratchAllocator.h"
+#include "Core/Memory/ThreadCachingAllocator.h"
+#include "Core/Memory/FrameAllocator.h"
+#include "Core/Memory/TLSFAllocator.h"
+#include "Core/Memory/CompactingAllocator.h"
+#include "Core/BitOps.h"
+#include "Bench.h"
+
+// Runs the same allocation patterns against every allocator and libc:
+//   bench_memory [--csv] [--ops N] [--repeat N] [--filter name] [trace files...]
+// A trace is a text file with one operation per line, ids are arbitrary integers:
+//   a <id> <size> [align]
+//   f <id>
+
+using namespace Framework;
+
+static const uint32_t kMinSize = 16;
+static const uint32_t kMaxSize = 16 * 1024;
+static const uint32_t kBatchSize = 1000;
+
+enum TargetFlags {
+    FreesMemory = 1 << 0, // Free gives memory back, bump allocators are reset between runs instead
+    ThreadSafe  = 1 << 1
+};
+
+struct Target {
+    const char *name;
+    Allocator  *allocator; // nullptr means libc
+    uint32_t   flags;
+    void       (*reset)(Allocator *allocator);
+
+    void* Allocate(size_t size, size_t align)
+    {
+        // libc only honours its default alignment, traces rarely ask for more.
+        return nullptr == allocator ? malloc(size) : allocator->Allocate(size, align);
+    }
+
+    void Free(void *pointer)
+    {
+        if (nullptr == allocator)
+            free(pointer);
+        else
+            allocator->Free(pointer);
+    }
+
+    void Reset()
+    {
+        if (reset != nullptr)
+            reset(allocator);
+    }
+};
+
+struct TraceOp {
+    uint32_t slot;
+    uint32_t size;  // 0 for frees
+    uint32_t align;
+};
+
+struct Trace {
+    const char           *name;
+    std::vector<TraceOp> ops;
+    uint32_t             numSlots;
+};
+
+// Log-uniform sizes, most allocations are small like in the engine.
+static uint32_t
+RandomSize(Bench::Random &rnd, uint32_t min, uint32_t max)
+{
+    uint32_t bits = rnd.Range(FindLastSet(min), FindLastSet(max));
+    uint32_t size = rnd.Range(1u << bits, (2u << bits) - 1);
+    return size < min ? min : (size > max ? max : size);
+}
+
+#define TIMED(_samples, _op) \
+    do { \
+        if (nullptr == _samples) { _op; } \
+        else { uint64_t t0 = Bench::Now(); _op; _samples->Add(Bench::Now() - t0); } \
+    } while (0)
+
+static uint64_t
+RunLIFO(Target &target, uint32_t ops, Bench::Samples *samples)
+{
+    Bench::Random rnd(1);
+    std::vector<void*> ptrs(kBatchSize);
+
+    uint64_t count = 0;
+    while (count < ops) {
+        for (uint32_t i = 0; i < kBatchSize; ++i)
+            TIMED(samples, ptrs[i] = target.Allocate(RandomSize(rnd, kMinSize, 256), 16));
+        for (int32_t i = kBatchSize - 1; i >= 0; --i)
+            TIMED(samples, target.Free(ptrs[i]));
+        count += kBatchSize * 2;
+    }
+    return count;
+}
+
+static uint64_t
+RunFIFO(Target &target, uint32_t ops, Bench::Samples *samples)
+{
+    Bench::Random rnd(2);
+    std::vector<void*> ptrs(kBatchSize);
+
+    uint64_t count = 0;
+    while (count < ops) {
+        for (uint32_t i = 0; i < kBatchSize; ++i)
+            TIMED(samples, ptrs[i] = target.Allocate(RandomSize(rnd, kMinSize, 256), 16));
+        for (uint32_t i = 0; i < kBatchSize; ++i)
+            TIMED(samples, target.Free(ptrs[i]));
+        count += kBatchSize * 2;
+    }
+    return count;
+}
+
+static uint64_t
+RunChurn(Target &target, uint32_t ops, Bench::Samples *samples)
+{
+    static const uint32_t kLiveSet = 4096;
+
+    Bench::Random rnd(3);
+    std::vector<void*> ptrs(kLiveSet);
+    for (uint32_t i = 0; i < kLiveSet; ++i)
+        ptrs[i] = target.Allocate(RandomSize(rnd, kMinSize, kMaxSize), 16);
+
+    uint64_t count = 0;
+    for (; count < ops; count += 2) {
+        uint32_t slot = rnd.Range(0, kLiveSet - 1),
+                 size = RandomSize(rnd, kMinSize, kMaxSize);
+        TIMED(samples, target.Free(ptrs[slot]));
+        TIMED(samples, ptrs[slot] = target.Allocate(size, 16));
+    }
+
+    for (uint32_t i = 0; i < kLiveSet; ++i)
+        target.Free(ptrs[i]);
+    return count;
+}
+
+static uint64_t
+RunSmall(Target &target, uint32_t ops, Bench::Samples *samples)
+{
+    Bench::Random rnd(4);
+    uint32_t numObjects = ops / 2;
+    std::vector<void*> ptrs(numObjects);
+
+    for (uint32_t i = 0; i < numObjects; ++i)
+        TIMED(samples, ptrs[i] = target.Allocate(rnd.Range(8, 64), 8));
+
+    // Free in a shuffled order, objects rarely die in allocation order.
+    for (uint32_t i = numObjects - 1; i > 0; --i)
+        std::swap(ptrs[i], ptrs[rnd.Range(0, i)]);
+    for (uint32_t i = 0; i < numObjects; ++i)
+        TIMED(samples, target.Free(ptrs[i]));
+
+    return uint64_t(numObjects) * 2;
+}
+
+static uint64_t
+RunCrossThread(Target &target, uint32_t ops, Bench::Samples *samples)
+{
+    static const uint32_t kHandOffSize = 256;
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::deque<std::vector<void*>> queue;
+    bool done = false;
+
+    Bench::Samples freeSamples;
+    if (samples != nullptr)
+        freeSamples.Reserve(ops / 2);
+
+    std::thread consumer([&]() {
+        Bench::Samples *s = nullptr == samples ? nullptr : &freeSamples;
+        for (;;) {
+            std::vector<void*> batch;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cond.wait(lock, [&]() { return done || !queue.empty(); });
+                if (queue.empty())
+                    break;
+                batch.swap(queue.front());
+                queue.pop_front();
+            }
+            for (size_t i = 0; i < batch.size(); ++i)
+                TIMED(s, target.Free(batch[i]));
+        }
+    });
+
+    Bench::Random rnd(5);
+    uint64_t count = 0;
+    while (count < ops) {
+        std::vector<void*> batch(kHandOffSize);
+        for (uint32_t i = 0; i < kHandOffSize; ++i)
+            TIMED(samples, batch[i] = target.Allocate(RandomSize(rnd, kMinSize, 1024), 16));
+        count += kHandOffSize * 2;
+
+        std::lock_guard<std::mutex> guard(mutex);
+        queue.push_back(std::move(batch));
+        cond.notify_one();
+    }
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        done = true;
+        cond.notify_one();
+    }
+    consumer.join();
+
+    if (samples != nullptr)
+        samples->Append(freeSamples);
+    return count;
+}
+
+static uint64_t
+RunTrace(Target &target, const Trace &trace, Bench::Samples *samples)
+{
+    std::vector<void*> slots(trace.numSlots, nullptr);
+    for (size_t i = 0; i < trace.ops.size(); ++i) {
+        const TraceOp &op = trace.ops[i];
+        if (op.size > 0) {
+            TIMED(samples, slots[op.slot] = target.Allocate(op.size, op.align));
+        } else {
+            TIMED(samples, target.Free(slots[op.slot]));
+            slots[op.slot] = nullptr;
+        }
+    }
+
+    // Whatever the trace leaked.
+    for (size_t i = 0; i < slots.size(); ++i) {
+        if (slots[i] != nullptr)
+            target.Free(slots[i]);
+    }
+    return trace.ops.size();
+}
+
+static bool
+LoadTrace(const char *filename, Trace &trace)
+{
+    FILE *file = fopen(filename, "r");
+    if (nullptr == file)
+        return false;
+
+    std::unordered_map<uint64_t, uint32_t> ids;
+    std::vector<uint32_t> freeSlots;
+
+    trace.name = filename;
+    trace.numSlots = 0;
+
+    char line[256];
+    while (fgets(line, sizeof(line), file) != nullptr) {
+        char op;
+        unsigned long long id;
+        unsigned int size = 0, align = 16;
+        if (sscanf(line, " %c %llu %u %u", &op, &id, &size, &align) < 2 || '#' == op)
+            continue;
+
+        TraceOp traceOp;
+        if ('a' == op) {
+            if (freeSlots.empty()) {
+                traceOp.slot = trace.numSlots++;
+            } else {
+                traceOp.slot = freeSlots.back();
+                freeSlots.pop_back();
+            }
+            ids[id] = traceOp.slot;
+            traceOp.size = size > 0 ? size : 1;
+            traceOp.align = align > 0 ? align : 1;
+        } else if ('f' == op) {
+            auto it = ids.find(id);
+            if (it == ids.end())
+                continue;
+            traceOp.slot = it->second;
+            traceOp.size = 0;
+            traceOp.align = 0;
+            freeSlots.push_back(it->second);
+            ids.erase(it);
+        } else {
+            continue;
+        }
+        trace.ops.push_back(traceOp);
+    }
+
+    fclose(file);
+    return true;
+}
+
+struct Pattern {
+    const char *name;
+    uint64_t   (*run)(Target &target, uint32_t ops, Bench::Samples *samples);
+    uint32_t   requiredFlags;
+};
+
+template <typename F>
+static void
+Measure(const Bench::Options &options, uint32_t timerNs, Target &target, const char *pattern, F run)
+{
+    // Best of the untimed runs gives ns/op, one more run records per op latencies.
+    uint64_t best = ~0ull, ops = 0;
+    for (uint32_t i = 0; i < options.repeat; ++i) {
+        uint64_t t0 = Bench::Now();
+        ops = run(nullptr);
+        uint64_t t = Bench::Now() - t0;
+        target.Reset();
+        best = t < best ? t : best;
+    }
+
+    Bench::Samples samples;
+    samples.Reserve(size_t(ops));
+    run(&samples);
+    target.Reset();
+
+    Bench::Report(options, "memory", target.name, pattern, ops, best, samples, timerNs);
+}
+
+int
+main(int argc, char **argv)
+{
+    Bench::Options options;
+    int firstTrace = options.Parse(argc, argv);
+
+    std::vector<Trace> traces;
+    for (int i = firstTrace; i < argc; ++i) {
+        Trace trace;
+        if (!LoadTrace(argv[i], trace)) {
+            fprintf(stderr, "cannot read trace %s\n", argv[i]);
+            return 1;
+        }
+        traces.push_back(std::move(trace));
+    }
+
+    Memory::InitializeMemory();
+
+    Memory::InitAllocator<MallocAllocator>();
+    Memory::InitAllocator<LinearAllocator>(&Memory::GetAllocator<MallocAllocator>(), 1024 * 1024 * 1024, 16, LinearAllocator::VirtualBuffer);
+    Memory::InitAllocator<BlocksAllocator>(&Memory::GetAllocator<MallocAllocator>(), 8192);
+    Memory::InitAllocator<ScratchAllocator>(&Memory::GetAllocator<MallocAllocator>(), 4 * 1024 * 1024);
+    Memory::InitAllocator<ThreadCachingAllocator>(&Memory::GetAllocator<MallocAllocator>());
+    Memory::InitAllocator<FrameAllocator>(&Memory::GetAllocator<MallocAllocator>(), 1024 * 1024, 2);
+    Memory::InitAllocator<TLSFAllocator>(&Memory::GetAllocator<MallocAllocator>(), 16 * 1024 * 1024);
+    Memory::InitAllocator<CompactingAllocator>(&Memory::GetAllocator<MallocAllocator>(), 16 * 1024 * 1024, 1024 * 1024);
+
+    Target targets[] = {
+        { "libc",          nullptr,                                        FreesMemory | ThreadSafe, nullptr },
+        { "Malloc",        &Memory::GetAllocator<MallocAllocator>(),        FreesMemory | ThreadSafe, nullptr },
+        { "TLSF",          &Memory::GetAllocator<TLSFAllocator>(),          FreesMemory | ThreadSafe, nullptr },
+        { "ThreadCaching", &Memory::GetAllocator<ThreadCachingAllocator>(), FreesMemory | ThreadSafe, nullptr },
+        { "Compacting",    &Memory::GetAllocator<CompactingAllocator>(),    FreesMemory | ThreadSafe,
+            [](Allocator *a) { static_cast<CompactingAllocator*>(a)->NewFrame(); } },
+        { "Blocks",        &Memory::GetAllocator<BlocksAllocator>(),        FreesMemory, nullptr },
+        { "Scratch",       &Memory::GetAllocator<ScratchAllocator>(),       FreesMemory, nullptr },
+        { "Linear",        &Memory::GetAllocator<LinearAllocator>(),        0,
+            [](Allocator *a) { static_cast<LinearAllocator*>(a)->Reset(true); } },
+        { "Frame",         &Memory::GetAllocator<FrameAllocator>(),         0,
+            [](Allocator *a) { static_cast<FrameAllocator*>(a)->NextFrame(); static_cast<FrameAllocator*>(a)->NextFrame(); } }
+    };
+
+    Pattern patterns[] = {
+        { "lifo",   RunLIFO,        0 },
+        { "fifo",   RunFIFO,        0 },
+        { "churn",  RunChurn,       FreesMemory },
+        { "small",  RunSmall,       0 },
+        { "xthread", RunCrossThread, FreesMemory | ThreadSafe }
+    };
+
+    uint32_t timerNs = Bench::MeasureTimerOverhead();
+    Bench::PrintHeader(options);
+
+    for (Target &target : targets) {
+        for (Pattern &pattern : patterns) {
+            if ((target.flags & pattern.requiredFlags) != pattern.requiredFlags || !options.Match(target.name, pattern.name))
+                continue;
+
+            Measure(options, timerNs, target, pattern.name, [&](Bench::Samples *samples) {
+                return pattern.run(target, options.ops, samples);
+            });
+        }
+
+        if (0 == (target.flags & FreesMemory))
+            continue;
+
+        for (const Trace &trace : traces) {
+            if (!options.Match(target.name, trace.name))
+                continue;
+
+            Measure(options, timerNs, target, trace.name, [&](Bench::Samples *samples) {
+                return RunTrace(target, trace, samples);
+            });
+        }
+    }
+
+    Memory::ShutdownMemory();
+    return 0;
+}
@@ -0,0 +1,103 @@
+#include <vector>
+#include "Render/KeyCodeSort.h"
+#include "Bench.h"
+
+// Compares the render key sorts:
+//   bench_sort [--csv] [--repeat N] [--filter name]
+// Each pattern is run at 1k, 10k and 100k commands, --ops is ignored.
+
+using namespace Framework;
+
+enum KeyKind {
+    RandomKeys,  // every byte random
+    FrameKeys    // few cameras and layers, draw calls over a handful of shaders and materials
+};
+
+static std::vector<RHI::KeyCode>
+MakeKeys(uint32_t count, KeyKind kind, uint64_t seed)
+{
+    Bench::Random rnd(seed);
+    std::vector<RHI::KeyCode> keys(count);
+    for (RHI::KeyCode &key : keys) {
+        memset(key.bytes, 0, sizeof(key.bytes));
+        if (RandomKeys == kind) {
+            for (uint32_t i = 0; i < RHI::kKeyCodeSortBytes; ++i)
+                key.bytes[i] = uint8_t(rnd.Next());
+        } else {
+            key.bytes[0] = uint8_t(rnd.Range(0, 2));
+            key.bytes[1] = uint8_t(0x08 | rnd.Range(0, 1));
+            key.bytes[2] = uint8_t(rnd.Range(0, 15));
+            key.bytes[3] = uint8_t(rnd.Range(0, 63));
+            uint32_t depth = uint32_t(rnd.Next());
+            memcpy(key.bytes + 4, &depth, 4);
+        }
+    }
+    return keys;
+}
+
+enum Subject {
+    ComparisonSubject,
+    RadixSubject,
+    ParallelRadixSubject
+};
+
+static uint64_t
+Run(Subject subject, const std::vector<RHI::KeyCode> &source, std::vector<RHI::KeyCode> &keys, std::vector<RHI::KeyCode> &scratch)
+{
+    keys = source;
+    uint32_t count = uint32_t(keys.size());
+
+    uint64_t t0 = Bench::Now();
+    switch (subject) {
+        case ComparisonSubject:
+            RHI::ComparisonSort(keys.data(), count);
+            break;
+        case RadixSubject:
+            RHI::RadixSort(keys.data(), scratch.data(), count);
+            break;
+        case ParallelRadixSubject:
+            RHI::RadixSort(keys.data(), scratch.data(), count, 4);
+            break;
+    }
+    return Bench::Now() - t0;
+}
+
+int
+main(int argc, char **argv)
+{
+    Bench::Options options;
+    options.Parse(argc, argv);
+
+    static const char *subjectNames[] = { "comparison", "radix", "radix_mt4" };
+    static const char *kindNames[] = { "random", "frame" };
+    static const uint32_t counts[] = { 1000, 10000, 100000 };
+
+    uint32_t timerNs = Bench::MeasureTimerOverhead();
+    Bench::PrintHeader(options);
+
+    char pattern[64];
+    for (uint32_t kind = RandomKeys; kind <= FrameKeys; ++kind) {
+        for (uint32_t count : counts) {
+            std::vector<RHI::KeyCode> source = MakeKeys(count, KeyKind(kind), 1), keys, scratch(count);
+            snprintf(pattern, sizeof(pattern), "%s_%u", kindNames[kind], count);
+
+            for (uint32_t subject = ComparisonSubject; subject <= ParallelRadixSubject; ++subject) {
+                if (!options.Match(subjectNames[subject], pattern))
+                    continue;
+
+                // One sample per sort, latencies are whole sorts.
+                Bench::Samples samples;
+                uint64_t best = ~0ull;
+                for (uint32_t i = 0; i < options.repeat; ++i) {
+                    uint64_t t = Run(Subject(subject), source, keys, scratch);
+                    samples.Add(t);
+                    best = t < best ? t : best;
+                }
+
+                Bench::Report(options, "sort", subjectNames[subject], pattern, count, best, samples, timerNs);
+            }
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,291 @@
+#include <vector>
+#include "Core/Memory/Memory.h"
+#include "Core/Memory/MallocAllocator.h"
+#include "Core/SmartPtr.h"
+#include "Managers/TransformsManager.h"
+#include "Math/Affine.h"
+#include "Math/Matrix.h"
+#include "Math/Quaternion.h"
+#include "Math/AxisAngle.h"
+#include "Math/Vector3.h"
+#include "Math/Vector4.h"
+#include "Bench.h"
+
+// Compares the update of a fully dirty hierarchy in TransformsManager, which composes the locals
+// from position, rotation and scale, serial and on 4 threads, with the previous layouts keeping
+// 3x4 local rows, updated through 4x4 matrix temporaries or the affine kernels:
+//   bench_transforms [--csv] [--repeat N] [--filter name]
+// Each pattern is run at 10k, 100k and 1M transforms, --ops is ignored. The moving patterns
+// time only the manager, setting the position of 1% of the transforms and updating, per frame.
+// Bytes per transform of each layout are written to stderr.
+
+using namespace Framework;
+
+enum Shape {
+    Flat,  // a single root, everything else is its child
+    Deep,  // chains of kChainLength transforms, one child per level
+    Moving // objects of kChainLength transforms, a root and its children, kMovingPercent of the transforms set every frame
+};
+
+static const uint32_t kChainLength = 64;
+static const uint32_t kMovingPercent = 1;
+
+// TransformsManager entries before the local TRS arrays, ids are the indices.
+struct Entry {
+    uint32_t id;
+    uint32_t parent;
+    uint32_t descendantsCount;
+    uint32_t flags;
+    Math::Vector4 local[3];
+    Math::Vector4 world[3];
+};
+
+static const uint32_t kFlagsDirty      = 1 << 0;
+static const uint32_t kFlagsHasChanged = 1 << 1;
+
+static void
+MakeLocal(Bench::Random &rnd, Math::Vector3 &position, Math::Quaternion &rotation)
+{
+    Math::Vector3 axis(1.0f, float(rnd.Range(0, 100)) * 0.01f, 0.5f);
+    position = Math::Vector3(float(rnd.Range(0, 200)) * 0.01f - 1.0f,
+                             float(rnd.Range(0, 200)) * 0.01f - 1.0f,
+                             float(rnd.Range(0, 200)) * 0.01f - 1.0f);
+    rotation = Math::AxisAngle(axis.GetNormalized(), float(rnd.Range(0, 628)) * 0.01f);
+}
+
+static uint32_t
+ParentOf(Shape shape, uint32_t i)
+{
+    if (Flat == shape)
+        return 0 == i ? TransformsManager::kParentNull : 0;
+    if (Moving == shape)
+        return 0 == (i % kChainLength) ? TransformsManager::kParentNull : i - (i % kChainLength);
+    return 0 == (i % kChainLength) ? TransformsManager::kParentNull : i - 1;
+}
+
+// Fills dirty with the transforms set before each update, the roots or the moving ones.
+static void
+Build(Shape shape, uint32_t count, std::vector<Entry> &entries, std::vector<uint32_t> &dirty, TransformsManager &manager)
+{
+    Bench::Random rnd(1);
+
+    entries.resize(count);
+    dirty.clear();
+    for (uint32_t i = 0; i < count; ++i) {
+        Math::Vector3 position;
+        Math::Quaternion rotation;
+        MakeLocal(rnd, position, rotation);
+        Math::Matrix local(position, rotation, Math::Vector3::One);
+
+        Entry &entry = entries[i];
+        entry.id = i;
+        entry.parent = ParentOf(shape, i);
+        entry.descendantsCount = 0;
+        entry.flags = kFlagsDirty;
+        entry.local[0] = Math::Vector4(local[ 0], local[ 4], local[ 8], local[12]);
+        entry.local[1] = Math::Vector4(local[ 1], local[ 5], local[ 9], local[13]);
+        entry.local[2] = Math::Vector4(local[ 2], local[ 6], local[10], local[14]);
+
+        for (uint32_t p = entry.parent; p != TransformsManager::kParentNull; p = entries[p].parent)
+            ++entries[p].descendantsCount;
+
+        uint32_t id = manager.RegisterTransform(nullptr, position, rotation, Math::Vector3::One, entry.parent);
+        if (Moving != shape && TransformsManager::kParentNull == entry.parent)
+            dirty.push_back(id);
+    }
+
+    if (Moving == shape) {
+        for (uint32_t i = 0; i < count * kMovingPercent / 100; ++i)
+            dirty.push_back(rnd.Range(0, count - 1));
+    }
+}
+
+static Math::Matrix
+ToMatrix(const Math::Vector4 *rows)
+{
+    Math::Matrix m;
+    m.GetColumn(0) = rows[0];
+    m.GetColumn(1) = rows[1];
+    m.GetColumn(2) = rows[2];
+    m.GetColumn(3) = Math::Vector4(0.0f, 0.0f, 0.0f, 1.0f);
+    m.Transpose();
+    return m;
+}
+
+// Position, rotation & scale plus the matrices Transform used to cache next to the rows above.
+static const uint32_t kComponentCacheBytes = sizeof(Math::Vector3) * 4 + sizeof(Math::Quaternion) * 2 + sizeof(Math::Matrix) * 2;
+
+// TransformsManager::UpdateTransforms before the affine kernels.
+static Entry*
+UpdateMatrix(std::vector<Entry> &entries, Entry *startTransform)
+{
+    uint32_t lastParentId = startTransform->id;
+    Math::Matrix lastParentWorld, world;
+
+    if (TransformsManager::kParentNull == startTransform->parent) {
+        startTransform->world[0] = startTransform->local[0];
+        startTransform->world[1] = startTransform->local[1];
+        startTransform->world[2] = startTransform->local[2];
+        lastParentWorld = ToMatrix(startTransform->world);
+    } else {
+        lastParentWorld = ToMatrix(startTransform->local).FastMultiply(ToMatrix(entries[startTransform->parent].world));
+        startTransform->world[0] = Math::Vector4(lastParentWorld[ 0], lastParentWorld[ 4], lastParentWorld[ 8], lastParentWorld[12]);
+        startTransform->world[1] = Math::Vector4(lastParentWorld[ 1], lastParentWorld[ 5], lastParentWorld[ 9], lastParentWorld[13]);
+        startTransform->world[2] = Math::Vector4(lastParentWorld[ 2], lastParentWorld[ 6], lastParentWorld[10], lastParentWorld[14]);
+    }
+    startTransform->flags = kFlagsHasChanged;
+
+    Entry *entry = startTransform + 1, *end = startTransform + startTransform->descendantsCount + 1;
+    for (; entry < end; ++entry) {
+        if (entry->parent != lastParentId) {
+            lastParentWorld = ToMatrix(entries[entry->parent].world);
+            lastParentId = entry->parent;
+        }
+
+        world = ToMatrix(entry->local).FastMultiply(lastParentWorld);
+
+        entry->world[0] = Math::Vector4(world[ 0], world[ 4], world[ 8], world[12]);
+        entry->world[1] = Math::Vector4(world[ 1], world[ 5], world[ 9], world[13]);
+        entry->world[2] = Math::Vector4(world[ 2], world[ 6], world[10], world[14]);
+        entry->flags = kFlagsHasChanged;
+    }
+
+    return entry;
+}
+
+// TransformsManager::UpdateRange before the local TRS arrays.
+static void
+UpdateRows(std::vector<Entry> &entries)
+{
+    Entry *entry = entries.data(), *end = entries.data() + entries.size();
+    while (entry < end) {
+        if (TransformsManager::kParentNull == entry->parent) {
+            entry->world[0] = entry->local[0];
+            entry->world[1] = entry->local[1];
+            entry->world[2] = entry->local[2];
+            entry->flags = kFlagsHasChanged;
+            ++entry;
+            continue;
+        }
+
+        Entry *run = entry;
+        do {
+            entry->flags = kFlagsHasChanged;
+            ++entry;
+        } while (entry < end && entry->parent == run->parent);
+
+        Math::AffineMultiplyBatch(entries[run->parent].world, run->local, sizeof(Entry), run->world, sizeof(Entry), entry - run);
+    }
+}
+
+enum Subject {
+    MatrixSubject,
+    RowsSubject,
+    TRSSubject,
+    ParallelTRSSubject
+};
+
+static uint64_t
+Run(Subject subject, Shape shape, std::vector<Entry> &entries, const std::vector<uint32_t> &dirty, TransformsManager &manager)
+{
+    uint64_t t0;
+    if (MatrixSubject == subject) {
+        for (Entry &entry : entries)
+            entry.flags |= kFlagsDirty;
+
+        t0 = Bench::Now();
+        Entry *entry = entries.data(), *end = entries.data() + entries.size();
+        while (entry < end)
+            entry = UpdateMatrix(entries, entry);
+    } else if (RowsSubject == subject) {
+        for (Entry &entry : entries)
+            entry.flags |= kFlagsDirty;
+
+        t0 = Bench::Now();
+        UpdateRows(entries);
+    } else if (Moving == shape) {
+        t0 = Bench::Now();
+        for (uint32_t id : dirty)
+            manager.SetLocalPosition(id, manager.GetLocalPosition(id));
+        manager.OnRender();
+        manager.OnEndFrame();
+    } else {
+        for (uint32_t root : dirty)
+            manager.SetLocalScale(root, Math::Vector3::One);
+
+        t0 = Bench::Now();
+        manager.OnRender();
+        manager.OnEndFrame();
+    }
+    return Bench::Now() - t0;
+}
+
+int
+main(int argc, char **argv)
+{
+    Bench::Options options;
+    options.Parse(argc, argv);
+
+    Memory::InitializeMemory();
+    Memory::InitAllocator<MallocAllocator>();
+
+    char rowsName[32], trsName[32], parallelTRSName[32];
+    snprintf(rowsName, sizeof(rowsName), "rows_%s", Math::kAffineKernelName);
+    snprintf(trsName, sizeof(trsName), "trs_%s", Math::kAffineKernelName);
+    snprintf(parallelTRSName, sizeof(parallelTRSName), "trs_%s_mt4", Math::kAffineKernelName);
+
+    const char *subjectNames[] = { "matrix", rowsName, trsName, parallelTRSName };
+    static const char *shapeNames[] = { "flat", "deep", "moving" };
+    static const uint32_t counts[] = { 10000, 100000, 1000000 };
+
+    uint32_t timerNs = Bench::MeasureTimerOverhead();
+    Bench::PrintHeader(options);
+
+    char pattern[64];
+    for (uint32_t shape = Flat; shape <= Moving; ++shape) {
+        for (uint32_t count : counts) {
+            snprintf(pattern, sizeof(pattern), "%s_%u", shapeNames[shape], count);
+            bool any = false;
+            uint32_t firstSubject = Moving == shape ? TRSSubject : MatrixSubject;
+            for (uint32_t subject = firstSubject; subject <= ParallelTRSSubject; ++subject)
+                any |= options.Match(subjectNames[subject], pattern);
+            if (!any)
+                continue;
+
+            std::vector<Entry> entries;
+            std::vector<uint32_t> dirty;
+            size_t heapBefore = Memory::GetAllocator<MallocAllocator>().GetTotalAllocated();
+            SmartPtr<TransformsManager> manager = SmartPtr<TransformsManager>::MakeNew<MallocAllocator>();
+            Build(Shape(shape), count, entries, dirty, *manager);
+            size_t managerBytes = Memory::GetAllocator<MallocAllocator>().GetTotalAllocated() - heapBefore;
+
+            fprintf(stderr, "%s: rows %u bytes per transform (%u in the manager), trs %.1f (manager heap, with the ids and array slack)\n",
+                pattern, uint32_t(sizeof(Entry) + kComponentCacheBytes), uint32_t(sizeof(Entry)), double(managerBytes) / double(count));
+
+            for (uint32_t subject = firstSubject; subject <= ParallelTRSSubject; ++subject) {
+                if (!options.Match(subjectNames[subject], pattern))
+                    continue;
+
+                manager->SetUpdateThreads(ParallelTRSSubject == subject ? 4 : 1);
+
+                // One sample per update, latencies are whole hierarchies.
+                Bench::Samples samples;
+                uint64_t best = ~0ull;
+                for (uint32_t i = 0; i < options.repeat; ++i) {
+                    uint64_t t = Run(Subject(subject), Shape(shape), entries, dirty, *manager);
+                    samples.Add(t);
+                    best = t < best ? t : best;
+                }
+
+                Bench::Report(options, "transforms", subjectNames[subject], pattern, count, best, samples, timerNs);
+            }
+
+            manager.Reset();
+            RefCounted::GC.Collect();
+        }
+    }
+
+    Memory::ShutdownMemory();
+
+    return 0;
+}
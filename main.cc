@@ -3,6 +3,10 @@
 #include "Core/Memory/LinearAllocator.h"
 #include "Core/Memory/BlocksAllocator.h"
 #include "Core/Memory/ScratchAllocator.h"
+#include "Core/Memory/ThreadCachingAllocator.h"
+#include "Core/Memory/FrameAllocator.h"
+#include "Core/Memory/TLSFAllocator.h"
+#include "Core/Memory/CompactingAllocator.h"
 #include "Core/Application.h"
 
 #include "Managers/GetManager.h"
@@ -21,9 +25,13 @@ int main(int argc, char **argv) {
 	Memory::InitializeMemory();
 
 	Memory::InitAllocator<MallocAllocator>();
-	Memory::InitAllocator<LinearAllocator>(&Memory::GetAllocator<MallocAllocator>(), 1 * 1024 * 1024, 16);
+	Memory::InitAllocator<LinearAllocator>(&Memory::GetAllocator<MallocAllocator>(), 256 * 1024 * 1024, 16, LinearAllocator::VirtualBuffer);
 	Memory::InitAllocator<BlocksAllocator>(&Memory::GetAllocator<MallocAllocator>(), 8192);
     Memory::InitAllocator<ScratchAllocator>(&Memory::GetAllocator<MallocAllocator>(), 512 * 1024);
+    Memory::InitAllocator<ThreadCachingAllocator>(&Memory::GetAllocator<MallocAllocator>());
+    Memory::InitAllocator<FrameAllocator>(&Memory::GetAllocator<MallocAllocator>(), 256 * 1024, 2);
+    Memory::InitAllocator<TLSFAllocator>(&Memory::GetAllocator<MallocAllocator>(), 16 * 1024 * 1024);
+    Memory::InitAllocator<CompactingAllocator>(&Memory::GetAllocator<MallocAllocator>(), 32 * 1024 * 1024, 1024 * 1024);
 
 	{
 		Application app("Test");
@@ -4,6 +4,7 @@
 #include "Game/Entity.h"
 #include "Game/ComponentsList.h"
 #include "Core/Memory/ScratchAllocator.h"
+#include "Core/Collections/InlineArray.h"
 
 namespace Framework {
 
@@ -1,6 +1,6 @@
 #include "Components/Renderer.h"
 #include "Core/Memory/MallocAllocator.h"
-#include "Core/Collections/Array.h"
+#include "Core/Collections/InlineArray.h"
 #include "Core/Collections/List.h"
 #include "Render/Resources/ResourceServer.h"
 #include "Game/Entity.h"
@@ -28,7 +28,7 @@ Renderer::Renderer(Renderer &&other)
 : Component(std::forward<Component>(other)),
   bounds(other.bounds),
   mesh(std::forward<WeakPtr<Mesh>>(other.mesh)),
-  materials(std::forward<Array<WeakPtr<Material>>>(other.materials)),
+  materials(std::forward<InlineArray<WeakPtr<Material>, 4>>(other.materials)),
   sortingOrder(other.sortingOrder)
 { }
 
@@ -4,6 +4,7 @@
 #include "Render/Resources/Mesh.h"
 #include "Render/Resources/Material.h"
 #include "Game/Component.h"
+#include "Core/Collections/InlineArray_type.h"
 
 namespace Framework {
 
@@ -15,7 +16,7 @@ class Renderer : public Component {
 protected:
     Math::Bounds bounds;
     WeakPtr<Mesh> mesh;
-    Array<WeakPtr<Material>> materials;
+    InlineArray<WeakPtr<Material>, 4> materials;
 
 	ListNode<Renderer> octreeNode;
 
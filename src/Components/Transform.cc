@@ -153,59 +153,32 @@ TransformChildren::GetPrevious(const Handle<Transform> &child) const
 }
 
 DefineClassInfo(Framework::Transform, Framework::Component);
-DefineComponent(Framework::Transform, -1000000);
+DefineComponentWithStorage(Framework::Transform, -1000000, Framework::BasePool::Contiguous);
 
 Transform::Transform()
 : manager(GetManager<TransformsManager>()),
   name("Entity"),
-  root(this),
-  localPosition(Math::Vector3::Zero),
-  localRotation(Math::Quaternion::Identity),
-  localScale(Math::Vector3::One),
-  worldPosition(Math::Vector3::Zero),
-  worldRotation(Math::Quaternion::Identity),
-  worldScale(Math::Vector3::One),
-  localToWorld(Math::Matrix::Identity),
-  worldToLocal(Math::Matrix::Identity),
-  updateMatrices(true)
+  root(this)
 {
-    manager->RegisterTransform(this, localToWorld, TransformsManager::kParentNull);
+    manager->RegisterTransform(this, Math::Vector3::Zero, Math::Quaternion::Identity, Math::Vector3::One, TransformsManager::kParentNull);
 }
 
 Transform::Transform(const StringHash &_name)
 : manager(GetManager<TransformsManager>()),
   name(_name),
-  root(this),
-  localPosition(Math::Vector3::Zero),
-  localRotation(Math::Quaternion::Identity),
-  localScale(Math::Vector3::One),
-  worldPosition(Math::Vector3::Zero),
-  worldRotation(Math::Quaternion::Identity),
-  worldScale(Math::Vector3::One),
-  localToWorld(Math::Matrix::Identity),
-  worldToLocal(Math::Matrix::Identity),
-  updateMatrices(true)
+  root(this)
 {
-	manager->RegisterTransform(this, localToWorld, TransformsManager::kParentNull);
+	manager->RegisterTransform(this, Math::Vector3::Zero, Math::Quaternion::Identity, Math::Vector3::One, TransformsManager::kParentNull);
 }
 
 Transform::Transform(const StringHash &_name, const Handle<Transform> &_parent)
 : manager(GetManager<TransformsManager>()),
   name(_name),
-  root(_parent->root),
-  localPosition(Math::Vector3::Zero),
-  localRotation(Math::Quaternion::Identity),
-  localScale(Math::Vector3::One),
-  worldPosition(Math::Vector3::Zero),
-  worldRotation(Math::Quaternion::Identity),
-  worldScale(Math::Vector3::One),
-  localToWorld(Math::Matrix::Identity),
-  worldToLocal(Math::Matrix::Identity),
-  updateMatrices(true)
+  root(_parent->root)
 {
 	parent->children.Insert(this);
 
-	manager->RegisterTransform(this, localToWorld, _parent->id);
+	manager->RegisterTransform(this, Math::Vector3::Zero, Math::Quaternion::Identity, Math::Vector3::One, _parent->id);
 }
 
 Transform::Transform(const Transform &other)
@@ -213,26 +186,15 @@ Transform::Transform(const Transform &other)
   manager(other.manager),
   name(other.name),
   root(other.root),
-  parent(other.parent),
-  localPosition(other.localPosition),
-  localRotation(other.localRotation),
-  localScale(other.localScale),
-  updateMatrices(false)
+  parent(other.parent)
 {
-    if (other.updateMatrices)
-        other.RefreshWorld();
-
-    worldPosition = other.worldPosition;
-    worldRotation = other.worldRotation;
-    worldScale = other.worldScale;
-    localToWorld = other.localToWorld;
-    worldToLocal = other.worldToLocal;
-
     Transform *p = parent;
     if (p != nullptr)
         p->children.Insert(this);
 
-    manager->RegisterTransform(this, localToWorld, nullptr == p ? TransformsManager::kParentNull : p->id);
+    manager->RegisterTransform(this,
+        other.GetLocalPosition(), other.GetLocalRotation(), other.GetLocalScale(),
+        nullptr == p ? TransformsManager::kParentNull : p->id);
 }
 
 Transform::Transform(Transform &&other)
@@ -243,16 +205,7 @@ Transform::Transform(Transform &&other)
   id(other.id),
   root(other.root),
   parent(other.parent),
-  children(std::forward<TransformChildren>(other.children)),
-  localPosition(other.localPosition),
-  localRotation(other.localRotation),
-  localScale(other.localScale),
-  worldPosition(other.worldPosition),
-  worldRotation(other.worldRotation),
-  worldScale(other.worldScale),
-  localToWorld(other.localToWorld),
-  worldToLocal(other.worldToLocal),
-  updateMatrices(other.updateMatrices)
+  children(std::forward<TransformChildren>(other.children))
 { }
 
 Transform::~Transform()
@@ -262,37 +215,6 @@ Transform::~Transform()
 	manager->UnregisterTransform(this, id);
 }
 
-void
-Transform::RefreshWorld() const
-{
-    if (updateMatrices) {
-        localToWorld = manager->GetWorldMatrix(id);
-        worldToLocal = localToWorld.GetFastInverse();
-
-        worldPosition = localToWorld.GetColumn(3);
-        worldRotation = Math::Quaternion::FromMatrix(localToWorld);
-
-        worldScale.x = localToWorld.GetColumn(0).GetMagnitude();
-        worldScale.y = localToWorld.GetColumn(1).GetMagnitude();
-        worldScale.z = localToWorld.GetColumn(2).GetMagnitude();
-
-        updateMatrices = false;
-    }
-}
-
-void
-Transform::RefreshLocal()
-{
-    Math::Matrix local = manager->GetLocalMatrix(id);
-
-    localPosition = local.GetColumn(3);
-    localRotation = Math::Quaternion::FromMatrix(local);
-
-    localScale.x = local.GetColumn(0).GetMagnitude();
-    localScale.y = local.GetColumn(1).GetMagnitude();
-    localScale.z = local.GetColumn(2).GetMagnitude();
-}
-
 void
 Transform::SetName(const StringHash &newName)
 {
@@ -307,14 +229,21 @@ Transform::HasChanged() const
     return manager->HasChanged(id);
 }
 
+uint32_t
+Transform::GetHierarchyIndex() const
+{
+    return manager->GetHierarchyIndex(id);
+}
+
 void
 Transform::SetParent(const Handle<Transform> &newParent, bool keepWorldTransform)
 {
     if (parent == newParent)
         return;
 
+    Math::Matrix world;
     if (keepWorldTransform)
-        this->RefreshWorld();
+        world = manager->GetWorldMatrix(id);
 
     if (parent.IsValid())
         parent->children.Remove(this);
@@ -328,12 +257,7 @@ Transform::SetParent(const Handle<Transform> &newParent, bool keepWorldTransform
 
     manager->SetParent(id, parent.IsValid() ? parent->id : TransformsManager::kParentNull);
     if (keepWorldTransform)
-    {
-        manager->SetWorldMatrix(id, localToWorld);
-        this->RefreshLocal();
-    }
-
-    updateMatrices = true;
+        manager->SetWorldMatrix(id, world);
 }
 
 void
@@ -342,8 +266,9 @@ Transform::AddChild(const Handle<Transform> &newChild, bool keepWorldTransform)
     if (newChild->parent.EqualsTo(this))
         return;
 
+    Math::Matrix world;
     if (keepWorldTransform)
-        newChild->RefreshWorld();
+        world = manager->GetWorldMatrix(newChild->id);
 
     if (newChild->parent.IsValid())
         newChild->parent->children.Remove(this);
@@ -355,133 +280,119 @@ Transform::AddChild(const Handle<Transform> &newChild, bool keepWorldTransform)
 
     manager->SetParent(newChild->id, id);
     if (keepWorldTransform)
-    {
-        manager->SetWorldMatrix(newChild->id, newChild->localToWorld);
-        newChild->RefreshLocal();
-    }
+        manager->SetWorldMatrix(newChild->id, world);
+}
+
+const Math::Vector3&
+Transform::GetLocalPosition() const
+{
+    return manager->GetLocalPosition(id);
+}
 
-    newChild->updateMatrices = true;
+const Math::Quaternion&
+Transform::GetLocalRotation() const
+{
+    return manager->GetLocalRotation(id);
+}
+
+const Math::Vector3&
+Transform::GetLocalScale() const
+{
+    return manager->GetLocalScale(id);
 }
 
 void
 Transform::SetLocalPosition(const Math::Vector3 &p)
 {
-    localPosition = p;
-    manager->SetLocalMatrix(id, Math::Matrix(localPosition, localRotation, localScale));
-    updateMatrices = true;
+    manager->SetLocalPosition(id, p);
 }
 
 void
 Transform::SetLocalRotation(const Math::Quaternion &r)
 {
-    localRotation = r;
-    manager->SetLocalMatrix(id, Math::Matrix(localPosition, localRotation, localScale));
-    updateMatrices = true;
+    manager->SetLocalRotation(id, r);
 }
 
 void
 Transform::SetLocalScale(const Math::Vector3 &s)
 {
-    localScale = s;
-    manager->SetLocalMatrix(id, Math::Matrix(localPosition, localRotation, localScale));
-    updateMatrices = true;
+    manager->SetLocalScale(id, s);
 }
 
-const Math::Vector3&
+Math::Vector3
 Transform::GetWorldPosition() const
 {
-    this->RefreshWorld();
-    return worldPosition;
+    return manager->GetWorldMatrix(id).GetColumn(3);
 }
 
-const Math::Quaternion&
+Math::Quaternion
 Transform::GetWorldRotation() const
 {
-    this->RefreshWorld();
-    return worldRotation;
+    Math::Vector3 position, scale;
+    Math::Quaternion rotation;
+    manager->GetWorldMatrix(id).Decompose(position, rotation, scale);
+    return rotation;
 }
 
-const Math::Vector3&
+Math::Vector3
 Transform::GetWorldScale() const
 {
-    this->RefreshWorld();
-    return worldScale;
+    Math::Vector3 position, scale;
+    Math::Quaternion rotation;
+    manager->GetWorldMatrix(id).Decompose(position, rotation, scale);
+    return scale;
 }
 
 void
 Transform::SetWorldPosition(const Math::Vector3 &p)
 {
-    this->RefreshWorld();
-
-    worldPosition = p;
-
-    Math::Matrix worldMatrix = Math::Matrix(worldPosition, worldRotation, worldScale);
-    manager->SetWorldMatrix(id, worldMatrix);
-
-    localToWorld = worldMatrix;
-    worldToLocal = worldMatrix.GetFastInverse();
-    updateMatrices = false;
-
-    this->RefreshLocal();
+    manager->SetWorldPosition(id, p);
 }
 
 void
 Transform::SetWorldRotation(const Math::Quaternion &r)
 {
-    this->RefreshWorld();
-
-    worldRotation = r;
-
-    Math::Matrix worldMatrix = Math::Matrix(worldPosition, worldRotation, worldScale);
-    manager->SetWorldMatrix(id, worldMatrix);
-
-    localToWorld = worldMatrix;
-    worldToLocal = worldMatrix.GetFastInverse();
-    updateMatrices = false;
+    Math::Vector3 position, scale;
+    Math::Quaternion rotation;
+    manager->GetWorldMatrix(id).Decompose(position, rotation, scale);
 
-    this->RefreshLocal();
+    manager->SetWorldMatrix(id, Math::Matrix(position, r, scale));
 }
 
-const Math::Matrix&
+Math::Matrix
 Transform::GetLocalToWorld() const
 {
-    this->RefreshWorld();
-    return localToWorld;
+    return manager->GetWorldMatrix(id);
 }
 
-const Math::Matrix&
+Math::Matrix
 Transform::GetWorldToLocal() const
 {
-    this->RefreshWorld();
-    return worldToLocal;
+    return manager->GetWorldMatrix(id).GetFastInverse();
 }
 
 Math::Vector3
 Transform::TransformPoint(const Math::Vector3 &p) const
 {
-    this->RefreshWorld();
-    return localToWorld.FastMultiplyPoint(p);
+    return manager->GetWorldMatrix(id).FastMultiplyPoint(p);
 }
 
 Math::Vector3
 Transform::TransformVector(const Math::Vector3 &v) const
 {
-    this->RefreshWorld();
-    return localToWorld.FastMultiplyVector(v);
+    return manager->GetWorldMatrix(id).FastMultiplyVector(v);
 }
 
 Math::Vector3
 Transform::InverseTransformPoint(const Math::Vector3 &p) const
 {
-    this->RefreshWorld();
-    return worldToLocal.FastMultiplyPoint(p);
+    return manager->GetWorldMatrix(id).GetFastInverse().FastMultiplyPoint(p);
 }
 
 Math::Vector3
 Transform::InverseTransformVector(const Math::Vector3 &v) const
 {
-    this->RefreshWorld();
-    return worldToLocal.FastMultiplyVector(v);
+    return manager->GetWorldMatrix(id).GetFastInverse().FastMultiplyVector(v);
 }
 
 void
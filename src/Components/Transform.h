@@ -59,21 +59,6 @@ protected:
     Handle<Transform> root;
     Handle<Transform> parent;
     TransformChildren children;
-
-    Math::Vector3 localPosition;
-    Math::Quaternion localRotation;
-    Math::Vector3 localScale;
-
-    mutable Math::Vector3 worldPosition;
-    mutable Math::Quaternion worldRotation;
-    mutable Math::Vector3 worldScale;
-
-    mutable Math::Matrix localToWorld;
-    mutable Math::Matrix worldToLocal;
-    mutable bool updateMatrices;
-
-    void RefreshWorld() const;
-    void RefreshLocal();
 public:
     Transform();
 	Transform(const StringHash &_name);
@@ -91,7 +76,10 @@ public:
     const TransformChildren& GetChildren() const;
 
     bool HasChanged() const;
+    uint32_t GetHierarchyIndex() const;
 
+    // Locals are kept as position, rotation and scale. A kept world transform, or one set with SetWorldRotation,
+    // loses the shear it would need under a rotated, non-uniformly scaled parent. SetWorldPosition is exact.
     void SetParent(const Handle<Transform> &newParent, bool keepWorldTransform);
     void AddChild(const Handle<Transform> &newChild, bool keepWorldTransform);
 
@@ -103,15 +91,16 @@ public:
     void SetLocalRotation(const Math::Quaternion &r);
     void SetLocalScale(const Math::Vector3 &s);
 
-    const Math::Vector3& GetWorldPosition() const;
-    const Math::Quaternion& GetWorldRotation() const;
-    const Math::Vector3& GetWorldScale() const;
+    // Computed from the world matrix on every call.
+    Math::Vector3 GetWorldPosition() const;
+    Math::Quaternion GetWorldRotation() const;
+    Math::Vector3 GetWorldScale() const;
 
     void SetWorldPosition(const Math::Vector3 &p);
     void SetWorldRotation(const Math::Quaternion &r);
 
-    const Math::Matrix& GetLocalToWorld() const;
-    const Math::Matrix& GetWorldToLocal() const;
+    Math::Matrix GetLocalToWorld() const;
+    Math::Matrix GetWorldToLocal() const;
 
     Math::Vector3 TransformPoint(const Math::Vector3 &p) const;
     Math::Vector3 TransformVector(const Math::Vector3 &v) const;
@@ -159,22 +148,4 @@ Transform::GetChildren() const
 	return children;
 }
 
-inline const Math::Vector3&
-Transform::GetLocalPosition() const
-{
-    return localPosition;
-}
-
-inline const Math::Quaternion&
-Transform::GetLocalRotation() const
-{
-    return localRotation;
-}
-
-inline const Math::Vector3&
-Transform::GetLocalScale() const
-{
-    return localScale;
-}
-
 } // namespace Framework
@@ -5,9 +5,12 @@
 #include "Core/Time/TimeServer.h"
 #include "Core/Memory/MallocAllocator.h"
 #include "Core/Memory/LinearAllocator.h"
+#include "Core/Memory/MemoryStats.h"
 #include "Core/Collections/Array.h"
 
 #include "Managers/ComponentsManager.h"
+#include "Game/ComponentsList.h"
+#include "Components/Transform.h"
 #include "Managers/GetManager.h"
 
 #include <imgui.h>
@@ -139,6 +142,11 @@ Application::Tick()
 
     ImGui::Render();
 	renderQueue->EndFrameCommands();
+
+    for (it = managers.Begin(); it != end; ++it)
+        (*it)->OnEndFrame();
+
+    Memory::NewFrame();
 }
 
 const SmartPtr<BaseManager>&
@@ -235,9 +243,12 @@ void
 Application::DeserializeEntities(const char *filename)
 {
     BitStream stream(Memory::GetAllocator<MallocAllocator>());
-    if (0 == fileServer->ReadOnly(filename, stream))
+    if (0 == fileServer->ReadOnly(filename, stream)) {
         serializationServer->DeserializeEntities(stream);
-    else
+
+        // Loaded transforms end up scattered, put them back in hierarchy order over the next frames.
+        ComponentsList<Transform>::Instance()->ReorderStorage([] (const Transform *t) { return t->GetHierarchyIndex(); }, 1024);
+    } else
         log->Write(Log::Warning, "Cound't open file \"%s\"", filename);
 }
 
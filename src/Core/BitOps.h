@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#   include <intrin.h>
+#endif
+
+namespace Framework {
+
+// Index of the lowest set bit, value must be non zero.
+inline uint32_t CountTrailingZeros(uint32_t value)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, value);
+    return index;
+#else
+    return __builtin_ctz(value);
+#endif
+}
+
+inline uint32_t CountTrailingZeros(uint64_t value)
+{
+#if defined(_MSC_VER) && defined(_WIN64)
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return index;
+#elif defined(_MSC_VER)
+    uint32_t low = uint32_t(value);
+    return 0 == low ? 32 + CountTrailingZeros(uint32_t(value >> 32)) : CountTrailingZeros(low);
+#else
+    return __builtin_ctzll(value);
+#endif
+}
+
+// Index of the highest set bit, value must be non zero.
+inline uint32_t FindLastSet(uint32_t value)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse(&index, value);
+    return index;
+#else
+    return 31 - __builtin_clz(value);
+#endif
+}
+
+inline uint32_t FindLastSet(uint64_t value)
+{
+#if defined(_MSC_VER) && defined(_WIN64)
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return index;
+#elif defined(_MSC_VER)
+    uint32_t high = uint32_t(value >> 32);
+    return 0 == high ? FindLastSet(uint32_t(value)) : 32 + FindLastSet(high);
+#else
+    return 63 - __builtin_clzll(value);
+#endif
+}
+
+} // namespace Framework
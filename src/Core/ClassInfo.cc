@@ -5,6 +5,7 @@
 #include "Core/Collections/List.h"
 #include "Core/Collections/Hash.h"
 #include "Core/Memory/MallocAllocator.h"
+#include "Core/Memory/MemoryStats.h"
 
 namespace Framework {
 
@@ -17,7 +18,8 @@ ClassInfo::ClassInfo(const StringHash &_name, const ClassInfo *_parent, const Cl
   size(_size),
   align(_align),
   ctor(_ctor),
-  staticCtor(nullptr)
+  staticCtor(nullptr),
+  memoryTag(-1)
 {
     assert(name[0]);
     assert(parent != this);
@@ -90,6 +92,19 @@ ClassInfo::GetAlign() const
     return align;
 }
 
+uint32_t
+ClassInfo::GetMemoryTag() const
+{
+    // Registered on first use, class names are static strings. Threads racing here
+    // get the same tag, RegisterTag looks the name up under its lock.
+    int32_t tag = memoryTag.load(std::memory_order_relaxed);
+    if (tag < 0) {
+        tag = int32_t(Memory::RegisterTag(name));
+        memoryTag.store(tag, std::memory_order_relaxed);
+    }
+    return uint32_t(tag);
+}
+
 bool
 ClassInfo::IsDerivedFrom(const ClassInfo *classInfo) const
 {
@@ -114,6 +129,7 @@ ClassInfo::Create(Allocator *allocator) const
     assert(ctor != nullptr);
     assert(this->IsDerivedFrom(&RefCounted::RTTI));
 
+    Memory::TagScope tagScope(this->GetMemoryTag());
     RefCounted *instance = static_cast<RefCounted*>(ctor(allocator->Allocate(size, align)));
     instance->allocator = allocator;
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdio>
+#include <atomic>
 #include "Core/Debug.h"
 #include "Core/Collections/List_type.h"
 #include "Core/Collections/Hash_type.h"
@@ -30,6 +31,7 @@ private:
     size_t          align;
     Ctor            ctor;
     StaticCtor      staticCtor;
+    mutable std::atomic<int32_t> memoryTag;
 
     ListNode<ClassInfo> node;
 public:
@@ -48,6 +50,7 @@ public:
 
     size_t GetSize() const;
     size_t GetAlign() const;
+    uint32_t GetMemoryTag() const;
 
     bool IsDerivedFrom(const ClassInfo *classInfo) const;
 
@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include "Core/Collections/Array_type.h"
+#include "Core/Collections/Sort.h"
 #include "Core/Debug.h"
 #include "Core/Memory/Memory.h"
 #include "Core/Memory/Allocator.h"
@@ -260,6 +261,19 @@ Array<T>::SetCapacity(uint32_t newCapacity)
         return;
     }
     
+    if (capacity > 0 && newCapacity > 0) {
+        // Resize in place when the allocator can, trivially copyable items can also
+        // be moved by the allocator itself.
+        if (std::is_trivially_copyable<T>::value) {
+            data = static_cast<T*>(allocator->Reallocate(data, capacity * sizeof(T), newCapacity * sizeof(T), __alignof(T)));
+            capacity = newCapacity;
+            return;
+        } else if (allocator->TryExpand(data, capacity * sizeof(T), newCapacity * sizeof(T))) {
+            capacity = newCapacity;
+            return;
+        }
+    }
+
     T *newData = nullptr;
     if (newCapacity > 0) {
         newData = static_cast<T*>(allocator->Allocate(newCapacity * sizeof(T), __alignof(T)));
@@ -402,11 +416,19 @@ Array<T>::IndexOf(const T &item)
 
 template <typename T>
 inline void
-Array<T>::Sort(Array<T> &array, uint32_t index, uint32_t count, std::function<bool(const T&, const T&)> f)
+Array<T>::Sort(Array<T> &array, uint32_t index, uint32_t count)
+{
+    Array<T>::Sort(array, index, count, [] (const T &a, const T &b) { return a < b; });
+}
+
+template <typename T>
+template <typename F>
+inline void
+Array<T>::Sort(Array<T> &array, uint32_t index, uint32_t count, F less)
 {
     uint32_t right = index + count;
     assert(index < array.size && right <= array.size);
-    std::sort(array.data + index, array.data + right, f);
+    Sorting::Sort(array.data + index, array.data + right, less);
 }
 
 template <typename T>
@@ -428,36 +450,15 @@ BinarySearch(const Array<T> &array, uint32_t index, uint32_t count, const T &ite
     }
     return -(left + 1); // item not found
 }
-/*
-template <typename T>
-inline int32_t
-BinarySearch(const Array<T> &array, uint32_t index, uint32_t count, const T &item, std::function<int(const T&, const T&)> f)
-{
-    int32_t left = index, right = index + count - 1;
-    assert(left < array.size && right < array.size);
-    while (left <= right) {
-        uint32_t pivot = (left + right) >> 1;
-        int cmp = f(*(array.data + pivot), item);
-
-        if (cmp < 0)
-            left = pivot + 1;
-        else if (cmp > 0)
-            right = pivot - 1;
-        else
-            return pivot; // item found
-    }
-    return -(left + 1); // item not found
-}
-*/
-template <typename T, typename U>
+template <typename T, typename U, typename F>
 inline int32_t
-BinarySearch(const Array<T> &array, uint32_t index, uint32_t count, const U &item, std::function<int(const T&, const U&)> f)
+BinarySearch(const Array<T> &array, uint32_t index, uint32_t count, const U &item, F compare)
 {
     int32_t left = index, right = index + count - 1;
 	assert(left <= (int32_t)array.Count() && right < (int32_t)array.Count());
     while (left <= right) {
         uint32_t pivot = (left + right) >> 1;
-        int cmp = f(array[pivot], item);
+        int cmp = compare(array[pivot], item);
 
         if (cmp < 0)
             left = pivot + 1;
@@ -1,7 +1,6 @@
 #pragma once
 
 #include <cstdint>
-#include <functional>
 
 namespace Framework {
 
@@ -64,16 +63,15 @@ public:
 
     int32_t IndexOf(const T &item);
 
-    static void Sort(Array<T> &array, uint32_t index, uint32_t count, std::function<bool(const T&, const T&)> f);
+    static void Sort(Array<T> &array, uint32_t index, uint32_t count);
+    template <typename F>
+    static void Sort(Array<T> &array, uint32_t index, uint32_t count, F less);
 };
 
 template <typename T>
 static int32_t BinarySearch(const Array<T> &array, uint32_t index, uint32_t count, const T &item);
-/*
-template <typename T>
-static int32_t BinarySearch(const Array<T> &array, uint32_t index, uint32_t count, const T &item, std::function<int(const T&, const T&)> f);
-*/
-template <typename T, typename U>
-static int32_t BinarySearch(const Array<T> &array, uint32_t index, uint32_t count, const U &item, std::function<int(const T&, const U&)> f);
+
+template <typename T, typename U, typename F>
+static int32_t BinarySearch(const Array<T> &array, uint32_t index, uint32_t count, const U &item, F compare);
 
 } // namespace Framework
@@ -0,0 +1,421 @@
+#pragma once
+
+#include <cstring>
+#include "Core/Collections/FlatMap_type.h"
+#include "Core/Collections/Array.h"
+#include "Core/Collections/Hash.h"
+#include "Core/String.h"
+#include "Core/StringHash.h"
+
+namespace Framework {
+
+template <typename K, typename V>
+inline
+KeyValuePair<K, V>::KeyValuePair()
+{ }
+
+template <typename K, typename V>
+inline
+KeyValuePair<K, V>::KeyValuePair(const K &k)
+: key(k)
+{ }
+
+template <typename K, typename V>
+inline
+KeyValuePair<K, V>::KeyValuePair(const K &k, const V &v)
+: key(k),
+  value(v)
+{ }
+
+template <typename K, typename V>
+inline
+KeyValuePair<K, V>::KeyValuePair(const KeyValuePair<K, V> &other)
+: key(other.key),
+  value(other.value)
+{ }
+
+template <typename K, typename V>
+inline
+KeyValuePair<K, V>::KeyValuePair(KeyValuePair<K, V> &&other)
+: key(std::forward<K>(other.key)),
+  value(std::forward<V>(other.value))
+{ }
+
+template <typename K, typename V>
+inline
+KeyValuePair<K, V>::~KeyValuePair()
+{ }
+
+template <typename K, typename V>
+inline KeyValuePair<K, V>&
+KeyValuePair<K, V>::operator =(const KeyValuePair<K, V> &other)
+{
+    key = other.key;
+    value = other.value;
+    return (*this);
+}
+
+template <typename K, typename V>
+inline KeyValuePair<K, V>&
+KeyValuePair<K, V>::operator =(KeyValuePair<K, V> &&other)
+{
+    key = std::forward<K>(other.key);
+    value = std::forward<V>(other.value);
+    return (*this);
+}
+
+template <typename K, typename V>
+inline bool
+KeyValuePair<K, V>::operator <(const KeyValuePair<K, V> &other) const
+{
+    return key < other.key;
+}
+
+template <typename K, typename V>
+inline bool
+KeyValuePair<K, V>::operator >(const KeyValuePair<K, V> &other) const
+{
+    return key > other.key;
+}
+
+template <typename K>
+inline uint32_t
+FlatMapTraits<K>::Hash(const K &key)
+{
+    uint64_t value = static_cast<uint64_t>(key);
+    return uint32_t(value ^ (value >> 32));
+}
+
+template <typename K>
+inline bool
+FlatMapTraits<K>::Equals(const K &a, const K &b)
+{
+    return a == b;
+}
+
+// Strings hash like StringHash, so they can be looked up by String, const char* or StringHash.
+template <>
+struct FlatMapTraits<String> {
+    static uint32_t Hash(const String &key);
+    static uint32_t Hash(const char *key);
+    static uint32_t Hash(const StringHash &key);
+    static bool Equals(const String &a, const String &b);
+    static bool Equals(const String &a, const char *b);
+    static bool Equals(const String &a, const StringHash &b);
+};
+
+inline uint32_t
+FlatMapTraits<String>::Hash(const String &key)
+{
+    return StringHash::Compute(key.AsCString(), key.Length());
+}
+
+inline uint32_t
+FlatMapTraits<String>::Hash(const char *key)
+{
+    return StringHash::Compute(key, uint32_t(strlen(key)));
+}
+
+inline uint32_t
+FlatMapTraits<String>::Hash(const StringHash &key)
+{
+    return key.hash;
+}
+
+inline bool
+FlatMapTraits<String>::Equals(const String &a, const String &b)
+{
+    return a == b;
+}
+
+inline bool
+FlatMapTraits<String>::Equals(const String &a, const char *b)
+{
+    return a == b;
+}
+
+inline bool
+FlatMapTraits<String>::Equals(const String &a, const StringHash &b)
+{
+    // b.string doesn't need to be null terminated, it can point inside a longer string.
+    return a.Length() == b.length && 0 == memcmp(a.AsCString(), b.string, b.length);
+}
+
+template <typename K, typename V, typename Traits>
+template <typename Q>
+inline int32_t
+FlatMap<K, V, Traits>::IndexOf(const Q &key, uint32_t hash) const
+{
+    for (const uint32_t *i = index.Get(hash); i != nullptr; i = index.Next(i)) {
+        if (Traits::Equals(data[*i].key, key))
+            return int32_t(*i);
+    }
+    return -1;
+}
+
+template <typename K, typename V, typename Traits>
+inline void
+FlatMap<K, V, Traits>::RemoveAt(uint32_t i, uint32_t hash)
+{
+    index.Remove(index.Find(hash, [i] (uint32_t j) { return i == j; }));
+
+    uint32_t last = data.Count() - 1;
+    if (i != last) {
+        *index.Find(Traits::Hash(data[last].key), [last] (uint32_t j) { return last == j; }) = i;
+        data[i] = std::move(data[last]);
+    }
+    data.PopBack();
+}
+
+template <typename K, typename V, typename Traits>
+inline
+FlatMap<K, V, Traits>::FlatMap(Allocator &allocator)
+: data(allocator),
+  index(allocator),
+  bulkAdding(false)
+{ }
+
+template <typename K, typename V, typename Traits>
+inline
+FlatMap<K, V, Traits>::FlatMap(Allocator &allocator, uint32_t initialCapacity)
+: data(allocator, initialCapacity),
+  index(allocator, initialCapacity),
+  bulkAdding(false)
+{ }
+
+template <typename K, typename V, typename Traits>
+inline
+FlatMap<K, V, Traits>::FlatMap(const FlatMap<K, V, Traits> &other)
+: data(other.data),
+  index(other.index),
+  bulkAdding(false)
+{
+    assert(!other.bulkAdding);
+}
+
+template <typename K, typename V, typename Traits>
+inline
+FlatMap<K, V, Traits>::FlatMap(FlatMap<K, V, Traits> &&other)
+: data(std::forward<Array<KeyValuePair<K, V>>>(other.data)),
+  index(std::forward<Hash<uint32_t>>(other.index)),
+  bulkAdding(false)
+{
+    assert(!other.bulkAdding);
+}
+
+template <typename K, typename V, typename Traits>
+inline
+FlatMap<K, V, Traits>::~FlatMap()
+{ }
+
+template <typename K, typename V, typename Traits>
+inline FlatMap<K, V, Traits>&
+FlatMap<K, V, Traits>::operator =(const FlatMap<K, V, Traits> &other)
+{
+    assert(!other.bulkAdding);
+    data = other.data;
+    index = other.index;
+    bulkAdding = false;
+    return (*this);
+}
+
+template <typename K, typename V, typename Traits>
+inline FlatMap<K, V, Traits>&
+FlatMap<K, V, Traits>::operator =(FlatMap<K, V, Traits> &&other)
+{
+    assert(!other.bulkAdding);
+    data = std::forward<Array<KeyValuePair<K, V>>>(other.data);
+    index = std::forward<Hash<uint32_t>>(other.index);
+    bulkAdding = false;
+    return (*this);
+}
+
+template <typename K, typename V, typename Traits>
+template <typename Q>
+inline const V&
+FlatMap<K, V, Traits>::operator [](const Q &key) const
+{
+    assert(!bulkAdding);
+    int32_t i = this->IndexOf(key, Traits::Hash(key));
+    assert(i >= 0);
+    return data[i].value;
+}
+
+template <typename K, typename V, typename Traits>
+inline V&
+FlatMap<K, V, Traits>::operator [](const K &key)
+{
+    assert(!bulkAdding);
+    uint32_t hash = Traits::Hash(key);
+    int32_t i = this->IndexOf(key, hash);
+    if (i < 0) {
+        i = data.Count();
+        data.PushBack(KeyValuePair<K, V>(key, V()));
+        index.Add(hash, i);
+    }
+    return data[i].value;
+}
+
+template <typename K, typename V, typename Traits>
+inline Allocator&
+FlatMap<K, V, Traits>::GetAllocator() const
+{
+    return data.GetAllocator();
+}
+
+template <typename K, typename V, typename Traits>
+inline uint32_t
+FlatMap<K, V, Traits>::Count() const
+{
+    return data.Count();
+}
+
+template <typename K, typename V, typename Traits>
+inline bool
+FlatMap<K, V, Traits>::IsEmpty() const
+{
+    return data.IsEmpty();
+}
+
+template <typename K, typename V, typename Traits>
+inline const KeyValuePair<K, V>*
+FlatMap<K, V, Traits>::Begin() const
+{
+    return data.Begin();
+}
+
+template <typename K, typename V, typename Traits>
+inline KeyValuePair<K, V>*
+FlatMap<K, V, Traits>::Begin()
+{
+    return data.Begin();
+}
+
+template <typename K, typename V, typename Traits>
+inline const KeyValuePair<K, V>*
+FlatMap<K, V, Traits>::End() const
+{
+    return data.End();
+}
+
+template <typename K, typename V, typename Traits>
+inline KeyValuePair<K, V>*
+FlatMap<K, V, Traits>::End()
+{
+    return data.End();
+}
+
+template <typename K, typename V, typename Traits>
+template <typename Q>
+inline bool
+FlatMap<K, V, Traits>::Contains(const Q &key) const
+{
+    assert(!bulkAdding);
+    return this->IndexOf(key, Traits::Hash(key)) >= 0;
+}
+
+template <typename K, typename V, typename Traits>
+template <typename Q>
+inline bool
+FlatMap<K, V, Traits>::TryGetValue(const Q &key, V &value) const
+{
+    assert(!bulkAdding);
+    int32_t i = this->IndexOf(key, Traits::Hash(key));
+    if (i >= 0)
+        value = data[i].value;
+    return i >= 0;
+}
+
+template <typename K, typename V, typename Traits>
+template <typename Q>
+inline const V*
+FlatMap<K, V, Traits>::Get(const Q &key) const
+{
+    assert(!bulkAdding);
+    int32_t i = this->IndexOf(key, Traits::Hash(key));
+    return i >= 0 ? &data[i].value : nullptr;
+}
+
+template <typename K, typename V, typename Traits>
+template <typename Q>
+inline V*
+FlatMap<K, V, Traits>::Get(const Q &key)
+{
+    assert(!bulkAdding);
+    int32_t i = this->IndexOf(key, Traits::Hash(key));
+    return i >= 0 ? &data[i].value : nullptr;
+}
+
+template <typename K, typename V, typename Traits>
+inline void
+FlatMap<K, V, Traits>::Clear()
+{
+    data.Clear();
+    index.Clear();
+    bulkAdding = false;
+}
+
+template <typename K, typename V, typename Traits>
+inline void
+FlatMap<K, V, Traits>::Reserve(uint32_t capacity)
+{
+    data.Reserve(capacity);
+    index.Rehash(capacity);
+}
+
+template <typename K, typename V, typename Traits>
+inline void
+FlatMap<K, V, Traits>::Add(const K &key, const V &value)
+{
+    assert(!bulkAdding);
+    uint32_t hash = Traits::Hash(key);
+    assert2(this->IndexOf(key, hash) < 0, "Key already exist");
+    index.Add(hash, data.Count());
+    data.PushBack(KeyValuePair<K, V>(key, value));
+}
+
+template <typename K, typename V, typename Traits>
+template <typename Q>
+inline void
+FlatMap<K, V, Traits>::Remove(const Q &key)
+{
+    assert(!bulkAdding);
+    uint32_t hash = Traits::Hash(key);
+    int32_t i = this->IndexOf(key, hash);
+    if (i >= 0)
+        this->RemoveAt(i, hash);
+}
+
+template <typename K, typename V, typename Traits>
+inline void
+FlatMap<K, V, Traits>::BeginBulkAdd()
+{
+    assert(!bulkAdding);
+    bulkAdding = true;
+}
+
+template <typename K, typename V, typename Traits>
+inline void
+FlatMap<K, V, Traits>::BulkAdd(const K &key, const V &value)
+{
+    assert(bulkAdding);
+    data.PushBack(KeyValuePair<K, V>(key, value));
+}
+
+template <typename K, typename V, typename Traits>
+inline void
+FlatMap<K, V, Traits>::EndBulkAdd()
+{
+    assert(bulkAdding);
+    bulkAdding = false;
+
+    // Sized once for every pair, so the index never grows while it's filled.
+    index.Rehash(data.Count());
+    for (uint32_t i = index.Count(), count = data.Count(); i < count; ++i) {
+        uint32_t hash = Traits::Hash(data[i].key);
+        assert2(this->IndexOf(data[i].key, hash) < 0, "Key already exist");
+        index.Add(hash, i);
+    }
+}
+
+} // namespace Framework
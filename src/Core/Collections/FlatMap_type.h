@@ -0,0 +1,90 @@
+#pragma once
+
+#include "Core/Collections/Array_type.h"
+#include "Core/Collections/Hash_type.h"
+
+namespace Framework {
+
+template <typename K, typename V>
+struct KeyValuePair {
+    K key;
+    V value;
+
+    KeyValuePair();
+    KeyValuePair(const K &k);
+    KeyValuePair(const K &k, const V &v);
+    KeyValuePair(const KeyValuePair<K, V> &other);
+    KeyValuePair(KeyValuePair<K, V> &&other);
+    ~KeyValuePair();
+
+    KeyValuePair<K, V>& operator =(const KeyValuePair<K, V> &other);
+    KeyValuePair<K, V>& operator =(KeyValuePair<K, V> &&other);
+
+    bool operator <(const KeyValuePair<K, V> &other) const;
+    bool operator >(const KeyValuePair<K, V> &other) const;
+};
+
+// Hash and equality used by FlatMap, overloads taking other types than K enable heterogeneous lookups.
+template <typename K>
+struct FlatMapTraits {
+    static uint32_t Hash(const K &key);
+    static bool Equals(const K &a, const K &b);
+};
+
+// Pairs are stored contiguously in insertion order, removal moves the last pair into the hole.
+// The index maps the key hash to the pair position, so Add and Remove don't shift anything.
+template <typename K, typename V, typename Traits = FlatMapTraits<K>>
+class FlatMap {
+private:
+    Array<KeyValuePair<K, V>> data;
+    Hash<uint32_t> index;
+    bool bulkAdding;
+
+    template <typename Q>
+    int32_t IndexOf(const Q &key, uint32_t hash) const;
+    void RemoveAt(uint32_t i, uint32_t hash);
+public:
+    FlatMap(Allocator &allocator);
+    FlatMap(Allocator &allocator, uint32_t initialCapacity);
+    FlatMap(const FlatMap<K, V, Traits> &other);
+    FlatMap(FlatMap<K, V, Traits> &&other);
+    ~FlatMap();
+
+    FlatMap<K, V, Traits>& operator =(const FlatMap<K, V, Traits> &other);
+    FlatMap<K, V, Traits>& operator =(FlatMap<K, V, Traits> &&other);
+
+    template <typename Q>
+    const V& operator [](const Q &key) const;
+    V& operator [](const K &key);
+
+    Allocator& GetAllocator() const;
+    uint32_t Count() const;
+    bool IsEmpty() const;
+
+    const KeyValuePair<K, V>* Begin() const;
+    KeyValuePair<K, V>* Begin();
+    const KeyValuePair<K, V>* End() const;
+    KeyValuePair<K, V>* End();
+
+    template <typename Q>
+    bool Contains(const Q &key) const;
+    template <typename Q>
+    bool TryGetValue(const Q &key, V &value) const;
+    template <typename Q>
+    const V* Get(const Q &key) const;
+    template <typename Q>
+    V* Get(const Q &key);
+
+    void Clear();
+    void Reserve(uint32_t capacity);
+    void Add(const K &key, const V &value);
+    template <typename Q>
+    void Remove(const Q &key);
+
+    // Pairs added in bulk are indexed all at once by EndBulkAdd, keys must be unique.
+    void BeginBulkAdd();
+    void BulkAdd(const K &key, const V &value);
+    void EndBulkAdd();
+};
+
+} // namespace Framework
@@ -2,52 +2,110 @@
 
 #include "Core/Collections/Hash_type.h"
 #include "Core/Collections/Array.h"
+#include "Core/BitOps.h"
 
 namespace Framework {
 
+inline
+HashGroup::HashGroup(const int8_t *pos)
+#if defined(HASH_GROUP_SSE2)
+: ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos)))
+#else
+: ctrl(pos)
+#endif
+{ }
+
+inline uint32_t
+HashGroup::Match(int8_t h2) const
+{
+#if defined(HASH_GROUP_SSE2)
+    return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl)));
+#else
+    uint32_t mask = 0;
+    for (uint32_t i = 0; i < kWidth; ++i)
+        mask |= uint32_t(ctrl[i] == h2) << i;
+    return mask;
+#endif
+}
+
+inline uint32_t
+HashGroup::MatchEmpty() const
+{
+    return this->Match(kEmpty);
+}
+
+inline uint32_t
+HashGroup::MatchEmptyOrDeleted() const
+{
+#if defined(HASH_GROUP_SSE2)
+    return uint32_t(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), ctrl)));
+#else
+    uint32_t mask = 0;
+    for (uint32_t i = 0; i < kWidth; ++i)
+        mask |= uint32_t(ctrl[i] < -1) << i;
+    return mask;
+#endif
+}
+
 template <typename T>
 inline
 Hash<T>::Hash(Allocator &allocator)
-: map(allocator),
+: ctrl(allocator),
+  slots(allocator),
   entries(allocator),
-  data(allocator)
+  data(allocator),
+  keysCount(0),
+  growthLeft(0)
 { }
 
 template <typename T>
 inline
 Hash<T>::Hash(Allocator &allocator, uint32_t initialMapSize)
-: map(allocator, initialMapSize),
+: ctrl(allocator),
+  slots(allocator),
   entries(allocator),
-  data(allocator)
+  data(allocator),
+  keysCount(0),
+  growthLeft(0)
 {
-    map.Resize(initialMapSize);
-    for (uint32_t i = 0; i < initialMapSize; ++i)
-        map[i] = kEndOfList;
+    this->Rehash(initialMapSize);
 }
 
 template <typename T>
 inline
 Hash<T>::Hash(const Hash<T> &other)
-: map(other.map),
+: ctrl(other.ctrl),
+  slots(other.slots),
   entries(other.entries),
-  data(other.data)
+  data(other.data),
+  keysCount(other.keysCount),
+  growthLeft(other.growthLeft)
 { }
 
 template <typename T>
 inline
 Hash<T>::Hash(Hash<T> &&other)
-: map(std::forward<Array<uint32_t>>(other.map)),
+: ctrl(std::forward<Array<int8_t>>(other.ctrl)),
+  slots(std::forward<Array<HashSlot>>(other.slots)),
   entries(std::forward<Array<HashEntry>>(other.entries)),
-  data(std::forward<Array<T>>(other.data))
-{ }
+  data(std::forward<Array<T>>(other.data)),
+  keysCount(other.keysCount),
+  growthLeft(other.growthLeft)
+{
+    other.keysCount = 0;
+    other.growthLeft = 0;
+}
 
 template <typename T>
 inline Hash<T>&
 Hash<T>::operator =(const Hash<T> &other)
 {
-    map = other.map;
+    ctrl = other.ctrl;
+    slots = other.slots;
     entries = other.entries;
     data = other.data;
+    keysCount = other.keysCount;
+    growthLeft = other.growthLeft;
     return (*this);
 }
 
@@ -55,142 +113,247 @@ template <typename T>
 inline Hash<T>&
 Hash<T>::operator =(Hash<T> &&other)
 {
-    map = std::forward<Array<uint32_t>>(other.map);
+    ctrl = std::forward<Array<int8_t>>(other.ctrl);
+    slots = std::forward<Array<HashSlot>>(other.slots);
 	entries = std::forward<Array<HashEntry>>(other.entries);
 	data = std::forward<Array<T>>(other.data);
+    keysCount = other.keysCount;
+    growthLeft = other.growthLeft;
+    other.keysCount = 0;
+    other.growthLeft = 0;
     return (*this);
 }
 
 template <typename T>
-inline bool
-Hash<T>::IsFull() const
+inline uint32_t
+Hash<T>::Mix(uint32_t key)
 {
-    const float maxLoadFactor = 0.7f;
-    return (0 == map.Count() || entries.Count() >= (map.Count() * maxLoadFactor));
+    // Keys are often ids or already hashed strings, finalize them so the low 7 bits are usable.
+    key ^= key >> 16;
+    key *= 0x85ebca6b;
+    key ^= key >> 13;
+    key *= 0xc2b2ae35;
+    key ^= key >> 16;
+    return key;
 }
 
 template <typename T>
-inline void
-Hash<T>::Grow()
+inline uint32_t
+Hash<T>::GetCapacityFor(uint32_t keys)
 {
-    (*this) = this->Rehash(map.Count() * 2 + 8);
+    // Max load factor is 7/8.
+    uint32_t capacity = HashGroup::kWidth;
+    while (capacity - capacity / 8 < keys)
+        capacity <<= 1;
+    return capacity;
 }
 
 template <typename T>
-inline Hash<T>
-Hash<T>::Rehash(uint32_t newMapSize)
+inline uint32_t
+Hash<T>::GetCapacity() const
 {
-    Hash<T> h(map.GetAllocator(), newMapSize);
-	HashEntry *entry = entries.Begin(), *end = entries.End();
-    for (; entry < end; ++entry)
-        h.Insert(entry->key, data[entry->index]);
-    return h;
+    return slots.Count();
 }
 
 template <typename T>
-inline const HashEntry*
-Hash<T>::FindFirst(uint32_t key) const
+inline void
+Hash<T>::SetCtrl(uint32_t slot, int8_t value)
 {
-    if (map.IsEmpty())
-        return nullptr;
+    ctrl[slot] = value;
+    if (slot < HashGroup::kWidth)
+        ctrl[this->GetCapacity() + slot] = value;
+}
 
-    uint32_t hash  = key % map.Count(),
-             index = map[hash];
+template <typename T>
+inline uint32_t
+Hash<T>::FindSlot(uint32_t key) const
+{
+    uint32_t capacity = this->GetCapacity();
+    if (0 == capacity)
+        return kEndOfList;
+
+    uint32_t hash = Mix(key),
+             mask = capacity - 1,
+             pos = (hash >> 7) & mask,
+             stride = 0;
+    int8_t h2 = int8_t(hash & 0x7f);
+
+    while (true) {
+        HashGroup group(ctrl.Begin() + pos);
+
+        uint32_t match = group.Match(h2);
+        while (match != 0) {
+            uint32_t slot = (pos + CountTrailingZeros(match)) & mask;
+            if (slots[slot].key == key)
+                return slot;
+            match &= match - 1;
+        }
 
-    if (kEndOfList == index)
-        return nullptr;
-    else {
-        while (entries[index].key != key) {
-            index = entries[index].next;
+        if (group.MatchEmpty() != 0)
+            return kEndOfList;
 
-            if (kEndOfList == index)
-                return nullptr;
-        }
+        stride += HashGroup::kWidth;
+        pos = (pos + stride) & mask;
+    }
+}
+
+template <typename T>
+inline uint32_t
+Hash<T>::FindInsertSlot(uint32_t hash) const
+{
+    uint32_t mask = this->GetCapacity() - 1,
+             pos = (hash >> 7) & mask,
+             stride = 0;
+
+    while (true) {
+        uint32_t match = HashGroup(ctrl.Begin() + pos).MatchEmptyOrDeleted();
+        if (match != 0)
+            return (pos + CountTrailingZeros(match)) & mask;
 
-        return entries.Begin() + index;
+        stride += HashGroup::kWidth;
+        pos = (pos + stride) & mask;
     }
 }
 
 template <typename T>
-inline HashEntry*
-Hash<T>::FindFirst(uint32_t key)
+inline void
+Hash<T>::EraseSlot(uint32_t slot)
 {
-    if (map.IsEmpty())
-        return nullptr;
+    --keysCount;
 
-    uint32_t hash  = key % map.Count(),
-             index = map[hash];
+    // If the slot sits in a window of less than a group with no empty slot around it,
+    // no probe sequence ever went past it and it can be emptied instead of leaving a tombstone.
+    uint32_t mask = this->GetCapacity() - 1;
+    uint32_t emptyBefore = HashGroup(ctrl.Begin() + ((slot - HashGroup::kWidth) & mask)).MatchEmpty(),
+             emptyAfter  = HashGroup(ctrl.Begin() + slot).MatchEmpty();
 
-    if (kEndOfList == index)
-        return nullptr;
-    else {
-        while (entries[index].key != key) {
-            index = entries[index].next;
-            
-            if (kEndOfList == index)
-                return nullptr;
-        }
+    bool wasNeverFull = emptyBefore != 0 && emptyAfter != 0 &&
+        ((HashGroup::kWidth - 1 - FindLastSet(emptyBefore)) + CountTrailingZeros(emptyAfter)) < HashGroup::kWidth;
 
-        return entries.Begin() + index;
+    if (wasNeverFull) {
+        this->SetCtrl(slot, HashGroup::kEmpty);
+        ++growthLeft;
+    } else {
+        this->SetCtrl(slot, HashGroup::kDeleted);
     }
 }
 
+template <typename T>
+inline void
+Hash<T>::Grow()
+{
+    // Drop the tombstones at the same capacity if the table is mostly deleted slots, double it otherwise.
+    // It never shrinks here, a table that churns around one size would otherwise flip between two.
+    uint32_t capacity = this->GetCapacity();
+    if (keysCount < (capacity - capacity / 8) / 2)
+        this->Rehash(capacity - capacity / 8);
+    else
+        this->Rehash(capacity - capacity / 8 + 1);
+}
+
+template <typename T>
+inline void
+Hash<T>::Rehash(uint32_t newMapSize)
+{
+    if (newMapSize < keysCount)
+        newMapSize = keysCount;
+
+    uint32_t capacity = GetCapacityFor(newMapSize);
+
+    ctrl.Clear();
+    ctrl.Resize(capacity + HashGroup::kWidth);
+    memset(ctrl.Begin(), HashGroup::kEmpty, ctrl.Count());
+    slots.Clear();
+    slots.Resize(capacity);
+
+    // Entries and items stay where they are, only the chain heads are inserted again.
+    for (uint32_t i = 0, count = entries.Count(); i < count; ++i) {
+        if (0 == (entries[i].prev & kHeadFlag))
+            continue;
+
+        uint32_t hash = Mix(entries[i].key),
+                 slot = this->FindInsertSlot(hash);
+        this->SetCtrl(slot, int8_t(hash & 0x7f));
+        slots[slot].key = entries[i].key;
+        slots[slot].index = i;
+        entries[i].prev = kHeadFlag | slot;
+    }
+
+    growthLeft = capacity - capacity / 8 - keysCount;
+}
+
+template <typename T>
+inline const HashEntry*
+Hash<T>::FindFirst(uint32_t key) const
+{
+    uint32_t slot = this->FindSlot(key);
+    if (kEndOfList == slot)
+        return nullptr;
+    return entries.Begin() + slots[slot].index;
+}
+
+template <typename T>
+inline HashEntry*
+Hash<T>::FindFirst(uint32_t key)
+{
+    uint32_t slot = this->FindSlot(key);
+    if (kEndOfList == slot)
+        return nullptr;
+    return entries.Begin() + slots[slot].index;
+}
+
 template <typename T>
 inline const HashEntry*
 Hash<T>::FindNext(const HashEntry *entry) const
 {
-    uint32_t next = entry->next;
-    if (kEndOfList == next || entries[next].key != entry->key)
+    if (kEndOfList == entry->next)
         return nullptr;
-    return entries.Begin() + next;
+    return entries.Begin() + entry->next;
 }
 
 template <typename T>
 inline HashEntry*
 Hash<T>::FindNext(HashEntry *entry)
 {
-    uint32_t next = entry->next;
-    if (kEndOfList == next || entries[next].key != entry->key)
+    if (kEndOfList == entry->next)
         return nullptr;
-    return entries.Begin() + next;
+    return entries.Begin() + entry->next;
 }
 
 template <typename T>
 inline HashEntry*
 Hash<T>::Insert(uint32_t key, const T& item)
 {
-    if (this->IsFull())
+    uint32_t slot = this->FindSlot(key);
+    if (kEndOfList == slot && 0 == growthLeft) {
         this->Grow();
+        assert(growthLeft > 0);
+    }
+
+    uint32_t entryIndex = entries.Count();
 
 	entries.PushBack(HashEntry());
     data.PushBack(item);
 
 	HashEntry &entry = entries.Back();
-
-    uint32_t entryIndex = &entry - entries.Begin(),
-             entryHash  = key % map.Count();
-
-    entry.key   = key;
-    entry.index = entryIndex;
-    entry.prev  = kEndOfList;
-    entry.next  = kEndOfList;
-
-    HashEntry *firstEntry = this->FindFirst(key);
-    if (nullptr == firstEntry)
-        firstEntry = (kEndOfList == map[entryHash] ? nullptr : entries.Begin() + map[entryHash]);
-
-    if (nullptr == firstEntry) {
-        map[entryHash] = entryIndex;
+    entry.key  = key;
+    entry.next = kEndOfList;
+
+    if (kEndOfList == slot) {
+        uint32_t hash = Mix(key);
+        slot = this->FindInsertSlot(hash);
+        if (HashGroup::kEmpty == ctrl[slot])
+            --growthLeft;
+        this->SetCtrl(slot, int8_t(hash & 0x7f));
+        slots[slot].key = key;
+        ++keysCount;
     } else {
-        entry.prev = firstEntry->prev;
-        if (kEndOfList == entry.prev)
-            map[entryHash] = entryIndex;
-        else
-            entries[entry.prev].next = entryIndex;
-
-        entry.next = firstEntry->index;
-        firstEntry->prev = entryIndex;
+        // The newest item goes first in its key chain.
+        entry.next = slots[slot].index;
+        entries[entry.next].prev = entryIndex;
     }
+    entry.prev = kHeadFlag | slot;
+    slots[slot].index = entryIndex;
 
     return &entry;
 }
@@ -199,23 +362,30 @@ template <typename T>
 inline void
 Hash<T>::Erase(HashEntry *entry)
 {
-    if (kEndOfList == entry->prev)
-        map[entry->key % map.Count()] = entry->next;
-    else
+    uint32_t index     = entry - entries.Begin(),
+             lastIndex = entries.Count() - 1;
+
+    if (entry->prev & kHeadFlag) {
+        uint32_t slot = entry->prev & ~kHeadFlag;
+        assert(slots[slot].index == index);
+        if (kEndOfList == entry->next)
+            this->EraseSlot(slot);
+        else
+            slots[slot].index = entry->next;
+    } else {
         entries[entry->prev].next = entry->next;
+    }
 
     if (entry->next != kEndOfList)
         entries[entry->next].prev = entry->prev;
 
-    int index     = entry->index,
-        lastIndex = entries.Count() - 1;
-
     if (index == lastIndex) {
         entries.PopBack();
         data.PopBack();
         return;
     }
 
+    // Fill the hole with the last item and patch whatever pointed to it.
     entries[index] = entries[lastIndex];
     Memory::Move(data.Begin() + index, data.Begin() + lastIndex, 1);
 
@@ -223,9 +393,8 @@ Hash<T>::Erase(HashEntry *entry)
     data.PopBack();
 
 	HashEntry *movedEntry = entries.Begin() + index;
-    movedEntry->index = index;
-    if (kEndOfList == movedEntry->prev)
-        map[movedEntry->key % map.Count()] = index;
+    if (movedEntry->prev & kHeadFlag)
+        slots[movedEntry->prev & ~kHeadFlag].index = index;
     else
         entries[movedEntry->prev].next = index;
     if (movedEntry->next != kEndOfList)
@@ -236,7 +405,7 @@ template <typename T>
 Allocator&
 Hash<T>::GetAllocator() const
 {
-    return map.GetAllocator();
+    return entries.GetAllocator();
 }
 
 template <typename T>
@@ -250,7 +419,7 @@ template <typename T>
 inline uint32_t
 Hash<T>::Count(uint32_t key) const
 {
-	HashEntry *entry = this->FindFirst(key);
+	const HashEntry *entry = this->FindFirst(key);
     uint32_t counter = 0;
     while (entry != nullptr) {
         ++counter;
@@ -302,7 +471,7 @@ Hash<T>::Get(uint32_t key)
     if (nullptr == entry)
         return nullptr;
     else
-        return data.Begin() + entry->index;
+        return data.Begin() + (entry - entries.Begin());
 }
 
 template <typename T>
@@ -313,7 +482,7 @@ Hash<T>::Get(uint32_t key) const
     if (nullptr == entry)
         return nullptr;
     else
-        return data.Begin() + entry->index;
+        return data.Begin() + (entry - entries.Begin());
 }
 
 template <typename T>
@@ -323,34 +492,38 @@ Hash<T>::GetAll(uint32_t key, Allocator &allocator)
     Array<T*> array(allocator);
 	HashEntry *entry = this->FindFirst(key);
     while (entry != nullptr) {
-        array.PushBack(data.Begin() + entry->index);
+        array.PushBack(data.Begin() + (entry - entries.Begin()));
         entry = this->FindNext(entry);
     }
     return array;
 }
 
 template <typename T>
+template <typename F>
 inline T*
-Hash<T>::Find(uint32_t key, std::function<bool(const T&)> f)
+Hash<T>::Find(uint32_t key, F predicate)
 {
 	HashEntry *entry = this->FindFirst(key);
     while (entry != nullptr) {
-        if (f(data[entry->index]))
-            return data.Begin() + entry->index;
+        T *item = data.Begin() + (entry - entries.Begin());
+        if (predicate(*item))
+            return item;
         entry = this->FindNext(entry);
     }
     return nullptr;
 }
 
 template <typename T>
+template <typename F>
 inline Array<T*>
-Hash<T>::FindAll(uint32_t key, Allocator &allocator, std::function<bool(const T&)> f)
+Hash<T>::FindAll(uint32_t key, Allocator &allocator, F predicate)
 {
     Array<T*> array(allocator);
 	HashEntry *entry = this->FindFirst(key);
     while (entry != nullptr) {
-        if (f(data[entry->index]))
-            array.PushBack(data.Begin() + entry->index);
+        T *item = data.Begin() + (entry - entries.Begin());
+        if (predicate(*item))
+            array.PushBack(item);
         entry = this->FindNext(entry);
     }
     return array;
@@ -362,12 +535,11 @@ Hash<T>::Next(T *item)
 {
     uint32_t index = item - data.Begin();
     assert(index < data.Count());
-	HashEntry *entry = entries.Begin() + index;
-    entry = this->FindNext(entry);
-    if (nullptr == entry)
+    uint32_t next = entries[index].next;
+    if (kEndOfList == next)
         return nullptr;
     else
-        return data.Begin() + entry->index;
+        return data.Begin() + next;
 }
 
 template <typename T>
@@ -376,20 +548,22 @@ Hash<T>::Next(const T *item) const
 {
     uint32_t index = item - data.Begin();
     assert(index < data.Count());
-	const HashEntry *entry = entries.Begin() + index;
-    entry = this->FindNext(entry);
-    if (nullptr == entry)
+    uint32_t next = entries[index].next;
+    if (kEndOfList == next)
         return nullptr;
     else
-        return data.Begin() + entry->index;
+        return data.Begin() + next;
 }
 
 template <typename T>
 inline void
 Hash<T>::Clear()
 {
-    for (uint32_t i = 0, l = map.Count(); i < l; ++i)
-        map[i] = kEndOfList;
+    uint32_t capacity = this->GetCapacity();
+    if (capacity > 0)
+        memset(ctrl.Begin(), HashGroup::kEmpty, ctrl.Count());
+    keysCount = 0;
+    growthLeft = capacity - capacity / 8;
     entries.Clear();
     data.Clear();
 }
@@ -409,7 +583,7 @@ Hash<T>::Set(uint32_t key, const T& item)
     if (nullptr == entry)
         this->Insert(key, item);
     else
-        data[entry->index] = item;
+        data[entry - entries.Begin()] = item;
 }
 
 template <typename T>
@@ -422,15 +596,19 @@ Hash<T>::Remove(T *item)
 }
 
 template <typename T>
+template <typename F>
 inline void
-Hash<T>::RemoveIf(uint32_t key, std::function<bool(const T&)> f)
+Hash<T>::RemoveIf(uint32_t key, F predicate)
 {
-	const HashEntry *entry = this->FindFirst(key);
+    // Erase moves the last item into the hole, so restart from the chain head after each removal.
+	HashEntry *entry = this->FindFirst(key);
     while (entry != nullptr) {
-		const HashEntry *tmp = entry;
-        entry = this->FindNext(entry);
-        if (f(data[tmp->index]))
-            this->Erase(tmp);
+        if (predicate(data[entry - entries.Begin()])) {
+            this->Erase(entry);
+            entry = this->FindFirst(key);
+        } else {
+            entry = this->FindNext(entry);
+        }
     }
 }
 
@@ -440,9 +618,8 @@ Hash<T>::RemoveAll(uint32_t key)
 {
 	HashEntry *entry = this->FindFirst(key);
     while (entry != nullptr) {
-		HashEntry *tmp = entry;
-        entry = this->FindNext(entry);
-        this->Erase(tmp);
+        this->Erase(entry);
+        entry = this->FindFirst(key);
     }
 }
 
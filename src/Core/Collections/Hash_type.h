@@ -2,25 +2,68 @@
 
 #include "Core/Collections/Array_type.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   include <emmintrin.h>
+#   define HASH_GROUP_SSE2
+#endif
+
 namespace Framework {
 
+// Same key entries are chained, only the first of the chain has a slot in the table.
 struct HashEntry {
 	uint32_t key;
-	uint32_t index;
-	uint32_t prev;
+	uint32_t prev; // the first entry keeps its slot here, tagged with kHeadFlag
 	uint32_t next;
 };
 
+// Keeps the key next to the entry index so a probe doesn't touch the entries.
+struct HashSlot {
+    uint32_t key;
+    uint32_t index;
+};
+
+// 16 control bytes matched at once, a full slot stores the low 7 bits of the key hash.
+struct HashGroup {
+    static const uint32_t kWidth = 16;
+    static const int8_t   kEmpty = -128;
+    static const int8_t   kDeleted = -2;
+
+#if defined(HASH_GROUP_SSE2)
+    __m128i ctrl;
+#else
+    const int8_t *ctrl;
+#endif
+
+    explicit HashGroup(const int8_t *pos);
+
+    uint32_t Match(int8_t h2) const;
+    uint32_t MatchEmpty() const;
+    uint32_t MatchEmptyOrDeleted() const;
+};
+
 template <typename T>
 class Hash {
 private:
     static const uint32_t kEndOfList = 0xffffffff;
+    static const uint32_t kHeadFlag = 0x80000000;
 
-    Array<uint32_t> map;
+    Array<int8_t> ctrl;     // capacity + HashGroup::kWidth, the tail mirrors the first group
+    Array<HashSlot> slots;  // first entry of each key
 	Array<HashEntry> entries;
     Array<T> data;
 
-    bool IsFull() const;
+    uint32_t keysCount;
+    uint32_t growthLeft;
+
+    static uint32_t Mix(uint32_t key);
+    static uint32_t GetCapacityFor(uint32_t keys);
+
+    uint32_t GetCapacity() const;
+    void SetCtrl(uint32_t slot, int8_t value);
+
+    uint32_t FindSlot(uint32_t key) const;
+    uint32_t FindInsertSlot(uint32_t hash) const;
+    void EraseSlot(uint32_t slot);
     void Grow();
 
 	const HashEntry* FindFirst(uint32_t key) const;
@@ -39,7 +82,8 @@ public:
     Hash<T>& operator =(const Hash<T> &other);
     Hash<T>& operator =(Hash<T> &&other);
 
-    Hash<T> Rehash(uint32_t newMapSize);
+    // Rebuilds the table in place for at least newMapSize keys, items don't move.
+    void Rehash(uint32_t newMapSize);
 
     Allocator& GetAllocator() const;
     uint32_t Count() const;
@@ -55,8 +99,10 @@ public:
     const T* Get(uint32_t key) const;
     Array<T*> GetAll(uint32_t key, Allocator &allocator);
 
-    T* Find(uint32_t key, std::function<bool(const T&)> f);
-    Array<T*> FindAll(uint32_t key, Allocator &allocator, std::function<bool(const T&)> f);
+    template <typename F>
+    T* Find(uint32_t key, F predicate);
+    template <typename F>
+    Array<T*> FindAll(uint32_t key, Allocator &allocator, F predicate);
 
     T* Next(T *item);
     const T* Next(const T *item) const;
@@ -66,7 +112,8 @@ public:
     void Set(uint32_t key, const T& item);
 
     void Remove(T *item);
-    void RemoveIf(uint32_t key, std::function<bool(const T&)> f);
+    template <typename F>
+    void RemoveIf(uint32_t key, F predicate);
     void RemoveAll(uint32_t key);
 };
 
@@ -0,0 +1,456 @@
+#pragma once
+
+#include "Core/Collections/InlineArray_type.h"
+#include "Core/Collections/Sort.h"
+#include "Core/Debug.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Memory/Allocator.h"
+
+namespace Framework {
+
+template <typename T, uint32_t N>
+inline T*
+InlineArray<T, N>::GetInlineData()
+{
+    return reinterpret_cast<T*>(storage);
+}
+
+template <typename T, uint32_t N>
+inline bool
+InlineArray<T, N>::IsInline() const
+{
+    return data == reinterpret_cast<const T*>(storage);
+}
+
+template <typename T, uint32_t N>
+inline void
+InlineArray<T, N>::FreeHeapData()
+{
+    if (!this->IsInline()) {
+        allocator->Free(data);
+        data = this->GetInlineData();
+        capacity = N;
+    }
+}
+
+template <typename T, uint32_t N>
+inline void
+InlineArray<T, N>::MoveFrom(InlineArray<T, N> &other)
+{
+    // Heap data is stolen, inline items have to be moved one by one.
+    if (other.IsInline()) {
+        Memory::Move(data, other.data, other.size);
+    } else {
+        data = other.data;
+        capacity = other.capacity;
+        other.data = other.GetInlineData();
+        other.capacity = N;
+    }
+    size = other.size;
+    other.size = 0;
+}
+
+template <typename T, uint32_t N>
+inline void
+InlineArray<T, N>::Grow(uint32_t minCapacity)
+{
+    uint32_t newCapacity = capacity * 2;
+    if (newCapacity < minCapacity)
+        newCapacity = minCapacity;
+    this->SetCapacity(newCapacity);
+}
+
+template <typename T, uint32_t N>
+inline
+InlineArray<T, N>::InlineArray(Allocator &_allocator)
+: size(0),
+  capacity(N),
+  data(reinterpret_cast<T*>(storage)),
+  allocator(&_allocator)
+{
+    static_assert(N > 0, "InlineArray needs inline storage, use Array");
+}
+
+template <typename T, uint32_t N>
+inline
+InlineArray<T, N>::InlineArray(Allocator &_allocator, uint32_t initialCapacity)
+: size(0),
+  capacity(N),
+  data(reinterpret_cast<T*>(storage)),
+  allocator(&_allocator)
+{
+    this->Reserve(initialCapacity);
+}
+
+template <typename T, uint32_t N>
+inline
+InlineArray<T, N>::InlineArray(const InlineArray<T, N> &other)
+: size(0),
+  capacity(N),
+  data(reinterpret_cast<T*>(storage)),
+  allocator(other.allocator)
+{
+    this->Reserve(other.size);
+    Memory::Copy(data, other.data, other.size);
+    size = other.size;
+}
+
+template <typename T, uint32_t N>
+inline
+InlineArray<T, N>::InlineArray(InlineArray<T, N> &&other)
+: size(0),
+  capacity(N),
+  data(reinterpret_cast<T*>(storage)),
+  allocator(other.allocator)
+{
+    this->MoveFrom(other);
+}
+
+template <typename T, uint32_t N>
+inline
+InlineArray<T, N>::~InlineArray()
+{
+    this->Clear();
+    this->FreeHeapData();
+}
+
+template <typename T, uint32_t N>
+inline InlineArray<T, N>&
+InlineArray<T, N>::operator =(const InlineArray<T, N> &other)
+{
+    if (this == &other)
+        return (*this);
+
+    this->Clear();
+    this->FreeHeapData();
+
+    allocator = other.allocator;
+    this->Reserve(other.size);
+    Memory::Copy(data, other.data, other.size);
+    size = other.size;
+
+    return (*this);
+}
+
+template <typename T, uint32_t N>
+inline InlineArray<T, N>&
+InlineArray<T, N>::operator =(InlineArray<T, N> &&other)
+{
+    if (this == &other)
+        return (*this);
+
+    this->Clear();
+    this->FreeHeapData();
+
+    allocator = other.allocator;
+    this->MoveFrom(other);
+
+    return (*this);
+}
+
+template <typename T, uint32_t N>
+inline const T&
+InlineArray<T, N>::operator [](uint32_t index) const
+{
+    assert(index < size);
+    return data[index];
+}
+
+template <typename T, uint32_t N>
+inline T&
+InlineArray<T, N>::operator [](uint32_t index)
+{
+    assert(index < size);
+    return data[index];
+}
+
+template <typename T, uint32_t N>
+inline Allocator&
+InlineArray<T, N>::GetAllocator() const
+{
+    return *const_cast<Allocator*>(allocator);
+}
+
+template <typename T, uint32_t N>
+inline uint32_t
+InlineArray<T, N>::Count() const
+{
+    return size;
+}
+
+template <typename T, uint32_t N>
+inline uint32_t
+InlineArray<T, N>::Capacity() const
+{
+    return capacity;
+}
+
+template <typename T, uint32_t N>
+inline bool
+InlineArray<T, N>::IsEmpty() const
+{
+    return 0 == size;
+}
+
+template <typename T, uint32_t N>
+inline const T*
+InlineArray<T, N>::Begin() const
+{
+    return data;
+}
+
+template <typename T, uint32_t N>
+inline T*
+InlineArray<T, N>::Begin()
+{
+    return data;
+}
+
+template <typename T, uint32_t N>
+inline const T*
+InlineArray<T, N>::End() const
+{
+    return data + size;
+}
+
+template <typename T, uint32_t N>
+inline T*
+InlineArray<T, N>::End()
+{
+    return data + size;
+}
+
+template <typename T, uint32_t N>
+inline const T&
+InlineArray<T, N>::Front() const
+{
+    assert(size > 0);
+    return *data;
+}
+
+template <typename T, uint32_t N>
+inline T&
+InlineArray<T, N>::Front()
+{
+    assert(size > 0);
+    return *data;
+}
+
+template <typename T, uint32_t N>
+inline const T&
+InlineArray<T, N>::Back() const
+{
+    assert(size > 0);
+    return *(data + size - 1);
+}
+
+template <typename T, uint32_t N>
+inline T&
+InlineArray<T, N>::Back()
+{
+    assert(size > 0);
+    return *(data + size - 1);
+}
+
+template <typename T, uint32_t N>
+inline void
+InlineArray<T, N>::Clear()
+{
+    if (!std::is_trivially_copyable<T>::value && std::is_destructible<T>::value) {
+        for (uint32_t i = 0; i < size; ++i)
+            (data + i)->~T();
+    }
+
+    size = 0;
+}
+
+template <typename T, uint32_t N>
+inline void
+InlineArray<T, N>::Resize(uint32_t newSize)
+{
+    if (capacity < newSize)
+        this->Grow(newSize);
+
+    if (!std::is_trivially_copyable<T>::value) {
+        if (std::is_default_constructible<T>::value && newSize > size) {
+            for (uint32_t i = size; i < newSize; ++i)
+                new(data + i) T();
+        }
+
+        if (std::is_destructible<T>::value && newSize < size) {
+            for (uint32_t i = newSize; i < size; ++i)
+                (data + i)->~T();
+        }
+    }
+
+    size = newSize;
+}
+
+template <typename T, uint32_t N>
+inline void
+InlineArray<T, N>::SetCapacity(uint32_t newCapacity)
+{
+    if (newCapacity < size) {
+        this->Resize(newCapacity);
+        return;
+    }
+
+    if (newCapacity < N)
+        newCapacity = N;
+    if (capacity == newCapacity)
+        return;
+
+    bool wasInline = this->IsInline();
+    if (!wasInline && newCapacity > N) {
+        if (std::is_trivially_copyable<T>::value) {
+            data = static_cast<T*>(allocator->Reallocate(data, capacity * sizeof(T), newCapacity * sizeof(T), __alignof(T)));
+            capacity = newCapacity;
+            return;
+        } else if (allocator->TryExpand(data, capacity * sizeof(T), newCapacity * sizeof(T))) {
+            capacity = newCapacity;
+            return;
+        }
+    }
+
+    T *newData = newCapacity > N ? static_cast<T*>(allocator->Allocate(newCapacity * sizeof(T), __alignof(T))) : this->GetInlineData();
+    Memory::Move(newData, data, size);
+
+    if (!wasInline)
+        allocator->Free(data);
+
+    data = newData;
+    capacity = newCapacity;
+}
+
+template <typename T, uint32_t N>
+inline void
+InlineArray<T, N>::Reserve(uint32_t newCapacity)
+{
+    if (capacity < newCapacity)
+        this->SetCapacity(newCapacity);
+}
+
+template <typename T, uint32_t N>
+inline void
+InlineArray<T, N>::PushBack(const T &item)
+{
+    if (size == capacity)
+        this->Grow();
+    Memory::Copy(data + (size++), &item, 1);
+}
+
+template <typename T, uint32_t N>
+inline void
+InlineArray<T, N>::Insert(uint32_t index, const T &item)
+{
+    assert(index <= size);
+    if (index == size) {
+        this->PushBack(item);
+    } else {
+        if (size == capacity)
+            this->Grow();
+        Memory::MoveReverse(data + index + 1, data + index, size - index);
+        Memory::Copy(data + index, &item, 1);
+        size++;
+    }
+}
+
+template <typename T, uint32_t N>
+inline void
+InlineArray<T, N>::InsertRange(uint32_t index, const T *items, uint32_t count)
+{
+    assert(index <= size);
+    if (size + count > capacity)
+        this->Grow(size + count);
+    if (index < size)
+        Memory::MoveReverse(data + index + count, data + index, size - index);
+    Memory::Copy(data + index, items, count);
+    size += count;
+}
+
+template <typename T, uint32_t N>
+inline void
+InlineArray<T, N>::PopBack()
+{
+    assert(size > 0);
+    size--;
+    if (!std::is_trivially_copyable<T>::value && std::is_destructible<T>::value)
+        (data + size)->~T();
+}
+
+template <typename T, uint32_t N>
+inline void
+InlineArray<T, N>::Remove(const T &item)
+{
+    for (uint32_t i = 0; i < size; ++i) {
+        if (*(data + i) == item) {
+            this->RemoveAt(i);
+            break;
+        }
+    }
+}
+
+template <typename T, uint32_t N>
+inline void
+InlineArray<T, N>::RemoveAt(uint32_t index)
+{
+    assert(index < size);
+    if (!std::is_trivially_copyable<T>::value && std::is_destructible<T>::value)
+        (data + index)->~T();
+    --size;
+    if (size > 0 && index < size)
+        Memory::Move(data + index, data + index + 1, size - index);
+}
+
+template <typename T, uint32_t N>
+inline void
+InlineArray<T, N>::RemoveRange(uint32_t index, uint32_t count)
+{
+    uint32_t endIndex = index + count;
+    assert(index < size && endIndex <= size);
+    if (!std::is_trivially_copyable<T>::value && std::is_destructible<T>::value) {
+        for (uint32_t i = index; i < endIndex; ++i)
+            (data + i)->~T();
+    }
+    if (size > count && endIndex < size)
+        Memory::Move(data + index, data + endIndex, size - endIndex);
+    size -= count;
+}
+
+template <typename T, uint32_t N>
+inline void
+InlineArray<T, N>::Trim()
+{
+    if (!this->IsInline())
+        this->SetCapacity(size);
+}
+
+template <typename T, uint32_t N>
+inline int32_t
+InlineArray<T, N>::IndexOf(const T &item)
+{
+    for (uint32_t i = 0; i < size; ++i) {
+        if (*(data + i) == item)
+            return i;
+    }
+    return -1;
+}
+
+template <typename T, uint32_t N>
+inline void
+InlineArray<T, N>::Sort(InlineArray<T, N> &array, uint32_t index, uint32_t count)
+{
+    InlineArray<T, N>::Sort(array, index, count, [] (const T &a, const T &b) { return a < b; });
+}
+
+template <typename T, uint32_t N>
+template <typename F>
+inline void
+InlineArray<T, N>::Sort(InlineArray<T, N> &array, uint32_t index, uint32_t count, F less)
+{
+    uint32_t right = index + count;
+    assert(index < array.size && right <= array.size);
+    Sorting::Sort(array.data + index, array.data + right, less);
+}
+
+} // namespace Framework
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Framework {
+
+class Allocator;
+
+// Same interface as Array<T>, the first N items live inside the object and
+// the allocator is used only once they don't fit anymore.
+template <typename T, uint32_t N>
+class InlineArray
+{
+private:
+    uint32_t size;
+    uint32_t capacity;
+    T        *data;
+
+    Allocator *allocator;
+
+    alignas(T) uint8_t storage[N * sizeof(T)];
+
+    T* GetInlineData();
+    bool IsInline() const;
+    void FreeHeapData();
+    void MoveFrom(InlineArray<T, N> &other);
+
+    void Grow(uint32_t minCapacity = 0);
+public:
+    InlineArray(Allocator &_allocator);
+    InlineArray(Allocator &_allocator, uint32_t initialCapacity);
+    InlineArray(const InlineArray<T, N> &other);
+    InlineArray(InlineArray<T, N> &&other);
+    ~InlineArray();
+
+    InlineArray<T, N>& operator =(const InlineArray<T, N> &other);
+    InlineArray<T, N>& operator =(InlineArray<T, N> &&other);
+
+    const T& operator [](uint32_t index) const;
+    T& operator [](uint32_t index);
+
+    Allocator& GetAllocator() const;
+    uint32_t Count() const;
+    uint32_t Capacity() const;
+    bool IsEmpty() const;
+
+    const T* Begin() const;
+    T* Begin();
+    const T* End() const;
+    T* End();
+
+    const T& Front() const;
+    T& Front();
+    const T& Back() const;
+    T& Back();
+
+    void Clear();
+    void Resize(uint32_t newSize);
+    void SetCapacity(uint32_t newCapacity);
+    void Reserve(uint32_t newCapacity);
+
+    void PushBack(const T &item);
+    void Insert(uint32_t index, const T &item);
+    void InsertRange(uint32_t index, const T *items, uint32_t count);
+
+    void PopBack();
+    void Remove(const T &item);
+    void RemoveAt(uint32_t index);
+    void RemoveRange(uint32_t index, uint32_t count);
+
+    // Goes back to the inline storage when the items fit.
+    void Trim();
+
+    int32_t IndexOf(const T &item);
+
+    static void Sort(InlineArray<T, N> &array, uint32_t index, uint32_t count);
+    template <typename F>
+    static void Sort(InlineArray<T, N> &array, uint32_t index, uint32_t count, F less);
+};
+
+} // namespace Framework
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <utility>
+#include "Core/Collections/MPMCQueue_type.h"
+#include "Core/BitOps.h"
+#include "Core/Debug.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Memory/Allocator.h"
+
+namespace Framework {
+
+template <typename T>
+inline
+MPMCQueue<T>::MPMCQueue(Allocator &_allocator, uint32_t capacity)
+: allocator(&_allocator),
+  enqueuePos(0),
+  dequeuePos(0)
+{
+    assert(capacity > 0 && capacity <= 0x40000000);
+    capacity = capacity > 2 ? 2u << FindLastSet(capacity - 1) : 2;
+
+    mask = capacity - 1;
+    cells = static_cast<Cell*>(allocator->Allocate(sizeof(Cell) * capacity, __alignof(Cell)));
+    for (uint32_t i = 0; i < capacity; ++i)
+        new(&cells[i].sequence) std::atomic<uint32_t>(i);
+}
+
+template <typename T>
+inline
+MPMCQueue<T>::~MPMCQueue()
+{
+    if (!std::is_trivially_destructible<T>::value) {
+        for (uint32_t i = dequeuePos.load(std::memory_order_relaxed), end = enqueuePos.load(std::memory_order_relaxed); i != end; ++i)
+            reinterpret_cast<T*>(cells[i & mask].storage)->~T();
+    }
+    allocator->Free(cells);
+}
+
+template <typename T>
+inline typename MPMCQueue<T>::Cell*
+MPMCQueue<T>::AcquireEnqueueCell(uint32_t &pos)
+{
+    pos = enqueuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        Cell *cell = cells + (pos & mask);
+        uint32_t sequence = cell->sequence.load(std::memory_order_acquire);
+        int32_t diff = int32_t(sequence - pos);
+        if (0 == diff) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                return cell;
+        } else if (diff < 0) {
+            return nullptr; // the cell still holds an item from the previous lap, full
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template <typename T>
+inline Allocator&
+MPMCQueue<T>::GetAllocator() const
+{
+    return *allocator;
+}
+
+template <typename T>
+inline uint32_t
+MPMCQueue<T>::Capacity() const
+{
+    return mask + 1;
+}
+
+template <typename T>
+inline uint32_t
+MPMCQueue<T>::Count() const
+{
+    uint32_t dequeued = dequeuePos.load(std::memory_order_relaxed),
+             enqueued = enqueuePos.load(std::memory_order_relaxed);
+    return int32_t(enqueued - dequeued) > 0 ? enqueued - dequeued : 0;
+}
+
+template <typename T>
+inline bool
+MPMCQueue<T>::IsEmpty() const
+{
+    return 0 == this->Count();
+}
+
+template <typename T>
+inline bool
+MPMCQueue<T>::TryPush(const T &item)
+{
+    uint32_t pos;
+    Cell *cell = this->AcquireEnqueueCell(pos);
+    if (nullptr == cell)
+        return false;
+
+    new(cell->storage) T(item);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+
+    return true;
+}
+
+template <typename T>
+inline bool
+MPMCQueue<T>::TryPush(T &&item)
+{
+    uint32_t pos;
+    Cell *cell = this->AcquireEnqueueCell(pos);
+    if (nullptr == cell)
+        return false;
+
+    new(cell->storage) T(std::move(item));
+    cell->sequence.store(pos + 1, std::memory_order_release);
+
+    return true;
+}
+
+template <typename T>
+inline bool
+MPMCQueue<T>::TryPop(T &item)
+{
+    Cell *cell;
+    uint32_t pos = dequeuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        cell = cells + (pos & mask);
+        uint32_t sequence = cell->sequence.load(std::memory_order_acquire);
+        int32_t diff = int32_t(sequence - (pos + 1));
+        if (0 == diff) {
+            if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            return false; // not written yet, empty
+        } else {
+            pos = dequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    T *slot = reinterpret_cast<T*>(cell->storage);
+    item = std::move(*slot);
+    slot->~T();
+
+    // Ready for the producer one lap ahead.
+    cell->sequence.store(pos + mask + 1, std::memory_order_release);
+
+    return true;
+}
+
+} // namespace Framework
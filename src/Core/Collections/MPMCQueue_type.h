@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <atomic>
+
+namespace Framework {
+
+class Allocator;
+
+// Bounded lock-free queue for any number of producers and consumers (Dmitry Vyukov's design).
+// Every cell has a sequence number telling whether it's ready to be written or read for a
+// given position, so producers and consumers only contend on their own position counter.
+template <typename T>
+class MPMCQueue
+{
+private:
+    static const uint32_t kCacheLineSize = 64;
+
+    struct Cell {
+        std::atomic<uint32_t> sequence;
+        alignas(T) uint8_t storage[sizeof(T)];
+    };
+
+    Cell *cells;
+    uint32_t mask;
+    Allocator *allocator;
+    uint8_t padding0[kCacheLineSize - sizeof(Cell*) - sizeof(uint32_t) - sizeof(Allocator*)];
+
+    std::atomic<uint32_t> enqueuePos;
+    uint8_t padding1[kCacheLineSize - sizeof(std::atomic<uint32_t>)];
+
+    std::atomic<uint32_t> dequeuePos;
+    uint8_t padding2[kCacheLineSize - sizeof(std::atomic<uint32_t>)];
+
+    Cell* AcquireEnqueueCell(uint32_t &pos);
+public:
+    MPMCQueue(Allocator &_allocator, uint32_t capacity);
+    MPMCQueue(const MPMCQueue<T> &other) = delete;
+    ~MPMCQueue();
+
+    MPMCQueue<T>& operator =(const MPMCQueue<T> &other) = delete;
+
+    Allocator& GetAllocator() const;
+    uint32_t Capacity() const;
+    // Approximate while other threads push or pop.
+    uint32_t Count() const;
+    bool IsEmpty() const;
+
+    // False when full.
+    bool TryPush(const T &item);
+    bool TryPush(T &&item);
+
+    // False when empty.
+    bool TryPop(T &item);
+};
+
+} // namespace Framework
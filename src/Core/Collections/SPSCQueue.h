@@ -0,0 +1,130 @@
+#pragma once
+
+#include <utility>
+#include "Core/Collections/SPSCQueue_type.h"
+#include "Core/BitOps.h"
+#include "Core/Debug.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Memory/Allocator.h"
+
+namespace Framework {
+
+template <typename T>
+inline
+SPSCQueue<T>::SPSCQueue(Allocator &_allocator, uint32_t capacity)
+: head(0),
+  cachedTail(0),
+  tail(0),
+  cachedHead(0),
+  allocator(&_allocator)
+{
+    assert(capacity > 0 && capacity <= 0x40000000);
+    capacity = capacity > 1 ? 2u << FindLastSet(capacity - 1) : 1;
+
+    mask = capacity - 1;
+    items = static_cast<T*>(allocator->Allocate(sizeof(T) * capacity, __alignof(T)));
+}
+
+template <typename T>
+inline
+SPSCQueue<T>::~SPSCQueue()
+{
+    if (!std::is_trivially_destructible<T>::value) {
+        for (uint32_t i = head.load(std::memory_order_relaxed), end = tail.load(std::memory_order_relaxed); i != end; ++i)
+            (items + (i & mask))->~T();
+    }
+    allocator->Free(items);
+}
+
+template <typename T>
+inline T*
+SPSCQueue<T>::AcquirePushSlot(uint32_t &t)
+{
+    t = tail.load(std::memory_order_relaxed);
+    if (t - cachedHead > mask) {
+        // Looks full, see how far the consumer got.
+        cachedHead = head.load(std::memory_order_acquire);
+        if (t - cachedHead > mask)
+            return nullptr;
+    }
+    return items + (t & mask);
+}
+
+template <typename T>
+inline Allocator&
+SPSCQueue<T>::GetAllocator() const
+{
+    return *allocator;
+}
+
+template <typename T>
+inline uint32_t
+SPSCQueue<T>::Capacity() const
+{
+    return mask + 1;
+}
+
+template <typename T>
+inline uint32_t
+SPSCQueue<T>::Count() const
+{
+    return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+}
+
+template <typename T>
+inline bool
+SPSCQueue<T>::IsEmpty() const
+{
+    return 0 == this->Count();
+}
+
+template <typename T>
+inline bool
+SPSCQueue<T>::TryPush(const T &item)
+{
+    uint32_t t;
+    T *slot = this->AcquirePushSlot(t);
+    if (nullptr == slot)
+        return false;
+
+    new(slot) T(item);
+    tail.store(t + 1, std::memory_order_release);
+
+    return true;
+}
+
+template <typename T>
+inline bool
+SPSCQueue<T>::TryPush(T &&item)
+{
+    uint32_t t;
+    T *slot = this->AcquirePushSlot(t);
+    if (nullptr == slot)
+        return false;
+
+    new(slot) T(std::move(item));
+    tail.store(t + 1, std::memory_order_release);
+
+    return true;
+}
+
+template <typename T>
+inline bool
+SPSCQueue<T>::TryPop(T &item)
+{
+    uint32_t h = head.load(std::memory_order_relaxed);
+    if (h == cachedTail) {
+        cachedTail = tail.load(std::memory_order_acquire);
+        if (h == cachedTail)
+            return false;
+    }
+
+    T *slot = items + (h & mask);
+    item = std::move(*slot);
+    slot->~T();
+    head.store(h + 1, std::memory_order_release);
+
+    return true;
+}
+
+} // namespace Framework
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <atomic>
+
+namespace Framework {
+
+class Allocator;
+
+// Bounded lock-free ring for one producer thread and one consumer thread.
+// Each side keeps its index and a cached copy of the other side's index on its own cache line.
+template <typename T>
+class SPSCQueue
+{
+private:
+    static const uint32_t kCacheLineSize = 64;
+
+    // Consumer line.
+    std::atomic<uint32_t> head;
+    uint32_t cachedTail;
+    uint8_t padding0[kCacheLineSize - sizeof(std::atomic<uint32_t>) - sizeof(uint32_t)];
+
+    // Producer line.
+    std::atomic<uint32_t> tail;
+    uint32_t cachedHead;
+    uint8_t padding1[kCacheLineSize - sizeof(std::atomic<uint32_t>) - sizeof(uint32_t)];
+
+    T *items;
+    uint32_t mask;
+    Allocator *allocator;
+
+    T* AcquirePushSlot(uint32_t &t);
+public:
+    SPSCQueue(Allocator &_allocator, uint32_t capacity);
+    SPSCQueue(const SPSCQueue<T> &other) = delete;
+    ~SPSCQueue();
+
+    SPSCQueue<T>& operator =(const SPSCQueue<T> &other) = delete;
+
+    Allocator& GetAllocator() const;
+    uint32_t Capacity() const;
+    // Exact only when called from the producer or the consumer with the other side idle.
+    uint32_t Count() const;
+    bool IsEmpty() const;
+
+    // Producer side, false when full.
+    bool TryPush(const T &item);
+    bool TryPush(T &&item);
+
+    // Consumer side, false when empty.
+    bool TryPop(T &item);
+};
+
+} // namespace Framework
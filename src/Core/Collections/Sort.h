@@ -0,0 +1,355 @@
+#pragma once
+
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include "Core/BitOps.h"
+
+namespace Framework {
+
+// Pattern defeating quicksort, the comparator is a template parameter so it inlines.
+// Trivially copyable types use the branchless block partition.
+namespace Sorting {
+
+static const ptrdiff_t kInsertionSortThreshold = 24;
+static const ptrdiff_t kNintherThreshold = 128;
+static const ptrdiff_t kPartialInsertionSortLimit = 8;
+static const ptrdiff_t kBlockSize = 64;
+
+template <typename T, typename F>
+inline void
+InsertionSort(T *begin, T *end, F &less)
+{
+    if (begin == end)
+        return;
+
+    for (T *cur = begin + 1; cur != end; ++cur) {
+        T *sift = cur, *siftPrev = cur - 1;
+        if (less(*sift, *siftPrev)) {
+            T tmp(std::move(*sift));
+            do {
+                *sift-- = std::move(*siftPrev);
+            } while (sift != begin && less(tmp, *--siftPrev));
+            *sift = std::move(tmp);
+        }
+    }
+}
+
+// Needs an element not greater than any in [begin, end) right before begin.
+template <typename T, typename F>
+inline void
+UnguardedInsertionSort(T *begin, T *end, F &less)
+{
+    if (begin == end)
+        return;
+
+    for (T *cur = begin + 1; cur != end; ++cur) {
+        T *sift = cur, *siftPrev = cur - 1;
+        if (less(*sift, *siftPrev)) {
+            T tmp(std::move(*sift));
+            do {
+                *sift-- = std::move(*siftPrev);
+            } while (less(tmp, *--siftPrev));
+            *sift = std::move(tmp);
+        }
+    }
+}
+
+// Gives up once more than kPartialInsertionSortLimit elements were moved.
+template <typename T, typename F>
+inline bool
+PartialInsertionSort(T *begin, T *end, F &less)
+{
+    if (begin == end)
+        return true;
+
+    ptrdiff_t limit = 0;
+    for (T *cur = begin + 1; cur != end; ++cur) {
+        T *sift = cur, *siftPrev = cur - 1;
+        if (less(*sift, *siftPrev)) {
+            T tmp(std::move(*sift));
+            do {
+                *sift-- = std::move(*siftPrev);
+            } while (sift != begin && less(tmp, *--siftPrev));
+            *sift = std::move(tmp);
+            limit += cur - sift;
+        }
+
+        if (limit > kPartialInsertionSortLimit)
+            return false;
+    }
+    return true;
+}
+
+template <typename T, typename F>
+inline void
+Sort2(T *a, T *b, F &less)
+{
+    if (less(*b, *a))
+        std::iter_swap(a, b);
+}
+
+template <typename T, typename F>
+inline void
+Sort3(T *a, T *b, T *c, F &less)
+{
+    Sort2(a, b, less);
+    Sort2(b, c, less);
+    Sort2(a, b, less);
+}
+
+template <typename T>
+inline void
+SwapOffsets(T *first, T *last, const uint8_t *offsetsL, const uint8_t *offsetsR, size_t count, bool useSwaps)
+{
+    if (useSwaps) {
+        // Both blocks have the same size, a cyclic permutation would leave one element behind.
+        for (size_t i = 0; i < count; ++i)
+            std::iter_swap(first + offsetsL[i], last - offsetsR[i]);
+    } else if (count > 0) {
+        T *l = first + offsetsL[0], *r = last - offsetsR[0];
+        T tmp(std::move(*l));
+        *l = std::move(*r);
+        for (size_t i = 1; i < count; ++i) {
+            l = first + offsetsL[i];
+            *r = std::move(*l);
+            r = last - offsetsR[i];
+            *l = std::move(*r);
+        }
+        *r = std::move(tmp);
+    }
+}
+
+// Elements equal to the pivot go right, the pivot is *begin.
+template <typename T, typename F>
+inline T*
+PartitionRight(T *begin, T *end, F &less, bool &alreadyPartitioned, std::false_type)
+{
+    T pivot(std::move(*begin));
+    T *first = begin, *last = end;
+
+    // Median of 3 guarantees an element >= pivot before end.
+    while (less(*++first, pivot));
+
+    if (first - 1 == begin)
+        while (first < last && !less(*--last, pivot));
+    else
+        while (!less(*--last, pivot));
+
+    alreadyPartitioned = first >= last;
+
+    while (first < last) {
+        std::iter_swap(first, last);
+        while (less(*++first, pivot));
+        while (!less(*--last, pivot));
+    }
+
+    T *pivotPos = first - 1;
+    *begin = std::move(*pivotPos);
+    *pivotPos = std::move(pivot);
+    return pivotPos;
+}
+
+// BlockQuicksort, comparisons only write offsets so there are no mispredicted branches.
+template <typename T, typename F>
+inline T*
+PartitionRight(T *begin, T *end, F &less, bool &alreadyPartitioned, std::true_type)
+{
+    T pivot(std::move(*begin));
+    T *first = begin, *last = end;
+
+    while (less(*++first, pivot));
+
+    if (first - 1 == begin)
+        while (first < last && !less(*--last, pivot));
+    else
+        while (!less(*--last, pivot));
+
+    alreadyPartitioned = first >= last;
+
+    if (!alreadyPartitioned) {
+        std::iter_swap(first, last);
+        ++first;
+
+        uint8_t offsetsL[kBlockSize], offsetsR[kBlockSize];
+        T *offsetsLBase = first, *offsetsRBase = last;
+        size_t numL = 0, numR = 0, startL = 0, startR = 0;
+
+        while (first < last) {
+            size_t numUnknown = last - first,
+                   leftSplit = 0 == numL ? (0 == numR ? numUnknown / 2 : numUnknown) : 0,
+                   rightSplit = 0 == numR ? numUnknown - leftSplit : 0;
+
+            size_t countL = leftSplit < size_t(kBlockSize) ? leftSplit : kBlockSize;
+            for (size_t i = 0; i < countL; ++i) {
+                offsetsL[numL] = uint8_t(i);
+                numL += !less(*first, pivot);
+                ++first;
+            }
+
+            size_t countR = rightSplit < size_t(kBlockSize) ? rightSplit : kBlockSize;
+            for (size_t i = 1; i <= countR; ++i) {
+                offsetsR[numR] = uint8_t(i);
+                numR += less(*--last, pivot);
+            }
+
+            size_t num = numL < numR ? numL : numR;
+            SwapOffsets(offsetsLBase, offsetsRBase, offsetsL + startL, offsetsR + startR, num, numL == numR);
+            numL -= num; numR -= num;
+            startL += num; startR += num;
+
+            if (0 == numL) {
+                startL = 0;
+                offsetsLBase = first;
+            }
+            if (0 == numR) {
+                startR = 0;
+                offsetsRBase = last;
+            }
+        }
+
+        // At most one block has leftovers, move them next to the partition point.
+        if (numL > 0) {
+            while (numL--)
+                std::iter_swap(offsetsLBase + offsetsL[startL + numL], --last);
+            first = last;
+        }
+        if (numR > 0) {
+            while (numR--)
+                std::iter_swap(offsetsRBase - offsetsR[startR + numR], first), ++first;
+            last = first;
+        }
+    }
+
+    T *pivotPos = first - 1;
+    *begin = std::move(*pivotPos);
+    *pivotPos = std::move(pivot);
+    return pivotPos;
+}
+
+// Elements equal to the pivot go left, used when the pivot equals the element before the range.
+template <typename T, typename F>
+inline T*
+PartitionLeft(T *begin, T *end, F &less)
+{
+    T pivot(std::move(*begin));
+    T *first = begin, *last = end;
+
+    while (less(pivot, *--last));
+
+    if (last + 1 == end)
+        while (first < last && !less(pivot, *++first));
+    else
+        while (!less(pivot, *++first));
+
+    while (first < last) {
+        std::iter_swap(first, last);
+        while (less(pivot, *--last));
+        while (!less(pivot, *++first));
+    }
+
+    T *pivotPos = last;
+    *begin = std::move(*pivotPos);
+    *pivotPos = std::move(pivot);
+    return pivotPos;
+}
+
+template <typename T, typename F>
+inline void
+PdqSortLoop(T *begin, T *end, F &less, int badAllowed, bool leftmost)
+{
+    typedef std::integral_constant<bool, std::is_trivially_copyable<T>::value> Branchless;
+
+    for (;;) {
+        ptrdiff_t size = end - begin;
+
+        if (size < kInsertionSortThreshold) {
+            if (leftmost)
+                InsertionSort(begin, end, less);
+            else
+                UnguardedInsertionSort(begin, end, less);
+            return;
+        }
+
+        // Pivot goes to *begin.
+        ptrdiff_t half = size / 2;
+        if (size > kNintherThreshold) {
+            Sort3(begin, begin + half, end - 1, less);
+            Sort3(begin + 1, begin + (half - 1), end - 2, less);
+            Sort3(begin + 2, begin + (half + 1), end - 3, less);
+            Sort3(begin + (half - 1), begin + half, begin + (half + 1), less);
+            std::iter_swap(begin, begin + half);
+        } else {
+            Sort3(begin + half, begin, end - 1, less);
+        }
+
+        // Lots of equal elements, put them all left of the pivot and skip them.
+        if (!leftmost && !less(*(begin - 1), *begin)) {
+            begin = PartitionLeft(begin, end, less) + 1;
+            continue;
+        }
+
+        bool alreadyPartitioned;
+        T *pivotPos = PartitionRight(begin, end, less, alreadyPartitioned, Branchless());
+
+        ptrdiff_t sizeL = pivotPos - begin,
+                  sizeR = end - (pivotPos + 1);
+
+        if (sizeL < size / 8 || sizeR < size / 8) {
+            // Unbalanced, fall back to heap sort if it keeps happening.
+            if (--badAllowed == 0) {
+                std::make_heap(begin, end, less);
+                std::sort_heap(begin, end, less);
+                return;
+            }
+
+            // Break patterns that could lead to quadratic behaviour.
+            if (sizeL >= kInsertionSortThreshold) {
+                std::iter_swap(begin, begin + sizeL / 4);
+                std::iter_swap(pivotPos - 1, pivotPos - sizeL / 4);
+                if (sizeL > kNintherThreshold) {
+                    std::iter_swap(begin + 1, begin + (sizeL / 4 + 1));
+                    std::iter_swap(begin + 2, begin + (sizeL / 4 + 2));
+                    std::iter_swap(pivotPos - 2, pivotPos - (sizeL / 4 + 1));
+                    std::iter_swap(pivotPos - 3, pivotPos - (sizeL / 4 + 2));
+                }
+            }
+            if (sizeR >= kInsertionSortThreshold) {
+                std::iter_swap(pivotPos + 1, pivotPos + (1 + sizeR / 4));
+                std::iter_swap(end - 1, end - sizeR / 4);
+                if (sizeR > kNintherThreshold) {
+                    std::iter_swap(pivotPos + 2, pivotPos + (2 + sizeR / 4));
+                    std::iter_swap(pivotPos + 3, pivotPos + (3 + sizeR / 4));
+                    std::iter_swap(end - 2, end - (1 + sizeR / 4));
+                    std::iter_swap(end - 3, end - (2 + sizeR / 4));
+                }
+            }
+        } else if (alreadyPartitioned &&
+                   PartialInsertionSort(begin, pivotPos, less) &&
+                   PartialInsertionSort(pivotPos + 1, end, less))
+        {
+            // Nothing was swapped, the input was probably sorted already.
+            return;
+        }
+
+        // Recurse into the left side, loop on the right one.
+        PdqSortLoop(begin, pivotPos, less, badAllowed, leftmost);
+        begin = pivotPos + 1;
+        leftmost = false;
+    }
+}
+
+template <typename T, typename F>
+inline void
+Sort(T *begin, T *end, F less)
+{
+    if (end - begin < 2)
+        return;
+
+    PdqSortLoop(begin, end, less, FindLastSet(uint64_t(end - begin)), true);
+}
+
+} // namespace Sorting
+
+} // namespace Framework
@@ -36,6 +36,7 @@ BitStream::BitStream(BitStream &&stream)
         Memory::Copy(buffer, stream.buffer, BufferSize);
     else
         data = stream.data;
+    this->SetRelocationHandle();
 
     stream.bitsUsed      = 0;
     stream.bitsAllocated = BytesToBits(BufferSize);
@@ -59,6 +60,7 @@ BitStream::BitStream(Allocator &_allocator, size_t initialSize)
         bitsReadPos   = 0;
         copyData      = false;
         data          = static_cast<unsigned char*>(allocator->Allocate(initialSize, 1));
+        this->SetRelocationHandle();
     }
 }
 
@@ -81,6 +83,7 @@ BitStream::BitStream(Allocator &_allocator, const void *_data, size_t dataLength
         else
             data = static_cast<unsigned char*>(const_cast<void*>(_data));
     }
+    this->SetRelocationHandle();
 
     if (copyData)
         Memory::Copy(static_cast<void*>(data), _data, dataLength);
@@ -116,6 +119,7 @@ BitStream::operator =(BitStream &&stream)
         Memory::Copy(buffer, stream.buffer, BufferSize);
     else
         data = stream.data;
+    this->SetRelocationHandle();
 
     stream.bitsUsed      = 0;
     stream.bitsAllocated = BytesToBits(BufferSize);
@@ -137,6 +141,13 @@ BitStream::Realloc(size_t newSize)
 
     copyData = true;
 
+    if (oldCopyData && oldData != buffer) {
+        bitsAllocated = BytesToBits(newSize);
+        data          = static_cast<unsigned char*>(allocator->Reallocate(oldData, oldSize, newSize, 1));
+        this->SetRelocationHandle();
+        return;
+    }
+
     if (newSize <= BufferSize) {
         bitsAllocated = BytesToBits(BufferSize);
         data          = buffer;
@@ -147,11 +158,20 @@ BitStream::Realloc(size_t newSize)
     
     if (data != oldData)
         Memory::Copy(data, oldData, newSize < oldSize ? newSize : oldSize);
+    this->SetRelocationHandle();
 
     if (oldCopyData && oldData != buffer)
         allocator->Free(oldData);
 }
 
+void
+BitStream::SetRelocationHandle()
+{
+    // Heap data can be moved by a compacting allocator, it patches data through this handle.
+    if (copyData && data != buffer)
+        allocator->SetRelocationHandle(data, reinterpret_cast<void**>(&data));
+}
+
 void
 BitStream::ReserveBits(BitSize numBits)
 {
@@ -313,6 +333,7 @@ BitStream::Fill(const void *_data, size_t dataLength, bool _copyData)
         else
             data = static_cast<unsigned char*>(const_cast<void*>(_data));
     }
+    this->SetRelocationHandle();
 
     if (copyData)
         Memory::Copy(static_cast<void*>(data), _data, dataLength);
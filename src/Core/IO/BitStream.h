@@ -37,6 +37,7 @@ private:
     unsigned char buffer[BufferSize];
 
     void Realloc(size_t newSize);
+    void SetRelocationHandle();
     void ReserveBits(BitSize numBits);
     void ReserveBytes(size_t numBytes);
 
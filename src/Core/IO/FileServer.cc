@@ -1,6 +1,6 @@
 #include <cstdio>
 #include "Core/IO/FileServer.h"
-#include "Core/Collections/Dictionary.h"
+#include "Core/Collections/FlatMap.h"
 #include "Core/IO/BitStream.h"
 #include "Core/Memory/MallocAllocator.h"
 #include "Core/Log.h"
@@ -53,12 +53,13 @@ FileServer::ResolvePath(const String &path) const
     if (-1 == index)
         return path;
 
-    String alias = path.Substring(0, index),
-           output;
+    String output;
 
-    // replace alias with path
-    if (!alias.IsEmpty()) {
-        output = this->GetAliasPath(alias);
+    // replace alias with path, the alias is looked up in place
+    if (index > 0) {
+        StringHash alias(StringHash::Compute(path.AsCString(), index), index, path.AsCString());
+        assert(aliases.Contains(alias));
+        output = aliases[alias];
         ++index;
         if (index < path.Length())
             output.Append(path.Substring(index, path.Length() - index));
@@ -2,7 +2,7 @@
 
 #include "Core/Singleton.h"
 #include "Core/String.h"
-#include "Core/Collections/Dictionary_type.h"
+#include "Core/Collections/FlatMap_type.h"
 
 namespace Framework {
 
@@ -11,7 +11,7 @@ class BitStream;
 class FileServer : public Singleton<FileServer> {
     DeclareClassInfo;
 private:
-    Dictionary<String, String> aliases;
+    FlatMap<String, String> aliases;
 public:
     FileServer();
     FileServer(const FileServer &other) = delete;
@@ -1,4 +1,6 @@
+#include <cstring>
 #include "Core/Memory/Allocator.h"
+#include "Core/Memory/MemoryStats.h"
 #include "Core/Collections/List.h"
 
 namespace Framework {
@@ -6,6 +8,12 @@ namespace Framework {
 DefineRootAbstractClassInfo(Framework::Allocator);
 
 Allocator::Allocator()
+: allocCount(0),
+  freeCount(0),
+  bytesInUse(0),
+  peakBytes(0),
+  frameAllocCount(0),
+  lastFrameAllocCount(0)
 { }
 
 Allocator::~Allocator()
@@ -20,4 +28,97 @@ Allocator::operator =(const Allocator &other)
     return (*this);
 }
 
+bool
+Allocator::TryExpand(void *pointer, size_t oldSize, size_t newSize)
+{
+    return false;
+}
+
+void*
+Allocator::Reallocate(void *pointer, size_t oldSize, size_t newSize, size_t align)
+{
+    if (nullptr == pointer)
+        return this->Allocate(newSize, align);
+
+    if (0 == newSize) {
+        this->Free(pointer);
+        return nullptr;
+    }
+
+    if (this->TryExpand(pointer, oldSize, newSize))
+        return pointer;
+
+    void *newPointer = this->Allocate(newSize, align);
+    memcpy(newPointer, pointer, oldSize < newSize ? oldSize : newSize);
+    this->Free(pointer);
+
+    return newPointer;
+}
+
+void
+Allocator::SetRelocationHandle(void *pointer, void **handle)
+{ }
+
+size_t
+Allocator::GetTotalAllocated()
+{
+    return bytesInUse.load(std::memory_order_relaxed);
+}
+
+size_t
+Allocator::GetReservedSize()
+{
+    return this->GetTotalAllocated();
+}
+
+void
+Allocator::GetStats(AllocatorStats &stats)
+{
+    stats.allocCount      = allocCount.load(std::memory_order_relaxed);
+    stats.freeCount       = freeCount.load(std::memory_order_relaxed);
+    stats.bytesInUse      = this->GetTotalAllocated();
+    stats.peakBytes       = peakBytes.load(std::memory_order_relaxed);
+    stats.reservedBytes   = this->GetReservedSize();
+    stats.frameAllocCount = lastFrameAllocCount;
+}
+
+void
+Allocator::NewFrame()
+{
+    lastFrameAllocCount = frameAllocCount.exchange(0, std::memory_order_relaxed);
+}
+
+void
+Allocator::TrackAllocation(size_t size)
+{
+    allocCount.fetch_add(1, std::memory_order_relaxed);
+    frameAllocCount.fetch_add(1, std::memory_order_relaxed);
+
+    size_t inUse = bytesInUse.fetch_add(size, std::memory_order_relaxed) + size,
+           peak  = peakBytes.load(std::memory_order_relaxed);
+    while (inUse > peak && !peakBytes.compare_exchange_weak(peak, inUse, std::memory_order_relaxed));
+
+    Memory::TrackTaggedAllocation(size);
+}
+
+void
+Allocator::TrackFree(size_t size)
+{
+    freeCount.fetch_add(1, std::memory_order_relaxed);
+    bytesInUse.fetch_sub(size, std::memory_order_relaxed);
+}
+
+void
+Allocator::TrackResize(size_t oldSize, size_t newSize)
+{
+    if (newSize < oldSize) {
+        bytesInUse.fetch_sub(oldSize - newSize, std::memory_order_relaxed);
+        return;
+    }
+
+    size_t inUse = bytesInUse.fetch_add(newSize - oldSize, std::memory_order_relaxed) + (newSize - oldSize),
+           peak  = peakBytes.load(std::memory_order_relaxed);
+    while (inUse > peak && !peakBytes.compare_exchange_weak(peak, inUse, std::memory_order_relaxed));
+}
+
 } // namespace Framework
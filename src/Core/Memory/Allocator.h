@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <cstdlib>
 
@@ -10,6 +11,17 @@ namespace Framework {
 
 const uint8_t kPaddingValue = 0xfe;
 
+struct AllocatorStats {
+    uint64_t allocCount;
+    uint64_t freeCount;
+    size_t   bytesInUse;
+    size_t   peakBytes;
+    size_t   reservedBytes;   // held from the base allocator or the OS
+    uint32_t frameAllocCount; // allocations during the last completed frame
+
+    float GetFragmentation() const;
+};
+
 class Allocator {
     DeclareRootClassInfo;
 public:
@@ -21,9 +33,33 @@ public:
     virtual void* Allocate(size_t size, size_t align) = 0;
     virtual void Free(void *pointer) = 0;
 
+    // Grows or shrinks a block without moving it, returns false if the caller has to move it.
+    virtual bool TryExpand(void *pointer, size_t oldSize, size_t newSize);
+    // Resizes a block keeping its first min(oldSize, newSize) bytes, they are moved with
+    // memcpy when the block can't be resized in place.
+    virtual void* Reallocate(void *pointer, size_t oldSize, size_t newSize, size_t align);
+    // Lets a compacting allocator move the block, the pointer stored at handle is patched
+    // when it does. Has to be set again whenever the handle itself moves, nullptr pins the block.
+    virtual void SetRelocationHandle(void *pointer, void **handle);
+
     virtual size_t GetAllocatedSize(void *pointer) = 0;
-    virtual size_t GetTotalAllocated() = 0;
+    virtual size_t GetTotalAllocated();
+    virtual size_t GetReservedSize();
+
+    virtual void GetStats(AllocatorStats &stats);
+    virtual void NewFrame();
 protected:
+    std::atomic<uint64_t> allocCount;
+    std::atomic<uint64_t> freeCount;
+    std::atomic<size_t>   bytesInUse;
+    std::atomic<size_t>   peakBytes;
+    std::atomic<uint32_t> frameAllocCount;
+    uint32_t              lastFrameAllocCount;
+
+    void TrackAllocation(size_t size);
+    void TrackFree(size_t size);
+    void TrackResize(size_t oldSize, size_t newSize);
+
     template <typename H>
     static H* GetPointerFromData(void *data)
     {
@@ -88,14 +124,21 @@ private:
     Allocator& operator =(const Allocator &other);
 };
 
+inline float
+AllocatorStats::GetFragmentation() const
+{
+    return 0 == reservedBytes ? 0.0f : 1.0f - float(bytesInUse) / float(reservedBytes);
+}
+
     namespace Memory {
 
-void* GetAllocatorMemory(size_t size);
+void* GetAllocatorMemory(size_t size, size_t align);
 void InitAllocatorMemory(Allocator *pointer);
+const List<Allocator, &Allocator::node>& GetAllocators();
 
 template <typename A, typename ...Args> void InitAllocator(Args... params)
 {
-    A::__instance = static_cast<A*>(Memory::GetAllocatorMemory(sizeof(A)));
+    A::__instance = static_cast<A*>(Memory::GetAllocatorMemory(sizeof(A), __alignof(A)));
     new(A::__instance) A(params...);
     Memory::InitAllocatorMemory(A::__instance);
 }
@@ -1,113 +1,118 @@
 #include "Core/Memory/BlocksAllocator.h"
+#include "Core/BitOps.h"
 
 namespace Framework {
-        
+
 DefineClassInfo(Framework::BlocksAllocator, Framework::Allocator);
 DefineAllocator(Framework::BlocksAllocator);
 
-BlocksAllocator::Page*
-BlocksAllocator::AllocateNewPage(uint32_t blockSize)
-{/*
-    assert(blockSize <= pageSize);
-    uint32_t numBlocks = pageSize / blockSize,
-             numFlags  = (numBlocks / 32) + (numBlocks % 32 > 0 ? 1 : 0);
-
-    uint32_t newPageSize = sizeof(Page) + numFlags * 4;
-    newPageSize += (numBlocks * blockSize);
-*/
-    assert(blockSize < pageSize);
-    uint32_t numBlocks = pageSizeNoHeader / blockSize,
-             numFlags  = (numBlocks / 32) + (numBlocks % 32 > 0 ? 1 : 0);
-
-    uint32_t newPageSize = sizeof(Page) + numFlags * 4;
-    newPageSize += (numBlocks * blockSize);
-    /*if*/while (newPageSize > pageSize) {
-        --numBlocks;
-        newPageSize -= blockSize;
-        //assert((newPageSize - blockSize) <= pageSize);
-    }
+static const uintptr_t kBlocksAlign = 16;
 
-    Page *newPage = static_cast<Page*>(baseAllocator->Allocate(pageSize, 1));//newPageSize));
-    newPage->blockSize = blockSize;
-    newPage->freeBlocks = numBlocks;
-    newPage->usedBlocks = 0;
-    newPage->next = firstPage;
-    firstPage = newPage;
+inline uint32_t*
+BlocksAllocator::GetFlags(Page *page) const
+{
+    return (uint32_t*)(uintptr_t(page) + sizeof(Page));
+}
 
-    uint32_t *it  = (uint32_t*)(uintptr_t(newPage) + sizeof(Page)),
-             *end = it + numFlags;
+inline uintptr_t
+BlocksAllocator::GetBlocks(Page *page) const
+{
+    uintptr_t flagsEnd = uintptr_t(page) + sizeof(Page) + page->numFlags * 4;
+    return (flagsEnd + kBlocksAlign - 1) & ~(kBlocksAlign - 1);
+}
 
-    for (; it < end; ++it)
-        *it = 0xffffffff;
+BlocksAllocator::Page*
+BlocksAllocator::AllocateNewPage(uint32_t sizeClass)
+{
+    Page *newPage = static_cast<Page*>(baseAllocator->Allocate(pageSize, kBlocksAlign));
+    newPage->nextPage = firstPage;
+    firstPage = newPage;
+    reservedSize += pageSize;
 
-    return newPage;
+    return this->RefitPage(newPage, sizeClass);
 }
 
 BlocksAllocator::Page*
-BlocksAllocator::RefitPage(Page *page, uint32_t blockSize)
-{
-    assert(0 == page->usedBlocks);
-    assert(blockSize < pageSize);
-    uint32_t numBlocks = pageSizeNoHeader / blockSize,
-             numFlags  = (numBlocks / 32) + (numBlocks % 32 > 0 ? 1 : 0);
-
-    uint32_t newPageSize = sizeof(Page) + numFlags * 4;
-    newPageSize += (numBlocks * blockSize);
-    if (newPageSize > pageSize) {
-        --numBlocks;
-        assert((newPageSize - blockSize) <= pageSize);
-    }
+BlocksAllocator::RefitPage(Page *page, uint32_t sizeClass)
+{
+    uint32_t blockSize = Memory::GetSizeClassBlockSize(sizeClass);
+    assert(blockSize <= pageSizeNoHeader);
 
     page->blockSize = blockSize;
-    page->freeBlocks = numBlocks;
+    page->sizeClass = sizeClass;
+    page->numBlocks = (pageSize - sizeof(Page)) / blockSize;
+    page->numFlags = (page->numBlocks + 31) >> 5;
+    while (GetBlocks(page) + page->numBlocks * blockSize > uintptr_t(page) + pageSize) {
+        --page->numBlocks;
+        page->numFlags = (page->numBlocks + 31) >> 5;
+    }
+    assert(page->numBlocks > 0);
+    page->freeBlocks = page->numBlocks;
+    page->firstFreeFlag = 0;
 
-    uint32_t *it  = (uint32_t*)(uintptr_t(page) + sizeof(Page)),
-             *end = it + numFlags;
+    uint32_t *it  = this->GetFlags(page),
+             *end = it + page->numFlags;
 
     for (; it < end; ++it)
         *it = 0xffffffff;
+    if (page->numBlocks & 31)
+        *(end - 1) = (1u << (page->numBlocks & 31)) - 1;
+
+    this->PushPage(page);
 
     return page;
 }
 
+inline void
+BlocksAllocator::PushPage(Page *page)
+{
+    Page *&head = freeLists[page->sizeClass];
+    page->prev = nullptr;
+    page->next = head;
+    if (head != nullptr)
+        head->prev = page;
+    head = page;
+}
+
+inline void
+BlocksAllocator::UnlinkPage(Page *page)
+{
+    if (nullptr == page->prev)
+        freeLists[page->sizeClass] = page->next;
+    else
+        page->prev->next = page->next;
+
+    if (page->next != nullptr)
+        page->next->prev = page->prev;
+
+    page->prev = page->next = nullptr;
+}
+
 BlocksAllocator::Header*
 BlocksAllocator::AllocateNewBlock(Page *page)
 {
     assert(page->freeBlocks > 0);
-    --page->freeBlocks;
-    ++page->usedBlocks;
-
-    uint32_t numBlocks = pageSizeNoHeader / page->blockSize,
-             numFlags  = (numBlocks / 32) + (numBlocks % 32 > 0 ? 1 : 0);
-
-    uint32_t *it  = (uint32_t*)(uintptr_t(page) + sizeof(Page)),
-             *end = it + numFlags;
-
-    int blockIndex = 0, offset;
-    bool found = false;
-    for (; it < end; ++it) {
-        for (offset = 0; offset < 32; ++offset) {
-            if ((1 << offset) & *it) {
-                found = true;
-                break;
-            }
-        }
-
-        if (found) {
-            blockIndex += offset;
-            *it &= ~(1 << offset);
-            break;
-        }
-
-        blockIndex += 32;
-    }
 
-    assert(found && blockIndex < numBlocks);
+    uint32_t *flags = this->GetFlags(page),
+             flagIndex = page->firstFreeFlag;
+    while (0 == flags[flagIndex])
+        ++flagIndex;
+    assert(flagIndex < page->numFlags);
+
+    uint32_t offset = CountTrailingZeros(flags[flagIndex]);
+    flags[flagIndex] &= ~(1u << offset);
+    page->firstFreeFlag = flagIndex;
 
-    Header *header = (Header*)(uintptr_t(end) + uintptr_t(page->blockSize) * uintptr_t(blockIndex));
+    uint32_t blockIndex = (flagIndex << 5) + offset;
+    assert(blockIndex < page->numBlocks);
+
+    if (0 == --page->freeBlocks)
+        this->UnlinkPage(page);
+
+    Header *header = (Header*)(this->GetBlocks(page) + uintptr_t(page->blockSize) * blockIndex);
     header->page = page;
 
-    totalAllocated += page->blockSize;
+    this->TrackAllocation(page->blockSize);
 
     assert((uintptr_t(header) + uintptr_t(page->blockSize) - uintptr_t(page)) <= pageSize);
 
@@ -117,51 +122,44 @@ BlocksAllocator::AllocateNewBlock(Page *page)
 void
 BlocksAllocator::DeallocateBlock(Header *block)
 {
-    assert(block->page->usedBlocks > 0);
-    ++block->page->freeBlocks;
-    --block->page->usedBlocks;
-
-    uint32_t numBlocks = pageSizeNoHeader / block->page->blockSize,
-             numFlags  = (numBlocks / 32) + (numBlocks % 32 > 0 ? 1 : 0);
-
-    uint32_t *it  = (uint32_t*)(uintptr_t(block->page) + sizeof(Page)),
-             *end = it + numFlags;
-
-    uint32_t blockIndex = (uintptr_t(block) - uintptr_t(end)) / block->page->blockSize;
-    assert(0 == ((uintptr_t(block) - uintptr_t(end)) % block->page->blockSize));
-
-    while (blockIndex >= 32) {
-        ++it;
-        blockIndex -= 32;
+    Page *page = block->page;
+    assert(page->freeBlocks < page->numBlocks);
+
+    uintptr_t blockOffset = uintptr_t(block) - this->GetBlocks(page);
+    uint32_t blockIndex = uint32_t(blockOffset / page->blockSize),
+             flagIndex  = blockIndex >> 5,
+             flagBit    = 1u << (blockIndex & 31);
+    assert(0 == (blockOffset % page->blockSize));
+
+    uint32_t *flags = this->GetFlags(page);
+    assert(flagIndex < page->numFlags && 0 == (flags[flagIndex] & flagBit));
+    flags[flagIndex] |= flagBit;
+    if (flagIndex < page->firstFreeFlag)
+        page->firstFreeFlag = flagIndex;
+
+    this->TrackFree(page->blockSize);
+
+    if (1 == ++page->freeBlocks) {
+        this->PushPage(page);
+    } else if (page->freeBlocks == page->numBlocks && (page->prev != nullptr || page->next != nullptr)) {
+        // Keep the last page of a size class around, hand the others back for refitting.
+        this->UnlinkPage(page);
+        page->next = emptyPages;
+        emptyPages = page;
     }
-
-    assert(it < end && 0 == (*it & (1 << blockIndex)));
-    *it |= (1 << blockIndex);
-
-    totalAllocated -= block->page->blockSize;
 }
 
 BlocksAllocator::Page*
-BlocksAllocator::FindPage(uint32_t blockSize)
+BlocksAllocator::FindPage(uint32_t sizeClass)
 {
-    Page *page = firstPage, *blankPage = nullptr;
-    while (page != nullptr) {
-        if (page->freeBlocks > 0 && page->blockSize == blockSize)
-            return page;
-        if (nullptr == blankPage && 0 == page->usedBlocks)
-            blankPage = page;
-        page = page->next;
-    }
-
-    if (nullptr == blankPage) {
-        page = firstPage;
-        while (page != nullptr) {
-            if (page->freeBlocks > 0 && page->blockSize >= blockSize && page->blockSize <= blockSize * 2)
-                return page;
-            page = page->next;
-        }
-    } else {
-        return this->RefitPage(blankPage, blockSize);
+    Page *page = freeLists[sizeClass];
+    if (page != nullptr)
+        return page;
+
+    if (emptyPages != nullptr) {
+        page = emptyPages;
+        emptyPages = page->next;
+        return this->RefitPage(page, sizeClass);
     }
 
     return nullptr;
@@ -170,18 +168,28 @@ BlocksAllocator::FindPage(uint32_t blockSize)
 BlocksAllocator::BlocksAllocator(Allocator *allocator, uint32_t _pageSize)
 : baseAllocator(allocator),
   pageSize(_pageSize),
-  pageSizeNoHeader(_pageSize - sizeof(Page) - 4),
+  pageSizeNoHeader(_pageSize - uint32_t((sizeof(Page) + 4 + kBlocksAlign - 1) & ~(kBlocksAlign - 1))),
+  maxBlockSize(0),
   firstPage(nullptr),
-  totalAllocated(0)
-{ }
+  emptyPages(nullptr),
+  reservedSize(0)
+{
+    for (uint32_t i = 0; i < Memory::kNumSizeClasses; ++i)
+        freeLists[i] = nullptr;
+
+    uint32_t sizeClass = Memory::GetSizeClass(pageSizeNoHeader);
+    maxBlockSize = Memory::GetSizeClassBlockSize(sizeClass);
+    if (maxBlockSize > pageSizeNoHeader)
+        maxBlockSize = Memory::GetSizeClassBlockSize(sizeClass - 1);
+}
 
 BlocksAllocator::~BlocksAllocator()
 {
     Page *page = firstPage, *tmp;
     while (page != nullptr) {
         tmp = page;
-        page = page->next;
-        assert(0 == tmp->usedBlocks);
+        page = page->nextPage;
+        assert(tmp->freeBlocks == tmp->numBlocks);
         baseAllocator->Free(tmp);
     }
 }
@@ -193,11 +201,25 @@ BlocksAllocator::Allocate(size_t size, size_t align)
 
     size_t ts = Allocator::GetAlignedSize<Header>(size, align);
 
-    Page *page = this->FindPage(ts);
-    if (nullptr == page)
-        page = this->AllocateNewPage(ts);
+    Header *h = nullptr;
+    if (ts > maxBlockSize) {
+        // Too big for a page, goes straight to the base allocator.
+        h = static_cast<Header*>(baseAllocator->Allocate(ts, __alignof(Header)));
+        h->page = nullptr;
+
+        size_t blockSize = baseAllocator->GetAllocatedSize(h);
+        reservedSize += blockSize;
+        this->TrackAllocation(blockSize);
+    } else {
+        uint32_t sizeClass = Memory::GetSizeClass(uint32_t(ts));
+
+        Page *page = this->FindPage(sizeClass);
+        if (nullptr == page)
+            page = this->AllocateNewPage(sizeClass);
+
+        h = this->AllocateNewBlock(page);
+    }
 
-    Header *h = this->AllocateNewBlock(page);
     d = Allocator::GetDataFromPointer<Header>(h, align);
 
     Allocator::FillPadding(h, d);
@@ -212,19 +234,40 @@ BlocksAllocator::Free(void *pointer)
         return;
 
     Header *h = Allocator::GetPointerFromData<Header>(pointer);
-    this->DeallocateBlock(h);
+    if (nullptr == h->page) {
+        size_t blockSize = baseAllocator->GetAllocatedSize(h);
+        reservedSize -= blockSize;
+        this->TrackFree(blockSize);
+        baseAllocator->Free(h);
+    } else {
+        this->DeallocateBlock(h);
+    }
+}
+
+bool
+BlocksAllocator::TryExpand(void *pointer, size_t oldSize, size_t newSize)
+{
+    // Only within the block, the size class doesn't change.
+    Header *h = Allocator::GetPointerFromData<Header>(pointer);
+    if (nullptr == h->page)
+        return false;
+    return (uintptr_t(pointer) - uintptr_t(h)) + newSize <= h->page->blockSize;
 }
 
 size_t
 BlocksAllocator::GetAllocatedSize(void *pointer)
 {
-    return Allocator::GetPointerFromData<Header>(pointer)->page->blockSize;
+    Header *h = Allocator::GetPointerFromData<Header>(pointer);
+    if (nullptr == h->page)
+        return baseAllocator->GetAllocatedSize(h);
+    else
+        return h->page->blockSize;
 }
 
 size_t
-BlocksAllocator::GetTotalAllocated()
+BlocksAllocator::GetReservedSize()
 {
-    return totalAllocated;
+    return reservedSize;
 }
 
 } // namespace Framework
@@ -2,18 +2,24 @@
 
 #include "Core/Memory/Memory.h"
 #include "Core/Memory/Allocator.h"
+#include "Core/Memory/SizeClass.h"
 
 namespace Framework {
-        
+
 class BlocksAllocator : public Allocator {
     DeclareClassInfo;
     DeclareAllocator(BlocksAllocator);
 private:
     struct Page {
         uint32_t blockSize;
-        uint16_t freeBlocks;
-        uint16_t usedBlocks;
+        uint32_t sizeClass;
+        uint32_t numBlocks;
+        uint32_t freeBlocks;
+        uint32_t numFlags;
+        uint32_t firstFreeFlag;
+        Page     *prev;     // size class free list
         Page     *next;
+        Page     *nextPage; // every page owned by the allocator
     };
 
     struct Header {
@@ -23,14 +29,22 @@ private:
     Allocator *baseAllocator;
     uint32_t pageSize;
     uint32_t pageSizeNoHeader;
+    uint32_t maxBlockSize;
     Page *firstPage;
-    uint32_t totalAllocated;
+    Page *emptyPages;
+    Page *freeLists[Memory::kNumSizeClasses];
+    size_t reservedSize;
+
+    uint32_t* GetFlags(Page *page) const;
+    uintptr_t GetBlocks(Page *page) const;
 
-    Page* AllocateNewPage(uint32_t blockSize);
-    Page* RefitPage(Page *page, uint32_t blockSize);
+    Page* AllocateNewPage(uint32_t sizeClass);
+    Page* RefitPage(Page *page, uint32_t sizeClass);
+    void PushPage(Page *page);
+    void UnlinkPage(Page *page);
     Header* AllocateNewBlock(Page *page);
     void DeallocateBlock(Header *block);
-    Page* FindPage(uint32_t blockSize);
+    Page* FindPage(uint32_t sizeClass);
 public:
     BlocksAllocator(Allocator *allocator, uint32_t _pageSize);
     virtual ~BlocksAllocator();
@@ -38,8 +52,10 @@ public:
     virtual void* Allocate(size_t size, size_t align);
     virtual void Free(void *pointer);
 
+    virtual bool TryExpand(void *pointer, size_t oldSize, size_t newSize);
+
     virtual size_t GetAllocatedSize(void *pointer);
-    virtual size_t GetTotalAllocated();
+    virtual size_t GetReservedSize();
 };
-        
+
 } // namespace Framework
@@ -0,0 +1,327 @@
+#include "Core/Memory/CompactingAllocator.h"
+
+namespace Framework {
+
+DefineClassInfo(Framework::CompactingAllocator, Framework::Allocator);
+DefineAllocator(Framework::CompactingAllocator);
+
+CompactingAllocator::Chunk*
+CompactingAllocator::AddChunk(size_t minSize)
+{
+    size_t size = kChunkHeaderSize + minSize;
+    if (size < chunkSize)
+        size = chunkSize;
+
+    Chunk *chunk = static_cast<Chunk*>(baseAllocator->Allocate(size, kBlockAlign));
+    chunk->next = nullptr;
+    chunk->top = GetChunkBegin(chunk);
+    chunk->end = (uint8_t*)chunk + size;
+    chunk->used = 0;
+    reservedSize += size;
+
+    // Appended so that allocations keep filling the oldest chunks first and the newer ones can drain.
+    Chunk **last = &firstChunk;
+    while (*last != nullptr)
+        last = &(*last)->next;
+    *last = chunk;
+
+    return chunk;
+}
+
+void
+CompactingAllocator::FreeChunk(Chunk *chunk)
+{
+    Chunk **prev = &firstChunk;
+    while (*prev != chunk)
+        prev = &(*prev)->next;
+    *prev = chunk->next;
+
+    reservedSize -= chunk->end - (uint8_t*)chunk;
+    baseAllocator->Free(chunk);
+}
+
+CompactingAllocator::Chunk*
+CompactingAllocator::FindChunk(Header *block)
+{
+    Chunk *chunk = firstChunk;
+    while (chunk != nullptr && ((uint8_t*)block < (uint8_t*)chunk || (uint8_t*)block >= chunk->end))
+        chunk = chunk->next;
+    assert(chunk != nullptr);
+    return chunk;
+}
+
+CompactingAllocator::Header*
+CompactingAllocator::AllocateBlock(Chunk *chunk, size_t ts)
+{
+    uint8_t *begin = GetChunkBegin(chunk);
+
+    // First fit over the holes, coalescing free runs on the way.
+    if (size_t(chunk->top - begin) - chunk->used >= ts) {
+        Header *block = reinterpret_cast<Header*>(begin);
+        while ((uint8_t*)block < chunk->top) {
+            if (!block->isFree) {
+                block = GetNext(block);
+                continue;
+            }
+
+            Header *next = GetNext(block);
+            while ((uint8_t*)next < chunk->top && next->isFree) {
+                block->size += next->size;
+                next = GetNext(next);
+            }
+
+            if ((uint8_t*)next == chunk->top) {
+                chunk->top = (uint8_t*)block;
+                break;
+            }
+
+            if (block->size >= ts) {
+                if (block->size - ts >= kMinBlockSize) {
+                    Header *rest = reinterpret_cast<Header*>((uint8_t*)block + ts);
+                    rest->handle = nullptr;
+                    rest->size = block->size - uint32_t(ts);
+                    rest->isFree = 1;
+                    block->size = uint32_t(ts);
+                }
+                chunk->used += block->size;
+                return block;
+            }
+
+            block = next;
+        }
+    }
+
+    if (size_t(chunk->end - chunk->top) < ts)
+        return nullptr;
+
+    Header *block = reinterpret_cast<Header*>(chunk->top);
+    block->size = uint32_t(ts);
+    chunk->top += ts;
+    chunk->used += ts;
+    return block;
+}
+
+size_t
+CompactingAllocator::CompactChunk(Chunk *chunk, size_t budget)
+{
+    size_t moved = 0;
+
+    Header *hole = nullptr,
+           *block = reinterpret_cast<Header*>(GetChunkBegin(chunk));
+    while ((uint8_t*)block < chunk->top && moved < budget) {
+        Header *next = GetNext(block);
+
+        if (block->isFree) {
+            if (nullptr == hole)
+                hole = block;
+            else
+                hole->size += block->size;
+        } else if (hole != nullptr) {
+            if (nullptr == block->handle) {
+                hole = nullptr; // pinned, restart after it
+            } else {
+                // Slide the block down, the hole ends up right after it.
+                uint32_t holeSize = hole->size,
+                         blockSize = block->size;
+                memmove(hole, block, blockSize);
+
+                void *data = (uint8_t*)hole + sizeof(Header);
+                memcpy(hole->handle, &data, sizeof(void*));
+
+                hole = GetNext(hole);
+                hole->handle = nullptr;
+                hole->size = holeSize;
+                hole->isFree = 1;
+
+                moved += blockSize;
+            }
+        }
+
+        block = next;
+    }
+
+    if (hole != nullptr && (uint8_t*)GetNext(hole) == chunk->top)
+        chunk->top = (uint8_t*)hole;
+
+    return moved;
+}
+
+CompactingAllocator::CompactingAllocator(Allocator *allocator, size_t _chunkSize, size_t _frameBudget)
+: baseAllocator(allocator),
+  chunkSize(_chunkSize),
+  frameBudget(_frameBudget),
+  reservedSize(0),
+  firstChunk(nullptr)
+{
+    static_assert(sizeof(Header) == kBlockAlign, "unexpected Header size");
+    static_assert(sizeof(Chunk) <= kChunkHeaderSize, "unexpected Chunk size");
+    this->AddChunk(0);
+}
+
+CompactingAllocator::~CompactingAllocator()
+{
+    assert(0 == this->GetTotalAllocated());
+
+    Chunk *chunk = firstChunk, *tmp;
+    while (chunk != nullptr) {
+        tmp = chunk;
+        chunk = chunk->next;
+        baseAllocator->Free(tmp);
+    }
+}
+
+void*
+CompactingAllocator::Allocate(size_t size, size_t align)
+{
+    // Blocks start kBlockAlign aligned, padding is only needed above that.
+    size_t ts = align > kBlockAlign ? Allocator::GetAlignedSize<Header>(size, align) : sizeof(Header) + size;
+    ts = (ts + kBlockAlign - 1) & ~(kBlockAlign - 1);
+    assert(ts <= 0xffffffff);
+
+    std::lock_guard<std::mutex> guard(mutex);
+
+    Header *block = nullptr;
+    for (Chunk *chunk = firstChunk; nullptr == block && chunk != nullptr; chunk = chunk->next)
+        block = this->AllocateBlock(chunk, ts);
+
+    if (nullptr == block)
+        block = this->AllocateBlock(this->AddChunk(ts), ts);
+
+    block->handle = nullptr;
+    block->isFree = 0;
+
+    this->TrackAllocation(block->size);
+
+    void *d = Allocator::GetDataFromPointer<Header>(block, align);
+    Allocator::FillPadding<Header>(block, d);
+
+    return d;
+}
+
+void
+CompactingAllocator::Free(void *pointer)
+{
+    if (nullptr == pointer)
+        return;
+
+    Header *block = Allocator::GetPointerFromData<Header>(pointer);
+    assert(!block->isFree);
+    this->TrackFree(block->size);
+
+    std::lock_guard<std::mutex> guard(mutex);
+
+    Chunk *chunk = this->FindChunk(block);
+    chunk->used -= block->size;
+
+    block->handle = nullptr;
+    block->isFree = 1;
+
+    if (0 == chunk->used) {
+        if (chunk != firstChunk)
+            this->FreeChunk(chunk);
+        else
+            chunk->top = GetChunkBegin(chunk);
+    } else if ((uint8_t*)GetNext(block) == chunk->top) {
+        chunk->top = (uint8_t*)block;
+    }
+}
+
+bool
+CompactingAllocator::TryExpand(void *pointer, size_t oldSize, size_t newSize)
+{
+    Header *block = Allocator::GetPointerFromData<Header>(pointer);
+
+    size_t ts = ((uint8_t*)pointer - (uint8_t*)block) + newSize;
+    ts = (ts + kBlockAlign - 1) & ~(kBlockAlign - 1);
+
+    std::lock_guard<std::mutex> guard(mutex);
+
+    size_t oldBlockSize = block->size;
+    if (ts <= oldBlockSize)
+        return true;
+
+    Chunk *chunk = this->FindChunk(block);
+
+    // Absorb the free run that follows, and the space above the top if the run reaches it.
+    Header *next = GetNext(block);
+    size_t available = oldBlockSize;
+    while ((uint8_t*)next < chunk->top && next->isFree) {
+        available += next->size;
+        next = GetNext(next);
+    }
+
+    if ((uint8_t*)next == chunk->top) {
+        if (size_t(chunk->end - (uint8_t*)block) < ts)
+            return false;
+
+        chunk->top = (uint8_t*)block + ts;
+    } else {
+        if (available < ts)
+            return false;
+
+        if (available - ts >= kMinBlockSize) {
+            Header *rest = reinterpret_cast<Header*>((uint8_t*)block + ts);
+            rest->handle = nullptr;
+            rest->size = uint32_t(available - ts);
+            rest->isFree = 1;
+        } else {
+            ts = available;
+        }
+    }
+
+    block->size = uint32_t(ts);
+    chunk->used += ts - oldBlockSize;
+
+    this->TrackResize(oldBlockSize, ts);
+
+    return true;
+}
+
+void
+CompactingAllocator::SetRelocationHandle(void *pointer, void **handle)
+{
+    Header *block = Allocator::GetPointerFromData<Header>(pointer);
+    assert2(nullptr == handle || (uint8_t*)pointer == (uint8_t*)block + sizeof(Header),
+        "only blocks without alignment padding can be relocated");
+
+    std::lock_guard<std::mutex> guard(mutex);
+    block->handle = handle;
+}
+
+size_t
+CompactingAllocator::GetAllocatedSize(void *pointer)
+{
+    return Allocator::GetPointerFromData<Header>(pointer)->size;
+}
+
+size_t
+CompactingAllocator::GetReservedSize()
+{
+    std::lock_guard<std::mutex> guard(mutex);
+    return reservedSize;
+}
+
+void
+CompactingAllocator::NewFrame()
+{
+    Allocator::NewFrame();
+
+    if (frameBudget > 0)
+        this->Defragment(frameBudget);
+}
+
+size_t
+CompactingAllocator::Defragment(size_t maxBytes)
+{
+    std::lock_guard<std::mutex> guard(mutex);
+
+    size_t moved = 0;
+    for (Chunk *chunk = firstChunk; chunk != nullptr && moved < maxBytes; chunk = chunk->next) {
+        if (size_t(chunk->top - GetChunkBegin(chunk)) > chunk->used)
+            moved += this->CompactChunk(chunk, maxBytes - moved);
+    }
+
+    return moved;
+}
+
+} // namespace Framework
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <mutex>
+#include "Core/Memory/Memory.h"
+#include "Core/Memory/Allocator.h"
+
+namespace Framework {
+
+// Heap for large long-lived data (resource payloads) that slides blocks down
+// over the holes left by freed ones, a budgeted step runs every NewFrame.
+// Only blocks whose owner registered a relocation handle are moved, the
+// pointer stored in the handle is patched when that happens so pointers to
+// relocatable blocks must not be cached across frames.
+class CompactingAllocator : public Allocator {
+    DeclareClassInfo;
+    DeclareAllocator(CompactingAllocator);
+private:
+    static const size_t kBlockAlign = 16;
+    static const size_t kMinBlockSize = 2 * kBlockAlign;
+    static const size_t kChunkHeaderSize = 2 * kBlockAlign;
+
+    struct Header {
+        void     **handle; // nullptr pins the block
+        uint32_t size;     // whole block, header included
+        uint32_t isFree;   // keeps the byte in front of the padding != kPaddingValue
+    };
+
+    struct Chunk {
+        Chunk   *next;
+        uint8_t *top;
+        uint8_t *end;
+        size_t  used; // live blocks, what's left below top are holes
+    };
+
+    Allocator *baseAllocator;
+    size_t chunkSize;
+    size_t frameBudget;
+    size_t reservedSize;
+
+    Chunk *firstChunk;
+
+    std::mutex mutex;
+
+    static uint8_t* GetChunkBegin(Chunk *chunk);
+    static Header* GetNext(Header *block);
+
+    Chunk* AddChunk(size_t minSize);
+    void FreeChunk(Chunk *chunk);
+    Chunk* FindChunk(Header *block);
+    Header* AllocateBlock(Chunk *chunk, size_t ts);
+    size_t CompactChunk(Chunk *chunk, size_t budget);
+public:
+    CompactingAllocator(Allocator *allocator, size_t _chunkSize, size_t _frameBudget);
+    virtual ~CompactingAllocator();
+
+    virtual void* Allocate(size_t size, size_t align);
+    virtual void Free(void *pointer);
+
+    virtual bool TryExpand(void *pointer, size_t oldSize, size_t newSize);
+    virtual void SetRelocationHandle(void *pointer, void **handle);
+
+    virtual size_t GetAllocatedSize(void *pointer);
+    virtual size_t GetReservedSize();
+
+    virtual void NewFrame();
+
+    // Moves up to maxBytes of live blocks, returns how many bytes were moved.
+    size_t Defragment(size_t maxBytes);
+};
+
+inline uint8_t*
+CompactingAllocator::GetChunkBegin(Chunk *chunk)
+{
+    return (uint8_t*)chunk + kChunkHeaderSize;
+}
+
+inline CompactingAllocator::Header*
+CompactingAllocator::GetNext(Header *block)
+{
+    return reinterpret_cast<Header*>((uint8_t*)block + block->size);
+}
+
+} // namespace Framework
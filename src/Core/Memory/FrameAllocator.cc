@@ -0,0 +1,129 @@
+#include "Core/Memory/FrameAllocator.h"
+
+namespace Framework {
+
+DefineClassInfo(Framework::FrameAllocator, Framework::Allocator);
+DefineAllocator(Framework::FrameAllocator);
+
+static const uintptr_t kChunkHeaderSize = 16;
+
+FrameAllocator::Chunk*
+FrameAllocator::NewChunk(size_t minSize)
+{
+    size_t size = minSize + kChunkHeaderSize;
+    if (size < chunkSize)
+        size = chunkSize;
+
+    Chunk *chunk = static_cast<Chunk*>(baseAllocator->Allocate(size, kChunkHeaderSize));
+    chunk->next = nullptr;
+    chunk->end  = (uint8_t*)chunk + size;
+    reservedSize += size;
+    return chunk;
+}
+
+void
+FrameAllocator::ResetArena(Arena &arena)
+{
+    arena.chunk = arena.firstChunk;
+    arena.ptr = (uint8_t*)arena.chunk + kChunkHeaderSize;
+    arena.end = arena.chunk->end;
+    arena.last = nullptr;
+    arena.allocated = 0;
+}
+
+FrameAllocator::FrameAllocator(Allocator *allocator, size_t _chunkSize, uint32_t _numFrames)
+: baseAllocator(allocator),
+  chunkSize(_chunkSize),
+  reservedSize(0),
+  numFrames(_numFrames),
+  frameIndex(0)
+{
+    assert(numFrames > 0 && numFrames <= kMaxFrames);
+    for (uint32_t i = 0; i < numFrames; ++i) {
+        arenas[i].firstChunk = this->NewChunk(0);
+        this->ResetArena(arenas[i]);
+    }
+}
+
+FrameAllocator::~FrameAllocator()
+{
+    for (uint32_t i = 0; i < numFrames; ++i) {
+        Chunk *chunk = arenas[i].firstChunk, *tmp;
+        while (chunk != nullptr) {
+            tmp = chunk;
+            chunk = chunk->next;
+            baseAllocator->Free(tmp);
+        }
+    }
+}
+
+void*
+FrameAllocator::Allocate(size_t size, size_t align)
+{
+    Arena &arena = arenas[frameIndex];
+
+    size_t ts = Allocator::GetAlignedSize(size, align);
+    if (size_t(arena.end - arena.ptr) < ts) {
+        // Move on to the next chunk, reuse the ones kept from previous frames if they fit.
+        Chunk *next = arena.chunk->next;
+        if (nullptr == next || size_t(next->end - (uint8_t*)next) < ts + kChunkHeaderSize) {
+            Chunk *chunk = this->NewChunk(ts);
+            chunk->next = next;
+            arena.chunk->next = chunk;
+            next = chunk;
+        }
+
+        arena.chunk = next;
+        arena.ptr = (uint8_t*)next + kChunkHeaderSize;
+        arena.end = next->end;
+    }
+
+    void *d = Allocator::GetDataFromPointer((void*)arena.ptr, align);
+    arena.ptr = (uint8_t*)d + size;
+    arena.last = (uint8_t*)d;
+    arena.allocated += ts;
+    this->TrackAllocation(ts);
+
+    return d;
+}
+
+void
+FrameAllocator::Free(void *pointer)
+{ }
+
+bool
+FrameAllocator::TryExpand(void *pointer, size_t oldSize, size_t newSize)
+{
+    Arena &arena = arenas[frameIndex];
+    if (pointer != arena.last || newSize > size_t(arena.end - arena.last))
+        return false;
+
+    size_t oldTop = arena.ptr - arena.last;
+    arena.allocated = arena.allocated - oldTop + newSize;
+    arena.ptr = arena.last + newSize;
+    this->TrackResize(oldTop, newSize);
+
+    return true;
+}
+
+size_t
+FrameAllocator::GetAllocatedSize(void *pointer)
+{
+    return 0;
+}
+
+size_t
+FrameAllocator::GetReservedSize()
+{
+    return reservedSize;
+}
+
+void
+FrameAllocator::NextFrame()
+{
+    frameIndex = (frameIndex + 1) % numFrames;
+    bytesInUse.fetch_sub(arenas[frameIndex].allocated, std::memory_order_relaxed);
+    this->ResetArena(arenas[frameIndex]);
+}
+
+} // namespace Framework
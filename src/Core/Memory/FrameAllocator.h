@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Core/Memory/Memory.h"
+#include "Core/Memory/Allocator.h"
+
+namespace Framework {
+
+// One bump arena per in-flight frame, Free does nothing and the whole arena is
+// reset by NextFrame once the frame that used it has been consumed.
+class FrameAllocator : public Allocator {
+    DeclareClassInfo;
+    DeclareAllocator(FrameAllocator);
+private:
+    static const uint32_t kMaxFrames = 4;
+
+    struct Chunk {
+        Chunk   *next;
+        uint8_t *end;
+    };
+
+    struct Arena {
+        Chunk   *firstChunk;
+        Chunk   *chunk;
+        uint8_t *ptr;
+        uint8_t *end;
+        uint8_t *last;
+        size_t  allocated;
+    };
+
+    Allocator *baseAllocator;
+    size_t chunkSize;
+    size_t reservedSize;
+    uint32_t numFrames;
+    uint32_t frameIndex;
+
+    Arena arenas[kMaxFrames];
+
+    Chunk* NewChunk(size_t minSize);
+    void ResetArena(Arena &arena);
+public:
+    FrameAllocator(Allocator *allocator, size_t _chunkSize, uint32_t _numFrames);
+    virtual ~FrameAllocator();
+
+    virtual void* Allocate(size_t size, size_t align);
+    virtual void Free(void *pointer);
+
+    virtual bool TryExpand(void *pointer, size_t oldSize, size_t newSize);
+
+    virtual size_t GetAllocatedSize(void *pointer);
+    virtual size_t GetReservedSize();
+
+    uint32_t GetFrameIndex() const;
+    size_t GetFrameAllocated() const;
+
+    void NextFrame();
+};
+
+inline uint32_t
+FrameAllocator::GetFrameIndex() const
+{
+    return frameIndex;
+}
+
+inline size_t
+FrameAllocator::GetFrameAllocated() const
+{
+    return arenas[frameIndex].allocated;
+}
+
+} // namespace Framework
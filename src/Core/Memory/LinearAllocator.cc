@@ -1,4 +1,5 @@
 #include "Core/Memory/LinearAllocator.h"
+#include "Core/Memory/VirtualMemory.h"
 #include "Core/Debug.h"
 #include "Core/Collections/Array.h"
 
@@ -7,13 +8,67 @@ namespace Framework {
 DefineClassInfo(Framework::LinearAllocator, Framework::Allocator);
 DefineAllocator(Framework::LinearAllocator);
 
-LinearAllocator::LinearAllocator(Allocator *allocator, size_t bufferSize, size_t stackSize)
+void
+LinearAllocator::Commit(uint8_t *top)
+{
+    assert2(VirtualBuffer == mode && top <= end, "LinearAllocator out of memory");
+
+    size_t commitOffset = ((top - begin) + kCommitSize - 1) & ~(kCommitSize - 1);
+    uint8_t *newCommitted = begin + commitOffset;
+    if (newCommitted > end)
+        newCommitted = end;
+
+    verify(Memory::CommitVirtual(committed, newCommitted - committed));
+    committed = newCommitted;
+}
+
+void
+LinearAllocator::Decommit()
+{
+    if (mode != VirtualBuffer)
+        return;
+
+    size_t keepOffset = ((ptr - begin) + kCommitSize - 1) & ~(kCommitSize - 1);
+    uint8_t *keep = begin + keepOffset;
+    if (keep < committed) {
+        Memory::DecommitVirtual(keep, committed - keep);
+        committed = keep;
+    }
+}
+
+void
+LinearAllocator::Rewind(uint8_t *newPtr, bool decommit)
+{
+    bytesInUse.fetch_sub(ptr - newPtr, std::memory_order_relaxed);
+    ptr = newPtr;
+    lastAllocation = nullptr;
+
+    if (decommit)
+        this->Decommit();
+}
+
+LinearAllocator::LinearAllocator(Allocator *allocator, size_t bufferSize, size_t stackSize, BufferMode _mode)
 : baseAllocator(allocator),
+  mode(_mode),
+  lastAllocation(nullptr),
   stack(*allocator, stackSize)
 {
-    begin = static_cast<uint8_t*>(baseAllocator->Allocate(bufferSize, 1));
-    end   = begin + bufferSize;
-    ptr   = begin;
+    begin = nullptr;
+    if (VirtualBuffer == mode && 0 == (kCommitSize % Memory::GetVirtualPageSize())) {
+        bufferSize = (bufferSize + kCommitSize - 1) & ~(kCommitSize - 1);
+        begin = static_cast<uint8_t*>(Memory::ReserveVirtual(bufferSize));
+    }
+
+    if (begin != nullptr) {
+        committed = begin;
+    } else {
+        // no virtual memory (or pages that don't divide kCommitSize), take the whole buffer up front
+        mode = FixedBuffer;
+        begin = static_cast<uint8_t*>(baseAllocator->Allocate(bufferSize, 1));
+        committed = begin + bufferSize;
+    }
+    end = begin + bufferSize;
+    ptr = begin;
 
     this->PushState();
 }
@@ -22,24 +77,28 @@ LinearAllocator::~LinearAllocator()
 {
     this->PopState();
 
-    baseAllocator->Free(begin);
+    if (VirtualBuffer == mode)
+        Memory::ReleaseVirtual(begin, end - begin);
+    else
+        baseAllocator->Free(begin);
 }
 
 void*
 LinearAllocator::Allocate(size_t size, size_t align)
 {
     size_t ts = Allocator::GetAlignedSize(size, align);
-    assert(end - ptr >= ts);
+    if (size_t(committed - ptr) < ts)
+        this->Commit(ptr + ts);
 
     void *p = ptr;
     ptr += ts;
     void *d = Allocator::GetDataFromPointer(p, align);
+    lastAllocation = (uint8_t*)d;
+    this->TrackAllocation(ts);
 #ifdef _DEBUG
     assert(!stack.IsEmpty());
-    for (State *it = stack.Begin(), *end = stack.End(); it < end; ++it) {
+    for (State *it = stack.Begin(), *end = stack.End(); it < end; ++it)
         ++it->allocCount;
-        it->totalAllocated += ts;
-    }
 #endif
     return d;
 }
@@ -49,6 +108,7 @@ LinearAllocator::Free(void *pointer)
 {
     if (nullptr == pointer)
         return;
+    this->TrackFree(0);
 #ifdef _DEBUG
     assert(!stack.IsEmpty());
     for (State *it = stack.Begin(), *end = stack.End(); it < end; ++it)
@@ -56,6 +116,25 @@ LinearAllocator::Free(void *pointer)
 #endif
 }
 
+bool
+LinearAllocator::TryExpand(void *pointer, size_t oldSize, size_t newSize)
+{
+    // Only the top allocation can move the top.
+    if (pointer != lastAllocation)
+        return false;
+
+    uint8_t *top = (uint8_t*)pointer + newSize;
+    if (top > end)
+        return false;
+    if (top > committed)
+        this->Commit(top);
+
+    this->TrackResize(ptr - lastAllocation, newSize);
+    ptr = top;
+
+    return true;
+}
+
 size_t
 LinearAllocator::GetAllocatedSize(void *pointer)
 {
@@ -63,49 +142,38 @@ LinearAllocator::GetAllocatedSize(void *pointer)
 }
 
 size_t
-LinearAllocator::GetTotalAllocated()
+LinearAllocator::GetReservedSize()
 {
-#ifdef _DEBUG
-    assert(!stack.IsEmpty())
-    return stack.Front().totalAllocated;
-#else
-    return 0;
-#endif
+    return committed - begin;
 }
 
 void
 LinearAllocator::PushState()
 {
 #ifdef _DEBUG
-    State state = { ptr, 0, 0 };
+    State state = { ptr, 0 };
 #else
     State state = { ptr };
 #endif
     stack.PushBack(state);
+    lastAllocation = nullptr;
 }
 
 void
-LinearAllocator::PopState()
+LinearAllocator::PopState(bool decommit)
 {
-#ifdef _DEBUG
     assert(0 == stack.Back().allocCount);
-    uint32_t ta = stack.Back().totalAllocated;
-#endif
-    ptr = stack.Back().ptr;
+    uint8_t *statePtr = stack.Back().ptr;
     stack.PopBack();
-#ifdef _DEBUG
-    if (!stack.IsEmpty()) {
-        for (State *it = stack.Begin(), *end = stack.End(); it < end; ++it)
-            it->totalAllocated -= ta;
-    }
-#endif
+
+    this->Rewind(statePtr, decommit);
 }
 
 void
-LinearAllocator::Reset()
+LinearAllocator::Reset(bool decommit)
 {
-    ptr = begin;
     stack.Clear();
+    this->Rewind(begin, decommit);
     this->PushState();
 }
 
@@ -9,35 +9,58 @@ namespace Framework {
 class LinearAllocator : public Allocator {
     DeclareClassInfo;
     DeclareAllocator(LinearAllocator);
+public:
+    enum BufferMode {
+        FixedBuffer,   // bufferSize bytes taken from the base allocator up front
+        VirtualBuffer  // bufferSize bytes of address space, pages committed on demand
+    };
 private:
+    static const size_t kCommitSize = 64 * 1024;
+
     struct State {
         uint8_t *ptr;
 #ifdef _DEBUG
         uint32_t allocCount;
-        uint32_t totalAllocated;
 #endif
     };
 
     Allocator *baseAllocator;
+    BufferMode mode;
 
     uint8_t *begin;
     uint8_t *end;
     uint8_t *ptr;
+    uint8_t *committed;
+    uint8_t *lastAllocation;
 
     Array<State> stack;
+
+    void Commit(uint8_t *top);
+    void Decommit();
+    void Rewind(uint8_t *newPtr, bool decommit);
 public:
-    LinearAllocator(Allocator *allocator, size_t bufferSize, size_t stackSize);
+    LinearAllocator(Allocator *allocator, size_t bufferSize, size_t stackSize, BufferMode _mode = FixedBuffer);
     virtual ~LinearAllocator();
 
     virtual void* Allocate(size_t size, size_t align);
     virtual void Free(void *pointer);
 
+    virtual bool TryExpand(void *pointer, size_t oldSize, size_t newSize);
+
     virtual size_t GetAllocatedSize(void *pointer);
-    virtual size_t GetTotalAllocated();
+    virtual size_t GetReservedSize();
+
+    size_t GetCommittedSize() const;
 
     void PushState();
-    void PopState();
-    void Reset();
+    void PopState(bool decommit = false);
+    void Reset(bool decommit = false);
 };
-        
+
+inline size_t
+LinearAllocator::GetCommittedSize() const
+{
+    return committed - begin;
+}
+
 } // namespace Framework
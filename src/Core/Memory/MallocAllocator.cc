@@ -1,3 +1,4 @@
+#include <cstddef>
 #include "Core/Memory/MallocAllocator.h"
 
 namespace Framework {
@@ -10,12 +11,11 @@ DefineClassInfo(Framework::MallocAllocator, Framework::Allocator);
 DefineAllocator(Framework::MallocAllocator);
 
 MallocAllocator::MallocAllocator()
-: totalAllocated(0)
 { }
 
 MallocAllocator::~MallocAllocator()
 {
-    assert(0 == totalAllocated);
+    assert(0 == this->GetTotalAllocated());
 }
 
 void*
@@ -27,7 +27,7 @@ MallocAllocator::Allocate(size_t size, size_t align)
     Header *p = (Header*)malloc(ts);
     d = Allocator::GetDataFromPointer<Header>(p, align);
     p->size = ts;
-    totalAllocated += ts;
+    this->TrackAllocation(ts);
 
     Allocator::FillPadding(p, d);
 
@@ -41,20 +41,44 @@ MallocAllocator::Free(void *pointer)
         return;
 
     Header *h = Allocator::GetPointerFromData<Header>(pointer);
-    totalAllocated -= h->size;
+    this->TrackFree(h->size);
     free(h);
 }
 
-size_t
-MallocAllocator::GetAllocatedSize(void *pointer)
+bool
+MallocAllocator::TryExpand(void *pointer, size_t oldSize, size_t newSize)
 {
-    return Allocator::GetPointerFromData<Header>(pointer)->size;
+    Header *h = Allocator::GetPointerFromData<Header>(pointer);
+    return (uintptr_t(pointer) - uintptr_t(h)) + newSize <= h->size;
+}
+
+void*
+MallocAllocator::Reallocate(void *pointer, size_t oldSize, size_t newSize, size_t align)
+{
+    // realloc moves header and padding along with the data, the offset between them
+    // stays valid while malloc's own alignment covers align. Large blocks are remapped
+    // by the C runtime instead of copied.
+    if (nullptr == pointer || 0 == newSize || align > alignof(std::max_align_t))
+        return Allocator::Reallocate(pointer, oldSize, newSize, align);
+
+    Header *h = Allocator::GetPointerFromData<Header>(pointer);
+    uintptr_t offset = uintptr_t(pointer) - uintptr_t(h);
+    if (offset + newSize <= h->size)
+        return pointer;
+
+    size_t oldTs = h->size,
+           ts    = Allocator::GetAlignedSize<Header>(newSize, align);
+    h = (Header*)realloc(h, ts);
+    h->size = ts;
+    this->TrackResize(oldTs, ts);
+
+    return (void*)(uintptr_t(h) + offset);
 }
 
 size_t
-MallocAllocator::GetTotalAllocated()
+MallocAllocator::GetAllocatedSize(void *pointer)
 {
-    return totalAllocated;
+    return Allocator::GetPointerFromData<Header>(pointer)->size;
 }
 
 } // namespace Framework
@@ -8,8 +8,6 @@ namespace Framework {
 class MallocAllocator : public Allocator {
     DeclareClassInfo;
     DeclareAllocator(MallocAllocator);
-private:
-    size_t totalAllocated;
 public:
     MallocAllocator();
     virtual ~MallocAllocator();
@@ -17,8 +15,10 @@ public:
     virtual void* Allocate(size_t size, size_t align);
     virtual void Free(void *pointer);
 
+    virtual bool TryExpand(void *pointer, size_t oldSize, size_t newSize);
+    virtual void* Reallocate(void *pointer, size_t oldSize, size_t newSize, size_t align);
+
     virtual size_t GetAllocatedSize(void *pointer);
-    virtual size_t GetTotalAllocated();
 };
 
 } // namespace Framework
@@ -5,7 +5,7 @@
 namespace Framework {
     namespace Memory {
 
-char __allocBuffer[1024];
+alignas(64) char __allocBuffer[4096];
 char *__allocPointer;
 const char *__allocEnd = __allocBuffer + sizeof(__allocBuffer);
 List<Allocator, &Allocator::node> allocators;
@@ -25,8 +25,9 @@ void ShutdownMemory()
     allocators.Clear();
 }
 
-void* GetAllocatorMemory(size_t size)
+void* GetAllocatorMemory(size_t size, size_t align)
 {
+    __allocPointer = (char*)((uintptr_t(__allocPointer) + align - 1) & ~uintptr_t(align - 1));
     assert(size_t(__allocEnd - __allocPointer) >= size);
     void *p = static_cast<void*>(__allocPointer);
     __allocPointer += size;
@@ -38,5 +39,10 @@ void InitAllocatorMemory(Allocator *pointer)
     allocators.PushBack(pointer);
 }
 
+const List<Allocator, &Allocator::node>& GetAllocators()
+{
+    return allocators;
+}
+
     } // namespace Memory
 } // namespace Framework
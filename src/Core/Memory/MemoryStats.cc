@@ -0,0 +1,186 @@
+#include <mutex>
+#include <atomic>
+#include <cstring>
+#include "Core/Memory/MemoryStats.h"
+#include "Core/Memory/Allocator.h"
+#include "Core/Collections/List.h"
+
+#include "imgui.h"
+
+namespace Framework {
+    namespace Memory {
+
+struct Tag {
+    const char            *name;
+    std::atomic<uint64_t> allocCount;
+    std::atomic<uint64_t> allocBytes;
+    std::atomic<uint32_t> frameAllocCount;
+    std::atomic<size_t>   frameAllocBytes;
+    uint32_t              lastFrameAllocCount;
+    size_t                lastFrameAllocBytes;
+};
+
+static const uint32_t kHistorySize = 120;
+static const uint32_t kMaxPlottedAllocators = 16;
+
+static Tag tags[kMaxTags];
+static std::atomic<uint32_t> tagsCount(1);
+static std::mutex tagsMutex;
+static thread_local uint32_t currentTag = kNoTag;
+
+// Per allocator, a total would count twice what allocators refill from their base one.
+static float allocsHistory[kMaxPlottedAllocators][kHistorySize];
+static uint32_t historyOffset = 0;
+
+uint32_t RegisterTag(const char *name)
+{
+    std::lock_guard<std::mutex> guard(tagsMutex);
+
+    uint32_t count = tagsCount.load();
+    for (uint32_t i = 1; i < count; ++i) {
+        if (tags[i].name == name || 0 == strcmp(tags[i].name, name))
+            return i;
+    }
+
+    if (count == kMaxTags)
+        return kNoTag;
+
+    tags[count].name = name;
+    tagsCount.store(count + 1);
+    return count;
+}
+
+uint32_t GetTagsCount()
+{
+    return tagsCount.load();
+}
+
+void GetTagStats(uint32_t tag, TagStats &stats)
+{
+    assert(tag < tagsCount.load());
+    const Tag &t = tags[tag];
+    stats.name            = kNoTag == tag ? "Untagged" : t.name;
+    stats.allocCount      = t.allocCount.load(std::memory_order_relaxed);
+    stats.allocBytes      = t.allocBytes.load(std::memory_order_relaxed);
+    stats.frameAllocCount = t.lastFrameAllocCount;
+    stats.frameAllocBytes = t.lastFrameAllocBytes;
+}
+
+uint32_t GetCurrentTag()
+{
+    return currentTag;
+}
+
+void SetCurrentTag(uint32_t tag)
+{
+    currentTag = tag;
+}
+
+void TrackTaggedAllocation(size_t size)
+{
+    // Untagged allocations are only visible in the allocators counters.
+    if (kNoTag == currentTag)
+        return;
+
+    Tag &t = tags[currentTag];
+    t.allocCount.fetch_add(1, std::memory_order_relaxed);
+    t.allocBytes.fetch_add(size, std::memory_order_relaxed);
+    t.frameAllocCount.fetch_add(1, std::memory_order_relaxed);
+    t.frameAllocBytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+void NewFrame()
+{
+    uint32_t index = 0;
+    const List<Allocator, &Allocator::node> &allocators = GetAllocators();
+    for (Allocator *it = const_cast<Allocator*>(allocators.Begin()); it != nullptr; it = it->node.next, ++index) {
+        it->NewFrame();
+        if (index >= kMaxPlottedAllocators)
+            continue;
+
+        AllocatorStats stats;
+        it->GetStats(stats);
+        allocsHistory[index][historyOffset] = float(stats.frameAllocCount);
+    }
+
+    for (uint32_t i = 1, l = tagsCount.load(); i < l; ++i) {
+        tags[i].lastFrameAllocCount = tags[i].frameAllocCount.exchange(0, std::memory_order_relaxed);
+        tags[i].lastFrameAllocBytes = tags[i].frameAllocBytes.exchange(0, std::memory_order_relaxed);
+    }
+
+    historyOffset = (historyOffset + 1) % kHistorySize;
+}
+
+void ShowStatsWindow(bool *open)
+{
+    if (!ImGui::Begin("Memory", open)) {
+        ImGui::End();
+        return;
+    }
+
+    if (ImGui::CollapsingHeader("Allocators", ImGuiTreeNodeFlags_DefaultOpen)) {
+        ImGui::Columns(8, "allocators");
+        ImGui::Text("Name"); ImGui::NextColumn();
+        ImGui::Text("Allocs"); ImGui::NextColumn();
+        ImGui::Text("Frees"); ImGui::NextColumn();
+        ImGui::Text("In use KB"); ImGui::NextColumn();
+        ImGui::Text("Peak KB"); ImGui::NextColumn();
+        ImGui::Text("Reserved KB"); ImGui::NextColumn();
+        ImGui::Text("Frag %%"); ImGui::NextColumn();
+        ImGui::Text("Allocs/frame"); ImGui::NextColumn();
+        ImGui::Separator();
+
+        const List<Allocator, &Allocator::node> &allocators = GetAllocators();
+        for (Allocator *it = const_cast<Allocator*>(allocators.Begin()); it != nullptr; it = it->node.next) {
+            AllocatorStats stats;
+            it->GetStats(stats);
+
+            ImGui::Text("%s", it->GetTypeName()); ImGui::NextColumn();
+            ImGui::Text("%llu", (unsigned long long)stats.allocCount); ImGui::NextColumn();
+            ImGui::Text("%llu", (unsigned long long)stats.freeCount); ImGui::NextColumn();
+            ImGui::Text("%.1f", stats.bytesInUse / 1024.0f); ImGui::NextColumn();
+            ImGui::Text("%.1f", stats.peakBytes / 1024.0f); ImGui::NextColumn();
+            ImGui::Text("%.1f", stats.reservedBytes / 1024.0f); ImGui::NextColumn();
+            ImGui::Text("%.1f", stats.GetFragmentation() * 100.0f); ImGui::NextColumn();
+            ImGui::Text("%u", stats.frameAllocCount); ImGui::NextColumn();
+        }
+        ImGui::Columns(1);
+    }
+
+    if (ImGui::CollapsingHeader("Allocs/frame", ImGuiTreeNodeFlags_DefaultOpen)) {
+        uint32_t index = 0;
+        const List<Allocator, &Allocator::node> &allocators = GetAllocators();
+        for (Allocator *it = const_cast<Allocator*>(allocators.Begin()); it != nullptr && index < kMaxPlottedAllocators; it = it->node.next, ++index) {
+            ImGui::PushID(int(index));
+            ImGui::PlotLines(it->GetTypeName(), allocsHistory[index], kHistorySize, historyOffset, nullptr, 0.0f, FLT_MAX, ImVec2(0, 40));
+            ImGui::PopID();
+        }
+    }
+
+    if (ImGui::CollapsingHeader("Tags", ImGuiTreeNodeFlags_DefaultOpen)) {
+        ImGui::Columns(5, "tags");
+        ImGui::Text("Name"); ImGui::NextColumn();
+        ImGui::Text("Allocs/frame"); ImGui::NextColumn();
+        ImGui::Text("KB/frame"); ImGui::NextColumn();
+        ImGui::Text("Allocs"); ImGui::NextColumn();
+        ImGui::Text("KB"); ImGui::NextColumn();
+        ImGui::Separator();
+
+        for (uint32_t i = 1, l = GetTagsCount(); i < l; ++i) {
+            TagStats stats;
+            GetTagStats(i, stats);
+
+            ImGui::Text("%s", stats.name); ImGui::NextColumn();
+            ImGui::Text("%u", stats.frameAllocCount); ImGui::NextColumn();
+            ImGui::Text("%.1f", stats.frameAllocBytes / 1024.0f); ImGui::NextColumn();
+            ImGui::Text("%llu", (unsigned long long)stats.allocCount); ImGui::NextColumn();
+            ImGui::Text("%.1f", stats.allocBytes / 1024.0f); ImGui::NextColumn();
+        }
+        ImGui::Columns(1);
+    }
+
+    ImGui::End();
+}
+
+    } // namespace Memory
+} // namespace Framework
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace Framework {
+    namespace Memory {
+
+const uint32_t kMaxTags = 64;
+const uint32_t kNoTag   = 0;
+
+struct TagStats {
+    const char *name;
+    uint64_t   allocCount;
+    uint64_t   allocBytes;
+    uint32_t   frameAllocCount; // during the last completed frame
+    size_t     frameAllocBytes;
+};
+
+// Tags attribute allocations made by the calling thread to a subsystem,
+// name must outlive the tag (class names, string literals).
+uint32_t RegisterTag(const char *name);
+uint32_t GetTagsCount();
+void GetTagStats(uint32_t tag, TagStats &stats);
+
+uint32_t GetCurrentTag();
+void SetCurrentTag(uint32_t tag);
+void TrackTaggedAllocation(size_t size);
+
+// Closes the per frame counters of every allocator and tag.
+void NewFrame();
+
+void ShowStatsWindow(bool *open);
+
+class TagScope {
+private:
+    uint32_t prevTag;
+public:
+    TagScope(uint32_t tag);
+    ~TagScope();
+};
+
+inline
+TagScope::TagScope(uint32_t tag)
+: prevTag(GetCurrentTag())
+{
+    SetCurrentTag(tag);
+}
+
+inline
+TagScope::~TagScope()
+{
+    SetCurrentTag(prevTag);
+}
+
+    } // namespace Memory
+} // namespace Framework
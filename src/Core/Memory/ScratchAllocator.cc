@@ -2,84 +2,242 @@
 
 namespace Framework {
 
-struct Header {
-    uint32_t size;
-};
-
 DefineClassInfo(Framework::ScratchAllocator, Framework::Allocator);
 DefineAllocator(Framework::ScratchAllocator);
 
-bool
-ScratchAllocator::InUse(uint8_t *pointer)
+static const uint64_t kBaseTag = ~0ull;
+static const uint64_t kFreedFlag = 1;
+static const size_t   kSegmentAlign = 16;
+
+static std::atomic<uint32_t> nextInstanceId(0);
+
+std::atomic<ScratchAllocator*> ScratchAllocator::instances[kMaxInstances];
+thread_local ScratchAllocator::PrivateBlockSlots ScratchAllocator::privateBlocks;
+
+ScratchAllocator::PrivateBlockSlots::PrivateBlockSlots()
+{
+    for (uint32_t i = 0; i < kMaxInstances; ++i)
+        blocks[i] = nullptr;
+}
+
+ScratchAllocator::PrivateBlockSlots::~PrivateBlockSlots()
+{
+    for (uint32_t i = 0; i < kMaxInstances; ++i) {
+        if (nullptr == blocks[i])
+            continue;
+
+        ScratchAllocator *owner = instances[i].load();
+        if (owner != nullptr)
+            owner->ReleasePrivateBlock(blocks[i]);
+        blocks[i] = nullptr;
+    }
+}
+
+void
+ScratchAllocator::Reclaim()
+{
+    // A single thread walks the tail, the others leave their freed blocks to it.
+    if (reclaiming.test_and_set(std::memory_order_acquire))
+        return;
+
+    uint64_t t = tail.load(std::memory_order_relaxed);
+    while (t != head.load(std::memory_order_acquire)) {
+        Header *h = reinterpret_cast<Header*>(begin + (t & mask));
+        if (h->tag.load(std::memory_order_acquire) != ((t << 1) | kFreedFlag))
+            break;
+        t += h->size;
+    }
+    tail.store(t, std::memory_order_release);
+
+    reclaiming.clear(std::memory_order_release);
+}
+
+ScratchAllocator::PrivateBlock*
+ScratchAllocator::AcquirePrivateBlock()
+{
+    std::lock_guard<std::mutex> guard(blocksMutex);
+
+    // A block left by an exited thread, unless its last allocation is being freed.
+    for (PrivateBlock *block = firstBlock; block != nullptr; block = block->next) {
+        if (block->owned)
+            continue;
+
+        uint32_t live = block->live.load(std::memory_order_relaxed);
+        while (live != 0) {
+            if (block->live.compare_exchange_weak(live, live + 1, std::memory_order_acquire)) {
+                block->owned = true;
+                return block;
+            }
+        }
+    }
+
+    PrivateBlock *block = static_cast<PrivateBlock*>(baseAllocator->Allocate(kPrivateBlockSize, kSegmentAlign));
+    block->live.store(1, std::memory_order_relaxed);
+    block->ptr = (uint8_t*)block + ((sizeof(PrivateBlock) + kSegmentAlign - 1) & ~(kSegmentAlign - 1));
+    block->end = (uint8_t*)block + kPrivateBlockSize;
+    block->next = firstBlock;
+    block->owned = true;
+    firstBlock = block;
+
+    return block;
+}
+
+void
+ScratchAllocator::ReleasePrivateBlock(PrivateBlock *block)
+{
+    {
+        std::lock_guard<std::mutex> guard(blocksMutex);
+        block->owned = false;
+    }
+
+    // left for the next thread until its allocations are freed
+    if (1 == block->live.fetch_sub(1, std::memory_order_acq_rel))
+        this->FreePrivateBlock(block);
+}
+
+void
+ScratchAllocator::FreePrivateBlock(PrivateBlock *block)
+{
+    // nobody owns it anymore, AcquirePrivateBlock skips it now that live is 0
+    std::lock_guard<std::mutex> guard(blocksMutex);
+    PrivateBlock **it = &firstBlock;
+    while (*it != block)
+        it = &(*it)->next;
+    *it = block->next;
+    baseAllocator->Free(block);
+}
+
+void*
+ScratchAllocator::AllocatePrivate(size_t ts, size_t align)
+{
+    PrivateBlock *&block = privateBlocks.blocks[instanceId];
+    if (nullptr == block)
+        block = this->AcquirePrivateBlock();
+
+    // Frees may come from other threads, only the owner rewinds once nothing is live.
+    uint8_t *blockBegin = (uint8_t*)block + ((sizeof(PrivateBlock) + kSegmentAlign - 1) & ~(kSegmentAlign - 1));
+    if (1 == block->live.load(std::memory_order_acquire))
+        block->ptr = blockBegin;
+
+    if (size_t(block->end - block->ptr) < ts)
+        return this->AllocateBase(ts, align);
+
+    Header *h = reinterpret_cast<Header*>(block->ptr);
+    block->ptr += ts;
+    block->live.fetch_add(1, std::memory_order_relaxed);
+
+    h->tag.store(uint64_t(uintptr_t(block)), std::memory_order_relaxed);
+    h->size = uint32_t(ts);
+    h->zero = 0;
+
+    void *d = Allocator::GetDataFromPointer<Header>(h, align);
+    Allocator::FillPadding(h, d);
+
+    this->TrackAllocation(ts);
+
+    return d;
+}
+
+void*
+ScratchAllocator::AllocateBase(size_t ts, size_t align)
 {
-    if (free == allocated)
-        return false;
-    if (allocated > free)
-        return pointer >= free && pointer < allocated;
-    return pointer >= free || pointer < allocated;
+    Header *h = static_cast<Header*>(baseAllocator->Allocate(ts, __alignof(Header)));
+    h->tag.store(kBaseTag, std::memory_order_relaxed);
+    h->size = uint32_t(ts);
+    h->zero = 0;
+
+    void *d = Allocator::GetDataFromPointer<Header>(h, align);
+    Allocator::FillPadding(h, d);
+
+    this->TrackAllocation(ts);
+
+    return d;
 }
 
 ScratchAllocator::ScratchAllocator(Allocator *allocator, uint32_t size)
 : baseAllocator(allocator),
-  totalAllocated(0)
+  instanceId(nextInstanceId++),
+  head(0),
+  tail(0),
+  firstBlock(nullptr)
 {
-    begin = static_cast<uint8_t*>(baseAllocator->Allocate(size, 1));
+    assert(instanceId < kMaxInstances);
+    assert(0 == (size & (size - 1)) && size >= kSegmentAlign);
+    reclaiming.clear();
+
+    begin = static_cast<uint8_t*>(baseAllocator->Allocate(size, kSegmentAlign));
     end = begin + size;
-    allocated = free = begin;
+    memset(begin, 0, size); // no stale tag can match a ring position
+    mask = size - 1;
+
+    instances[instanceId] = this;
 }
 
 ScratchAllocator::~ScratchAllocator()
 {
-    assert(free == allocated && 0 == totalAllocated);
+    this->Reclaim();
+    assert(head.load() == tail.load() && 0 == this->GetTotalAllocated());
+    instances[instanceId] = nullptr;
+
+    PrivateBlock *block = firstBlock, *tmp;
+    while (block != nullptr) {
+        tmp = block;
+        block = block->next;
+        baseAllocator->Free(tmp);
+    }
     baseAllocator->Free(begin);
 }
 
 void*
 ScratchAllocator::Allocate(size_t size, size_t align)
 {
-    //assert(0 == (align % 4));
-    //align = ((align + 3) >> 2) << 2;
-    void *d = nullptr;
-
     size_t ts = Allocator::GetAlignedSize<Header>(size, align);
-    ts = ((ts + 3) / 4) * 4;
+    ts = (ts + kSegmentAlign - 1) & ~(kSegmentAlign - 1);
+
+    size_t ringSize = end - begin;
 
     // Request bigger than scratch buffer.
-    if (ts > (uintptr_t(end) - uintptr_t(begin)))
-        return baseAllocator->Allocate(size, align);
+    if (ts > ringSize)
+        return this->AllocateBase(ts, align);
 
-    uint8_t *p = allocated;
-    Header *h = (Header*)p;
-    d = Allocator::GetDataFromPointer<Header>(h, align);
+    for (uint32_t i = 0; i < kMaxRetries; ++i) {
+        uint64_t h = head.load(std::memory_order_relaxed);
 
-    p += ts;
+        // A block never wraps, the space left before the end is skipped and published as freed.
+        size_t offset = size_t(h & mask),
+               skip = offset + ts > ringSize ? ringSize - offset : 0;
 
-    // Reached the end of the buffer, wrap around to the beginning. (mark free last block)
-    if (p > end)
-    {
-        h->size = (uintptr_t(end) - uintptr_t(h)) | 0x80000000u;
+        if (h + skip + ts - tail.load(std::memory_order_acquire) > ringSize) {
+            this->Reclaim();
+            continue;
+        }
 
-        p = begin;
-        h = (Header*)p;
-        d = Allocator::GetDataFromPointer<Header>(h, align);
+        if (!head.compare_exchange_weak(h, h + skip + ts, std::memory_order_relaxed))
+            continue;
 
-        p += ts;
-    }
+        if (skip > 0) {
+            Header *filler = reinterpret_cast<Header*>(begin + offset);
+            filler->size = uint32_t(skip);
+            filler->zero = 0;
+            filler->tag.store((h << 1) | kFreedFlag, std::memory_order_release);
+            h += skip;
+        }
 
-    // If the buffer is exhausted use the backing allocator instead.
-    if (this->InUse(p))
-        return baseAllocator->Allocate(size, align);
+        Header *block = reinterpret_cast<Header*>(begin + (h & mask));
+        block->size = uint32_t(ts);
+        block->zero = 0;
+        block->tag.store(h << 1, std::memory_order_release);
 
-    h->size = ts;
-    Allocator::FillPadding(h, d);
+        void *d = Allocator::GetDataFromPointer<Header>(block, align);
+        Allocator::FillPadding(block, d);
 
-    if (p == end)
-        p = begin;
-    allocated = (uint8_t*)p;
+        this->TrackAllocation(ts);
 
-    totalAllocated += ts;
+        return d;
+    }
 
-    return d;
+    // The ring is exhausted or contended.
+    return this->AllocatePrivate(ts, align);
 }
 
 void
@@ -88,28 +246,25 @@ ScratchAllocator::Free(void *pointer)
     if (nullptr == pointer)
         return;
 
-    if (pointer < begin || pointer >= end)
-    {
-        baseAllocator->Free(pointer);
+    Header *h = Allocator::GetPointerFromData<Header>(pointer);
+    this->TrackFree(h->size);
+
+    if (pointer >= begin && pointer < end) {
+        assert(0 == (h->tag.load(std::memory_order_relaxed) & kFreedFlag));
+        h->tag.fetch_or(kFreedFlag, std::memory_order_release);
+        this->Reclaim();
         return;
     }
 
-    // Mark this slot as free
-    Header *h = Allocator::GetPointerFromData<Header>(pointer);
-    assert((h->size & 0x80000000u) == 0);
-    totalAllocated -= h->size;
-    h->size = h->size | 0x80000000u;
-
-    // Advance the free pointer past all free slots.
-    while (free != allocated) {
-        Header *h = (Header*)free;
-        if ((h->size & 0x80000000u) == 0)
-            break;
-
-        free += h->size & 0x7fffffffu;
-        if (free == end)
-            free = begin;
+    uint64_t tag = h->tag.load(std::memory_order_relaxed);
+    if (kBaseTag == tag) {
+        baseAllocator->Free(h);
+        return;
     }
+
+    PrivateBlock *block = reinterpret_cast<PrivateBlock*>(uintptr_t(tag));
+    if (1 == block->live.fetch_sub(1, std::memory_order_acq_rel))
+        this->FreePrivateBlock(block);
 }
 
 size_t
@@ -119,9 +274,15 @@ ScratchAllocator::GetAllocatedSize(void *pointer)
 }
 
 size_t
-ScratchAllocator::GetTotalAllocated()
+ScratchAllocator::GetReservedSize()
 {
-    return totalAllocated;
+    size_t size = end - begin;
+
+    std::lock_guard<std::mutex> guard(blocksMutex);
+    for (PrivateBlock *block = firstBlock; block != nullptr; block = block->next)
+        size += kPrivateBlockSize;
+
+    return size;
 }
 
 } // namespace Framework
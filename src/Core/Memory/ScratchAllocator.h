@@ -1,21 +1,68 @@
 #pragma once
 
+#include <atomic>
+#include <mutex>
 #include "Core/Memory/Memory.h"
 #include "Core/Memory/Allocator.h"
 
 namespace Framework {
 
+// Ring buffer for temporaries, safe to use from any thread. Space is reserved
+// with a CAS on the head counter and freed blocks are reclaimed in order from the
+// tail. When the ring is full or contended each thread bumps from a private
+// block, requests that fit neither go to the base allocator. Private blocks of
+// exited threads are reused by the next ones, or freed once nothing is live in them.
 class ScratchAllocator : public Allocator {
     DeclareClassInfo;
     DeclareAllocator(ScratchAllocator);
 private:
+    static const uint32_t kMaxInstances = 4;
+    static const uint32_t kMaxRetries = 4;
+    static const size_t   kPrivateBlockSize = 64 * 1024;
+
+    struct Header {
+        std::atomic<uint64_t> tag; // ring position << 1 | freed, a PrivateBlock or kBaseTag
+        uint32_t              size;
+        uint32_t              zero; // keeps the byte in front of the padding != kPaddingValue
+    };
+
+    struct PrivateBlock {
+        std::atomic<uint32_t> live; // allocations, plus one while a thread owns the block
+        uint8_t               *ptr;
+        uint8_t               *end;
+        PrivateBlock          *next;
+        bool                  owned;
+    };
+
+    struct PrivateBlockSlots {
+        PrivateBlock *blocks[kMaxInstances];
+
+        PrivateBlockSlots();
+        ~PrivateBlockSlots();
+    };
+
+    static std::atomic<ScratchAllocator*> instances[kMaxInstances];
+    static thread_local PrivateBlockSlots privateBlocks;
+
     Allocator *baseAllocator;
-    size_t totalAllocated;
+    uint32_t instanceId;
 
     uint8_t *begin, *end;
-    uint8_t *allocated, *free;
+    uint64_t mask;
+
+    alignas(64) std::atomic<uint64_t> head;
+    alignas(64) std::atomic<uint64_t> tail;
+    std::atomic_flag reclaiming;
+
+    std::mutex blocksMutex;
+    PrivateBlock *firstBlock;
 
-    bool InUse(uint8_t *pointer);
+    void Reclaim();
+    PrivateBlock* AcquirePrivateBlock();
+    void ReleasePrivateBlock(PrivateBlock *block);
+    void FreePrivateBlock(PrivateBlock *block);
+    void* AllocatePrivate(size_t ts, size_t align);
+    void* AllocateBase(size_t ts, size_t align);
 public:
     ScratchAllocator(Allocator *allocator, uint32_t size);
     virtual ~ScratchAllocator();
@@ -24,7 +71,7 @@ public:
     virtual void Free(void *pointer);
 
     virtual size_t GetAllocatedSize(void *pointer);
-    virtual size_t GetTotalAllocated();
+    virtual size_t GetReservedSize();
 };
 
 } // namespace Framework
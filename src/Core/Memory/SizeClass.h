@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include "Core/Debug.h"
+#include "Core/BitOps.h"
+
+namespace Framework {
+    namespace Memory {
+
+// 8 classes 16 bytes apart up to 128, then 4 classes per power of two.
+const uint32_t kNumSizeClasses = 8 + 4 * (32 - 7);
+
+inline uint32_t GetSizeClass(uint32_t size)
+{
+    assert(size > 0);
+    if (size <= 128)
+        return ((size + 15) >> 4) - 1;
+
+    uint32_t msb = FindLastSet(size - 1),
+             sub = ((size - 1) >> (msb - 2)) & 3;
+    return 8 + (msb - 7) * 4 + sub;
+}
+
+inline uint32_t GetSizeClassBlockSize(uint32_t sizeClass)
+{
+    if (sizeClass < 8)
+        return (sizeClass + 1) << 4;
+
+    uint32_t msb = 7 + ((sizeClass - 8) >> 2),
+             sub = (sizeClass - 8) & 3;
+    return (5 + sub) << (msb - 2);
+}
+
+    } // namespace Memory
+} // namespace Framework
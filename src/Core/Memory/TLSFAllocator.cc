@@ -0,0 +1,292 @@
+#include "Core/Memory/TLSFAllocator.h"
+#include "Core/BitOps.h"
+
+namespace Framework {
+
+DefineClassInfo(Framework::TLSFAllocator, Framework::Allocator);
+DefineAllocator(Framework::TLSFAllocator);
+
+void
+TLSFAllocator::MappingInsert(size_t size, uint32_t &fl, uint32_t &sl)
+{
+    if (size < kSmallBlockSize) {
+        fl = 0;
+        sl = uint32_t(size) / uint32_t(kSmallBlockSize / kSLIndexCount);
+    } else {
+        uint32_t msb = FindLastSet(uint64_t(size));
+        fl = msb - (kFLIndexShift - 1);
+        sl = uint32_t(size >> (msb - kSLIndexLog2)) ^ kSLIndexCount;
+    }
+}
+
+void
+TLSFAllocator::MappingSearch(size_t size, uint32_t &fl, uint32_t &sl)
+{
+    // Round up to the next second level class so any block in it fits.
+    if (size >= kSmallBlockSize)
+        size += (size_t(1) << (FindLastSet(uint64_t(size)) - kSLIndexLog2)) - 1;
+    MappingInsert(size, fl, sl);
+}
+
+void
+TLSFAllocator::InsertFreeBlock(FreeBlock *block)
+{
+    uint32_t fl, sl;
+    MappingInsert(GetBlockSize(block), fl, sl);
+
+    FreeBlock *head = control->blocks[fl][sl];
+    block->nextFree = head;
+    block->prevFree = nullptr;
+    if (head != nullptr)
+        head->prevFree = block;
+    control->blocks[fl][sl] = block;
+
+    control->flBitmap |= 1u << fl;
+    control->slBitmap[fl] |= 1u << sl;
+}
+
+void
+TLSFAllocator::RemoveFreeBlock(FreeBlock *block)
+{
+    uint32_t fl, sl;
+    MappingInsert(GetBlockSize(block), fl, sl);
+
+    if (block->nextFree != nullptr)
+        block->nextFree->prevFree = block->prevFree;
+    if (block->prevFree != nullptr)
+        block->prevFree->nextFree = block->nextFree;
+    else {
+        control->blocks[fl][sl] = block->nextFree;
+        if (nullptr == block->nextFree) {
+            control->slBitmap[fl] &= ~(1u << sl);
+            if (0 == control->slBitmap[fl])
+                control->flBitmap &= ~(1u << fl);
+        }
+    }
+}
+
+TLSFAllocator::FreeBlock*
+TLSFAllocator::FindFreeBlock(size_t size)
+{
+    uint32_t fl, sl;
+    MappingSearch(size, fl, sl);
+    if (fl >= kFLIndexCount)
+        return nullptr;
+
+    uint32_t slMap = control->slBitmap[fl] & (~0u << sl);
+    if (0 == slMap) {
+        uint32_t flMap = fl + 1 < 32 ? control->flBitmap & (~0u << (fl + 1)) : 0;
+        if (0 == flMap)
+            return nullptr;
+
+        fl = CountTrailingZeros(flMap);
+        slMap = control->slBitmap[fl];
+    }
+    sl = CountTrailingZeros(slMap);
+
+    FreeBlock *block = control->blocks[fl][sl];
+    assert(block != nullptr && GetBlockSize(block) >= size);
+    this->RemoveFreeBlock(block);
+    return block;
+}
+
+void
+TLSFAllocator::AddPoolLocked(size_t size)
+{
+    // Pool header, one free block spanning the pool and a zero sized used
+    // block at the end that stops coalescing.
+    size = (size + kMinBlockSize - 1) & ~(kMinBlockSize - 1);
+    size_t blockSize = size - sizeof(Pool) - 2 * sizeof(BlockHeader);
+    assert(size > sizeof(Pool) + 2 * sizeof(BlockHeader) + kMinBlockSize);
+    assert(blockSize < (size_t(1) << (kFLIndexMax - 1)));
+
+    Pool *pool = static_cast<Pool*>(baseAllocator->Allocate(size, kMinBlockSize));
+    pool->next = firstPool;
+    pool->size = size;
+    firstPool = pool;
+    reservedSize += size;
+
+    FreeBlock *block = reinterpret_cast<FreeBlock*>(pool + 1);
+    block->prevPhysical = nullptr;
+    block->size = blockSize | kFreeFlag;
+
+    BlockHeader *sentinel = reinterpret_cast<BlockHeader*>(GetPayload(block) + blockSize);
+    sentinel->prevPhysical = block;
+    sentinel->size = kPrevFreeFlag;
+
+    this->InsertFreeBlock(block);
+}
+
+TLSFAllocator::TLSFAllocator(Allocator *allocator, size_t _poolSize)
+: baseAllocator(allocator),
+  poolSize(_poolSize),
+  reservedSize(0),
+  firstPool(nullptr)
+{
+    static_assert(sizeof(BlockHeader) == 2 * sizeof(void*), "unexpected BlockHeader padding");
+    assert(0 == (sizeof(Pool) % kMinBlockSize) && 0 == (sizeof(BlockHeader) % kMinBlockSize));
+
+    control = static_cast<Control*>(baseAllocator->Allocate(sizeof(Control), __alignof(Control)));
+    Memory::Zero(control);
+
+    this->AddPoolLocked(poolSize);
+}
+
+TLSFAllocator::~TLSFAllocator()
+{
+    assert(0 == this->GetTotalAllocated());
+
+    Pool *pool = firstPool, *tmp;
+    while (pool != nullptr) {
+        tmp = pool;
+        pool = pool->next;
+        baseAllocator->Free(tmp);
+    }
+    baseAllocator->Free(control);
+}
+
+void*
+TLSFAllocator::Allocate(size_t size, size_t align)
+{
+    // Payloads are always kMinBlockSize aligned, padding is only needed above that.
+    size_t ts = align > kMinBlockSize ? Allocator::GetAlignedSize(size, align) : size;
+    ts = ts < kMinBlockSize ? kMinBlockSize : (ts + kMinBlockSize - 1) & ~(kMinBlockSize - 1);
+
+    std::lock_guard<std::mutex> guard(mutex);
+
+    FreeBlock *block = this->FindFreeBlock(ts);
+    if (nullptr == block) {
+        size_t needed = ts + sizeof(Pool) + 2 * sizeof(BlockHeader);
+        if (ts >= kSmallBlockSize)
+            needed += size_t(1) << (FindLastSet(uint64_t(ts)) - kSLIndexLog2);
+        this->AddPoolLocked(needed > poolSize ? needed : poolSize);
+
+        block = this->FindFreeBlock(ts);
+        assert2(block != nullptr, "TLSFAllocator out of memory");
+    }
+
+    size_t blockSize = GetBlockSize(block);
+    BlockHeader *next = reinterpret_cast<BlockHeader*>(GetPayload(block) + blockSize);
+    if (blockSize >= ts + sizeof(BlockHeader) + kMinBlockSize) {
+        // Split, the remainder stays free and its physical successor keeps the prev free flag.
+        FreeBlock *rest = reinterpret_cast<FreeBlock*>(GetPayload(block) + ts);
+        rest->prevPhysical = block;
+        rest->size = (blockSize - ts - sizeof(BlockHeader)) | kFreeFlag;
+        next->prevPhysical = rest;
+
+        block->size = ts | (block->size & kPrevFreeFlag);
+        this->InsertFreeBlock(rest);
+    } else {
+        block->size &= ~kFreeFlag;
+        next->size &= ~kPrevFreeFlag;
+    }
+    this->TrackAllocation(GetBlockSize(block));
+
+    void *d = Allocator::GetDataFromPointer<BlockHeader>(block, align);
+
+    Allocator::FillPadding<BlockHeader>(block, d);
+
+    return d;
+}
+
+void
+TLSFAllocator::Free(void *pointer)
+{
+    if (nullptr == pointer)
+        return;
+
+    BlockHeader *h = Allocator::GetPointerFromData<BlockHeader>(pointer);
+    assert(0 == (h->size & kFreeFlag));
+    this->TrackFree(GetBlockSize(h));
+
+    std::lock_guard<std::mutex> guard(mutex);
+
+    FreeBlock *block = static_cast<FreeBlock*>(h);
+    if (block->size & kPrevFreeFlag) {
+        FreeBlock *prev = static_cast<FreeBlock*>(block->prevPhysical);
+        this->RemoveFreeBlock(prev);
+        prev->size += sizeof(BlockHeader) + GetBlockSize(block);
+        block = prev;
+    } else {
+        block->size |= kFreeFlag;
+    }
+
+    BlockHeader *next = reinterpret_cast<BlockHeader*>(GetPayload(block) + GetBlockSize(block));
+    if (next->size & kFreeFlag) {
+        this->RemoveFreeBlock(static_cast<FreeBlock*>(next));
+        block->size += sizeof(BlockHeader) + GetBlockSize(next);
+        next = reinterpret_cast<BlockHeader*>(GetPayload(block) + GetBlockSize(block));
+    }
+    next->prevPhysical = block;
+    next->size |= kPrevFreeFlag;
+
+    this->InsertFreeBlock(block);
+}
+
+bool
+TLSFAllocator::TryExpand(void *pointer, size_t oldSize, size_t newSize)
+{
+    BlockHeader *block = Allocator::GetPointerFromData<BlockHeader>(pointer);
+
+    size_t ts = ((uint8_t*)pointer - GetPayload(block)) + newSize;
+    ts = ts < kMinBlockSize ? kMinBlockSize : (ts + kMinBlockSize - 1) & ~(kMinBlockSize - 1);
+
+    std::lock_guard<std::mutex> guard(mutex);
+
+    size_t oldBlockSize = GetBlockSize(block);
+    BlockHeader *next = reinterpret_cast<BlockHeader*>(GetPayload(block) + oldBlockSize);
+    if (ts > oldBlockSize) {
+        // Grow into the physical successor if it's free and big enough.
+        if (0 == (next->size & kFreeFlag) || oldBlockSize + sizeof(BlockHeader) + GetBlockSize(next) < ts)
+            return false;
+
+        this->RemoveFreeBlock(static_cast<FreeBlock*>(next));
+        block->size += sizeof(BlockHeader) + GetBlockSize(next);
+        next = reinterpret_cast<BlockHeader*>(GetPayload(block) + GetBlockSize(block));
+        next->size &= ~kPrevFreeFlag;
+    }
+
+    size_t blockSize = GetBlockSize(block);
+    if (blockSize >= ts + sizeof(BlockHeader) + kMinBlockSize) {
+        // Give the tail back, merged with the successor when that one is free.
+        FreeBlock *rest = reinterpret_cast<FreeBlock*>(GetPayload(block) + ts);
+        rest->prevPhysical = block;
+        rest->size = (blockSize - ts - sizeof(BlockHeader)) | kFreeFlag;
+        block->size = ts | (block->size & kPrevFreeFlag);
+
+        if (next->size & kFreeFlag) {
+            this->RemoveFreeBlock(static_cast<FreeBlock*>(next));
+            rest->size += sizeof(BlockHeader) + GetBlockSize(next);
+            next = reinterpret_cast<BlockHeader*>(GetPayload(rest) + GetBlockSize(rest));
+        }
+        next->prevPhysical = rest;
+        next->size |= kPrevFreeFlag;
+
+        this->InsertFreeBlock(rest);
+    }
+    this->TrackResize(oldBlockSize, GetBlockSize(block));
+
+    return true;
+}
+
+size_t
+TLSFAllocator::GetAllocatedSize(void *pointer)
+{
+    return GetBlockSize(Allocator::GetPointerFromData<BlockHeader>(pointer));
+}
+
+size_t
+TLSFAllocator::GetReservedSize()
+{
+    std::lock_guard<std::mutex> guard(mutex);
+    return reservedSize;
+}
+
+void
+TLSFAllocator::AddPool(size_t size)
+{
+    std::lock_guard<std::mutex> guard(mutex);
+    this->AddPoolLocked(size);
+}
+
+} // namespace Framework
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <mutex>
+#include "Core/Memory/Memory.h"
+#include "Core/Memory/Allocator.h"
+
+namespace Framework {
+
+// Two level segregated fit allocator, allocate and free are O(1) and free blocks
+// are coalesced with their physical neighbours right away. Memory comes from
+// large pools taken from the base allocator, a new pool is added when no free
+// block fits the request.
+class TLSFAllocator : public Allocator {
+    DeclareClassInfo;
+    DeclareAllocator(TLSFAllocator);
+private:
+    static const uint32_t kAlignLog2 = 4;
+    static const uint32_t kSLIndexLog2 = 5;
+    static const uint32_t kSLIndexCount = 1 << kSLIndexLog2;
+    static const uint32_t kFLIndexMax = 32;
+    static const uint32_t kFLIndexShift = kSLIndexLog2 + kAlignLog2;
+    static const uint32_t kFLIndexCount = kFLIndexMax - kFLIndexShift + 1;
+    static const size_t   kSmallBlockSize = size_t(1) << kFLIndexShift;
+    static const size_t   kMinBlockSize = size_t(1) << kAlignLog2;
+
+    static const size_t kFreeFlag = 1;
+    static const size_t kPrevFreeFlag = 2;
+
+    // Physical header in front of every block, size is the payload size and
+    // its low bits hold the free flags.
+    struct BlockHeader {
+        BlockHeader *prevPhysical;
+        size_t      size;
+    };
+
+    // Free blocks keep the list links in their payload.
+    struct FreeBlock : public BlockHeader {
+        FreeBlock *nextFree;
+        FreeBlock *prevFree;
+    };
+
+    struct Pool {
+        Pool   *next;
+        size_t size;
+    };
+
+    struct Control {
+        uint32_t  flBitmap;
+        uint32_t  slBitmap[kFLIndexCount];
+        FreeBlock *blocks[kFLIndexCount][kSLIndexCount];
+    };
+
+    Allocator *baseAllocator;
+    size_t poolSize;
+    size_t reservedSize;
+
+    Control *control;
+    Pool *firstPool;
+
+    std::mutex mutex;
+
+    static size_t GetBlockSize(const BlockHeader *block);
+    static uint8_t* GetPayload(BlockHeader *block);
+
+    static void MappingInsert(size_t size, uint32_t &fl, uint32_t &sl);
+    static void MappingSearch(size_t size, uint32_t &fl, uint32_t &sl);
+
+    void InsertFreeBlock(FreeBlock *block);
+    void RemoveFreeBlock(FreeBlock *block);
+    FreeBlock* FindFreeBlock(size_t size);
+
+    void AddPoolLocked(size_t size);
+public:
+    TLSFAllocator(Allocator *allocator, size_t _poolSize);
+    virtual ~TLSFAllocator();
+
+    virtual void* Allocate(size_t size, size_t align);
+    virtual void Free(void *pointer);
+
+    virtual bool TryExpand(void *pointer, size_t oldSize, size_t newSize);
+
+    virtual size_t GetAllocatedSize(void *pointer);
+    virtual size_t GetReservedSize();
+
+    void AddPool(size_t size);
+};
+
+inline size_t
+TLSFAllocator::GetBlockSize(const BlockHeader *block)
+{
+    return block->size & ~(kFreeFlag | kPrevFreeFlag);
+}
+
+inline uint8_t*
+TLSFAllocator::GetPayload(BlockHeader *block)
+{
+    return (uint8_t*)block + sizeof(BlockHeader);
+}
+
+} // namespace Framework
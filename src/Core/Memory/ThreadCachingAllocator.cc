@@ -0,0 +1,414 @@
+#include <thread>
+#include "Core/Memory/ThreadCachingAllocator.h"
+#include "Core/Memory/MemoryStats.h"
+
+namespace Framework {
+
+DefineClassInfo(Framework::ThreadCachingAllocator, Framework::Allocator);
+DefineAllocator(Framework::ThreadCachingAllocator);
+
+static std::atomic<uint32_t> nextInstanceId(0);
+
+std::atomic<ThreadCachingAllocator*> ThreadCachingAllocator::instances[kMaxInstances];
+thread_local ThreadCachingAllocator::ThreadCacheSlots ThreadCachingAllocator::threadCaches;
+
+static inline void
+SpinLock(std::atomic_flag &lock)
+{
+    while (lock.test_and_set(std::memory_order_acquire))
+        std::this_thread::yield();
+}
+
+static inline void
+SpinUnlock(std::atomic_flag &lock)
+{
+    lock.clear(std::memory_order_release);
+}
+
+// Counters are only written by their owning thread, readers just need untorn values.
+template <typename T>
+static inline void
+AddRelaxed(std::atomic<T> &counter, T value)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+ThreadCachingAllocator::ThreadCacheSlots::ThreadCacheSlots()
+{
+    for (uint32_t i = 0; i < kMaxInstances; ++i)
+        caches[i] = nullptr;
+}
+
+ThreadCachingAllocator::ThreadCacheSlots::~ThreadCacheSlots()
+{
+    for (uint32_t i = 0; i < kMaxInstances; ++i) {
+        if (nullptr == caches[i])
+            continue;
+
+        ThreadCachingAllocator *owner = instances[i].load();
+        if (owner != nullptr)
+            owner->ReleaseThreadCache(caches[i]);
+        caches[i] = nullptr;
+    }
+}
+
+uint32_t
+ThreadCachingAllocator::GetMagazineCapacity(uint32_t sizeClass)
+{
+    uint32_t capacity = (kSpanSize / 4) / Memory::GetSizeClassBlockSize(sizeClass);
+    return capacity < 4 ? 4 : (capacity > 64 ? 64 : capacity);
+}
+
+inline ThreadCachingAllocator::ThreadCache*
+ThreadCachingAllocator::GetThreadCache()
+{
+    ThreadCache *&cache = threadCaches.caches[instanceId];
+    if (nullptr == cache)
+        cache = this->AcquireThreadCache();
+    return cache;
+}
+
+ThreadCachingAllocator::ThreadCache*
+ThreadCachingAllocator::AcquireThreadCache()
+{
+    std::lock_guard<std::mutex> guard(backendMutex);
+
+    ThreadCache *cache = firstCache;
+    while (cache != nullptr && cache->inUse)
+        cache = cache->next;
+
+    if (nullptr == cache) {
+        cache = new (baseAllocator->Allocate(sizeof(ThreadCache), __alignof(ThreadCache))) ThreadCache();
+        cache->next = firstCache;
+        firstCache = cache;
+    }
+
+    cache->inUse = true;
+    return cache;
+}
+
+void
+ThreadCachingAllocator::ReleaseThreadCache(ThreadCache *cache)
+{
+    for (uint32_t i = 0; i < numCachedClasses; ++i)
+        this->Flush(cache->magazines[i], i, cache->magazines[i].count);
+
+    std::lock_guard<std::mutex> guard(backendMutex);
+    cache->inUse = false;
+}
+
+ThreadCachingAllocator::FreeBlock*
+ThreadCachingAllocator::AllocateSpan(uint32_t sizeClass, uint32_t &outCount)
+{
+    uint32_t blockSize = Memory::GetSizeClassBlockSize(sizeClass),
+             spanSize  = kSpanSize < blockSize * 8 ? blockSize * 8 : kSpanSize;
+
+    uintptr_t spanHeaderSize = (sizeof(Span) + 15) & ~uintptr_t(15);
+    outCount = uint32_t((spanSize - spanHeaderSize) / blockSize);
+
+    Span *span;
+    {
+        std::lock_guard<std::mutex> guard(backendMutex);
+        span = static_cast<Span*>(baseAllocator->Allocate(spanSize, 16));
+        span->next = firstSpan;
+        firstSpan = span;
+        reservedSize += spanSize;
+    }
+
+    uintptr_t block = uintptr_t(span) + spanHeaderSize;
+    FreeBlock *head = reinterpret_cast<FreeBlock*>(block);
+    for (uint32_t i = 1; i < outCount; ++i, block += blockSize)
+        reinterpret_cast<FreeBlock*>(block)->next = reinterpret_cast<FreeBlock*>(block + blockSize);
+    reinterpret_cast<FreeBlock*>(block)->next = nullptr;
+
+    return head;
+}
+
+void
+ThreadCachingAllocator::Refill(Magazine &magazine, uint32_t sizeClass)
+{
+    assert(0 == magazine.count);
+    uint32_t batch = GetMagazineCapacity(sizeClass) / 2;
+
+    CentralList &central = centralLists[sizeClass];
+    SpinLock(central.lock);
+    FreeBlock *head = central.head, *tail = nullptr, *it = head;
+    uint32_t count = 0;
+    while (it != nullptr && count < batch) {
+        tail = it;
+        it = it->next;
+        ++count;
+    }
+    central.head = it;
+    central.count -= count;
+    SpinUnlock(central.lock);
+
+    if (count > 0) {
+        tail->next = nullptr;
+        magazine.head = head;
+        magazine.count = count;
+        return;
+    }
+
+    // Central list is dry, carve a new span: one batch to the magazine, the rest is shared.
+    uint32_t spanCount;
+    head = this->AllocateSpan(sizeClass, spanCount);
+    it = head;
+    for (count = 1; count < batch && count < spanCount; ++count)
+        it = it->next;
+
+    FreeBlock *rest = it->next;
+    it->next = nullptr;
+    magazine.head = head;
+    magazine.count = count;
+
+    if (rest != nullptr) {
+        tail = rest;
+        while (tail->next != nullptr)
+            tail = tail->next;
+
+        SpinLock(central.lock);
+        tail->next = central.head;
+        central.head = rest;
+        central.count += spanCount - count;
+        SpinUnlock(central.lock);
+    }
+}
+
+void
+ThreadCachingAllocator::Flush(Magazine &magazine, uint32_t sizeClass, uint32_t count)
+{
+    if (0 == count)
+        return;
+    assert(count <= magazine.count);
+
+    FreeBlock *head = magazine.head, *tail = head;
+    for (uint32_t i = 1; i < count; ++i)
+        tail = tail->next;
+
+    magazine.head = tail->next;
+    magazine.count -= count;
+
+    CentralList &central = centralLists[sizeClass];
+    SpinLock(central.lock);
+    tail->next = central.head;
+    central.head = head;
+    central.count += count;
+    SpinUnlock(central.lock);
+}
+
+ThreadCachingAllocator::ThreadCachingAllocator(Allocator *allocator)
+: baseAllocator(allocator),
+  instanceId(nextInstanceId++),
+  numCachedClasses(Memory::GetSizeClass(kMaxCachedSize) + 1),
+  firstSpan(nullptr),
+  firstCache(nullptr),
+  reservedSize(0),
+  frameStartAllocCount(0)
+{
+    assert(instanceId < kMaxInstances);
+
+    centralLists = static_cast<CentralList*>(baseAllocator->Allocate(sizeof(CentralList) * numCachedClasses, __alignof(CentralList)));
+    for (uint32_t i = 0; i < numCachedClasses; ++i) {
+        centralLists[i].lock.clear();
+        centralLists[i].head = nullptr;
+        centralLists[i].count = 0;
+    }
+
+    instances[instanceId] = this;
+}
+
+ThreadCachingAllocator::~ThreadCachingAllocator()
+{
+    assert(0 == this->GetTotalAllocated());
+
+    instances[instanceId] = nullptr;
+
+    ThreadCache *cache = firstCache, *tmpCache;
+    while (cache != nullptr) {
+        tmpCache = cache;
+        cache = cache->next;
+        baseAllocator->Free(tmpCache);
+    }
+
+    Span *span = firstSpan, *tmpSpan;
+    while (span != nullptr) {
+        tmpSpan = span;
+        span = span->next;
+        baseAllocator->Free(tmpSpan);
+    }
+
+    baseAllocator->Free(centralLists);
+}
+
+void*
+ThreadCachingAllocator::Allocate(size_t size, size_t align)
+{
+    void *d = nullptr;
+
+    size_t ts = Allocator::GetAlignedSize<Header>(size, align);
+
+    ThreadCache *cache = this->GetThreadCache();
+
+    Header *h = nullptr;
+    if (ts > kMaxCachedSize) {
+        std::lock_guard<std::mutex> guard(backendMutex);
+        h = static_cast<Header*>(baseAllocator->Allocate(ts, __alignof(Header)));
+        h->sizeClass = kLargeSizeClass;
+
+        size_t blockSize = baseAllocator->GetAllocatedSize(h);
+        reservedSize += blockSize;
+        AddRelaxed<int64_t>(cache->allocated, blockSize);
+    } else {
+        uint32_t sizeClass = Memory::GetSizeClass(uint32_t(ts));
+
+        Magazine &magazine = cache->magazines[sizeClass];
+        if (0 == magazine.count)
+            this->Refill(magazine, sizeClass);
+
+        FreeBlock *block = magazine.head;
+        magazine.head = block->next;
+        --magazine.count;
+
+        h = reinterpret_cast<Header*>(block);
+        h->sizeClass = sizeClass;
+        AddRelaxed<int64_t>(cache->allocated, Memory::GetSizeClassBlockSize(sizeClass));
+    }
+    AddRelaxed<uint64_t>(cache->allocCount, 1);
+    Memory::TrackTaggedAllocation(ts);
+
+    d = Allocator::GetDataFromPointer<Header>(h, align);
+
+    Allocator::FillPadding(h, d);
+
+    return d;
+}
+
+void
+ThreadCachingAllocator::Free(void *pointer)
+{
+    if (nullptr == pointer)
+        return;
+
+    Header *h = Allocator::GetPointerFromData<Header>(pointer);
+
+    ThreadCache *cache = this->GetThreadCache();
+    AddRelaxed<uint64_t>(cache->freeCount, 1);
+
+    if (kLargeSizeClass == h->sizeClass) {
+        size_t blockSize = baseAllocator->GetAllocatedSize(h);
+        AddRelaxed<int64_t>(cache->allocated, -int64_t(blockSize));
+
+        std::lock_guard<std::mutex> guard(backendMutex);
+        reservedSize -= blockSize;
+        baseAllocator->Free(h);
+    } else {
+        uint32_t sizeClass = h->sizeClass;
+        assert(sizeClass < numCachedClasses);
+        AddRelaxed<int64_t>(cache->allocated, -int64_t(Memory::GetSizeClassBlockSize(sizeClass)));
+
+        Magazine &magazine = cache->magazines[sizeClass];
+        FreeBlock *block = reinterpret_cast<FreeBlock*>(h);
+        block->next = magazine.head;
+        magazine.head = block;
+
+        uint32_t capacity = GetMagazineCapacity(sizeClass);
+        if (++magazine.count > capacity)
+            this->Flush(magazine, sizeClass, capacity / 2);
+    }
+}
+
+bool
+ThreadCachingAllocator::TryExpand(void *pointer, size_t oldSize, size_t newSize)
+{
+    Header *h = Allocator::GetPointerFromData<Header>(pointer);
+    if (kLargeSizeClass == h->sizeClass)
+        return false;
+    return (uintptr_t(pointer) - uintptr_t(h)) + newSize <= Memory::GetSizeClassBlockSize(h->sizeClass);
+}
+
+size_t
+ThreadCachingAllocator::GetAllocatedSize(void *pointer)
+{
+    Header *h = Allocator::GetPointerFromData<Header>(pointer);
+    if (kLargeSizeClass == h->sizeClass)
+        return baseAllocator->GetAllocatedSize(h);
+    else
+        return Memory::GetSizeClassBlockSize(h->sizeClass);
+}
+
+size_t
+ThreadCachingAllocator::GetTotalAllocated()
+{
+    std::lock_guard<std::mutex> guard(backendMutex);
+    int64_t total = 0;
+    for (ThreadCache *cache = firstCache; cache != nullptr; cache = cache->next)
+        total += cache->allocated.load(std::memory_order_relaxed);
+    return size_t(total);
+}
+
+size_t
+ThreadCachingAllocator::GetReservedSize()
+{
+    std::lock_guard<std::mutex> guard(backendMutex);
+    return reservedSize;
+}
+
+void
+ThreadCachingAllocator::GetStats(AllocatorStats &stats)
+{
+    // Counters live in the thread caches, the peak is only sampled when queried.
+    stats.allocCount      = this->GetAllocationsCount();
+    stats.freeCount       = this->GetFreesCount();
+    stats.bytesInUse      = this->GetTotalAllocated();
+    stats.reservedBytes   = this->GetReservedSize();
+    stats.frameAllocCount = lastFrameAllocCount;
+
+    size_t peak = peakBytes.load(std::memory_order_relaxed);
+    if (stats.bytesInUse > peak) {
+        peak = stats.bytesInUse;
+        peakBytes.store(peak, std::memory_order_relaxed);
+    }
+    stats.peakBytes = peak;
+}
+
+void
+ThreadCachingAllocator::NewFrame()
+{
+    uint64_t count = this->GetAllocationsCount();
+    lastFrameAllocCount = uint32_t(count - frameStartAllocCount);
+    frameStartAllocCount = count;
+}
+
+uint64_t
+ThreadCachingAllocator::GetAllocationsCount()
+{
+    std::lock_guard<std::mutex> guard(backendMutex);
+    uint64_t total = 0;
+    for (ThreadCache *cache = firstCache; cache != nullptr; cache = cache->next)
+        total += cache->allocCount.load(std::memory_order_relaxed);
+    return total;
+}
+
+uint64_t
+ThreadCachingAllocator::GetFreesCount()
+{
+    std::lock_guard<std::mutex> guard(backendMutex);
+    uint64_t total = 0;
+    for (ThreadCache *cache = firstCache; cache != nullptr; cache = cache->next)
+        total += cache->freeCount.load(std::memory_order_relaxed);
+    return total;
+}
+
+void
+ThreadCachingAllocator::FlushThreadCache()
+{
+    ThreadCache *cache = threadCaches.caches[instanceId];
+    if (nullptr == cache)
+        return;
+
+    for (uint32_t i = 0; i < numCachedClasses; ++i)
+        this->Flush(cache->magazines[i], i, cache->magazines[i].count);
+}
+
+} // namespace Framework
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include "Core/Memory/Memory.h"
+#include "Core/Memory/Allocator.h"
+#include "Core/Memory/SizeClass.h"
+
+namespace Framework {
+
+// Thread safe allocator, every thread owns a magazine of free blocks per size class
+// and only touches the shared free lists (one lock per size class) to refill or flush it.
+class ThreadCachingAllocator : public Allocator {
+    DeclareClassInfo;
+    DeclareAllocator(ThreadCachingAllocator);
+private:
+    static const uint32_t kMaxInstances = 4;
+    static const uint32_t kMaxCachedSize = 32 * 1024;
+    static const uint32_t kLargeSizeClass = 0xffffffff;
+    static const uint32_t kSpanSize = 64 * 1024;
+
+    struct Header {
+        uint32_t sizeClass;
+    };
+
+    struct FreeBlock {
+        FreeBlock *next;
+    };
+
+    struct Span {
+        Span *next;
+    };
+
+    struct Magazine {
+        FreeBlock *head;
+        uint32_t  count;
+    };
+
+    struct alignas(64) CentralList {
+        std::atomic_flag lock;
+        FreeBlock        *head;
+        uint32_t         count;
+    };
+
+    struct ThreadCache {
+        Magazine magazines[Memory::kNumSizeClasses];
+        std::atomic<int64_t>  allocated;
+        std::atomic<uint64_t> allocCount;
+        std::atomic<uint64_t> freeCount;
+        ThreadCache *next;
+        bool inUse;
+    };
+
+    struct ThreadCacheSlots {
+        ThreadCache *caches[kMaxInstances];
+
+        ThreadCacheSlots();
+        ~ThreadCacheSlots();
+    };
+
+    static std::atomic<ThreadCachingAllocator*> instances[kMaxInstances];
+    static thread_local ThreadCacheSlots threadCaches;
+
+    Allocator *baseAllocator;
+    uint32_t instanceId;
+    uint32_t numCachedClasses;
+
+    CentralList *centralLists;
+
+    std::mutex backendMutex;
+    Span *firstSpan;
+    ThreadCache *firstCache;
+    size_t reservedSize;
+
+    uint64_t frameStartAllocCount;
+
+    static uint32_t GetMagazineCapacity(uint32_t sizeClass);
+
+    ThreadCache* GetThreadCache();
+    ThreadCache* AcquireThreadCache();
+    void ReleaseThreadCache(ThreadCache *cache);
+
+    void Refill(Magazine &magazine, uint32_t sizeClass);
+    void Flush(Magazine &magazine, uint32_t sizeClass, uint32_t count);
+    FreeBlock* AllocateSpan(uint32_t sizeClass, uint32_t &outCount);
+public:
+    ThreadCachingAllocator(Allocator *allocator);
+    virtual ~ThreadCachingAllocator();
+
+    virtual void* Allocate(size_t size, size_t align);
+    virtual void Free(void *pointer);
+
+    virtual bool TryExpand(void *pointer, size_t oldSize, size_t newSize);
+
+    virtual size_t GetAllocatedSize(void *pointer);
+    virtual size_t GetTotalAllocated();
+    virtual size_t GetReservedSize();
+
+    virtual void GetStats(AllocatorStats &stats);
+    virtual void NewFrame();
+
+    uint64_t GetAllocationsCount();
+    uint64_t GetFreesCount();
+
+    void FlushThreadCache();
+};
+
+} // namespace Framework
@@ -0,0 +1,65 @@
+#include "Core/Memory/VirtualMemory.h"
+
+#ifdef _WIN32
+#	define NOMINMAX
+#   include <windows.h>
+#else
+#   include <sys/mman.h>
+#   include <unistd.h>
+#endif
+
+namespace Framework {
+    namespace Memory {
+
+size_t GetVirtualPageSize()
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwPageSize;
+#else
+    return size_t(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+void* ReserveVirtual(size_t size)
+{
+#ifdef _WIN32
+    return VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+#else
+    void *p = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return MAP_FAILED == p ? nullptr : p;
+#endif
+}
+
+void ReleaseVirtual(void *pointer, size_t size)
+{
+#ifdef _WIN32
+    VirtualFree(pointer, 0, MEM_RELEASE);
+#else
+    munmap(pointer, size);
+#endif
+}
+
+bool CommitVirtual(void *pointer, size_t size)
+{
+#ifdef _WIN32
+    return VirtualAlloc(pointer, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#else
+    return 0 == mprotect(pointer, size, PROT_READ | PROT_WRITE);
+#endif
+}
+
+void DecommitVirtual(void *pointer, size_t size)
+{
+#ifdef _WIN32
+    VirtualFree(pointer, size, MEM_DECOMMIT);
+#else
+    // Drop the physical pages first, then make the range inaccessible again.
+    madvise(pointer, size, MADV_DONTNEED);
+    mprotect(pointer, size, PROT_NONE);
+#endif
+}
+
+    } // namespace Memory
+} // namespace Framework
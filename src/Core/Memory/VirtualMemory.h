@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Framework {
+    namespace Memory {
+
+size_t GetVirtualPageSize();
+
+void* ReserveVirtual(size_t size);
+void ReleaseVirtual(void *pointer, size_t size);
+
+bool CommitVirtual(void *pointer, size_t size);
+void DecommitVirtual(void *pointer, size_t size);
+
+    } // namespace Memory
+} // namespace Framework
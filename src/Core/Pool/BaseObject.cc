@@ -38,4 +38,11 @@ BaseObject::Destroy()
     pool->Free(this);
 }
 
+void
+BaseObject::MarkForDestruction()
+{
+    assert(pool);
+    pool->MarkForDestruction(this);
+}
+
 } // namespace Framework
@@ -22,6 +22,7 @@ public:
     uint32_t GetInstanceID() const;
 
     void Destroy();
+    void MarkForDestruction();
 
     friend class BasePool;
 };
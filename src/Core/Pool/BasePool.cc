@@ -1,74 +1,130 @@
+#include <cstring>
 #include "Core/Pool/BasePool.h"
 #include "Core/Collections/Array.h"
 #include "Core/Pool/BaseObject.h"
 #include "Core/Memory/Memory.h"
 #include "Core/Memory/Allocator.h"
+#include "Core/BitOps.h"
 
 namespace Framework {
 
-BasePool::BasePool(Allocator &allocator, ClassInfo *_classInfo)
-: nextId(0),
-  classInfo(_classInfo),
-  map(allocator),
-  entries(allocator),
+BasePool::BasePool(Allocator &allocator, ClassInfo *_classInfo, Storage _storage)
+: classInfo(_classInfo),
+  objectSize(uint32_t(_classInfo->GetSize())),
+  slots(allocator),
+  freeHead(kEndOfList),
+  freeTail(kEndOfList),
+  retiredHead(kEndOfList),
+  storage(_storage),
   data(nullptr),
   size(0),
-  capacity(0)
+  capacity(0),
+  chunks(allocator),
+  occupancy(allocator),
+  freeObject(kEndOfList),
+  markedIds(allocator),
+  destroyingIndices(allocator),
+  retiredData(allocator),
+  deadCount(0),
+  destroyingMarked(false),
+  reorderIds(allocator),
+  reorderCursor(0),
+  reorderPlace(0),
+  reorderScratch(nullptr)
 { }
 
 BasePool::BasePool(const BasePool &other)
-: nextId(other.nextId),
-  classInfo(other.classInfo),
-  map(other.map),
-  entries(other.entries),
+: classInfo(other.classInfo),
+  objectSize(other.objectSize),
+  slots(other.slots),
+  freeHead(other.freeHead),
+  freeTail(other.freeTail),
+  retiredHead(other.retiredHead),
+  storage(other.storage),
   data(nullptr),
   size(other.size),
-  capacity(other.capacity)
-{
-    data = this->GetAllocator().Allocate(classInfo->GetSize() * capacity, classInfo->GetAlign());
-}
+  capacity(other.capacity),
+  chunks(other.GetAllocator()),
+  occupancy(other.occupancy),
+  freeObject(other.freeObject),
+  markedIds(other.markedIds),
+  destroyingIndices(other.GetAllocator()),
+  retiredData(other.GetAllocator()),
+  deadCount(0),
+  destroyingMarked(false),
+  reorderIds(other.GetAllocator()),
+  reorderCursor(0),
+  reorderPlace(0),
+  reorderScratch(nullptr)
+{ }
 
 BasePool::BasePool(BasePool &&other)
-: nextId(other.nextId),
-  classInfo(other.classInfo),
-  map(std::forward<Array<uint32_t>>(other.map)),
-  entries(std::forward<Array<Entry>>(other.entries)),
+: classInfo(other.classInfo),
+  objectSize(other.objectSize),
+  slots(std::forward<Array<Slot>>(other.slots)),
+  freeHead(other.freeHead),
+  freeTail(other.freeTail),
+  retiredHead(other.retiredHead),
+  storage(other.storage),
   data(other.data),
   size(other.size),
-  capacity(other.capacity)
+  capacity(other.capacity),
+  chunks(std::forward<Array<void*>>(other.chunks)),
+  occupancy(std::forward<Array<uint64_t>>(other.occupancy)),
+  freeObject(other.freeObject),
+  markedIds(std::forward<Array<uint32_t>>(other.markedIds)),
+  destroyingIndices(other.GetAllocator()),
+  retiredData(other.GetAllocator()),
+  deadCount(0),
+  destroyingMarked(false),
+  reorderIds(std::forward<Array<uint32_t>>(other.reorderIds)),
+  reorderCursor(other.reorderCursor),
+  reorderPlace(other.reorderPlace),
+  reorderScratch(other.reorderScratch)
 {
-    other.nextId = 0;
+    other.freeHead = kEndOfList;
+    other.freeTail = kEndOfList;
+    other.retiredHead = kEndOfList;
     other.data = nullptr;
     other.size = 0;
     other.capacity = 0;
+    other.freeObject = kEndOfList;
+    other.reorderScratch = nullptr;
 
-    uintptr_t obj = uintptr_t(data);
-    for (uint32_t i = 0; i < size; ++i, obj += classInfo->GetSize())
-        reinterpret_cast<BaseObject*>(obj)->pool = this;
+    this->SetPoolPointers();
 }
 
 BasePool::~BasePool()
 {
-    this->GetAllocator().Free(data);
+    this->FreeStorage();
 }
 
 BasePool&
 BasePool::operator =(const BasePool &other)
 {
-    nextId = other.nextId;
+    if (this == &other)
+        return (*this);
+
+    this->Clear();
+    this->FreeStorage();
+
     classInfo = other.classInfo;
-    map = other.map;
-    entries = other.entries;
+    objectSize = other.objectSize;
+    slots = other.slots;
+    freeHead = other.freeHead;
+    freeTail = other.freeTail;
+    retiredHead = other.retiredHead;
+    storage = other.storage;
     size = other.size;
     capacity = other.capacity;
+    occupancy = other.occupancy;
+    freeObject = other.freeObject;
+    markedIds = other.markedIds;
+    reorderIds.Clear();
+    reorderCursor = 0;
+    reorderPlace = 0;
 
-    data = this->GetAllocator().Allocate(classInfo->GetSize() * capacity, classInfo->GetAlign());
-
-    this->CopyObjects(data, other.data, other.size);
-
-    uintptr_t obj = uintptr_t(data);
-    for (uint32_t i = 0; i < size; ++i, obj += classInfo->GetSize())
-        reinterpret_cast<BaseObject*>(obj)->pool = this;
+    this->CopyStorage(other);
 
     return (*this);
 }
@@ -76,22 +132,41 @@ BasePool::operator =(const BasePool &other)
 BasePool&
 BasePool::operator =(BasePool &&other)
 {
-    nextId = other.nextId;
+    if (this == &other)
+        return (*this);
+
+    this->Clear();
+    this->FreeStorage();
+
     classInfo = other.classInfo;
-    map = std::forward<Array<uint32_t>>(other.map);
-    entries = std::forward<Array<Entry>>(other.entries);
+    objectSize = other.objectSize;
+    slots = std::forward<Array<Slot>>(other.slots);
+    freeHead = other.freeHead;
+    freeTail = other.freeTail;
+    retiredHead = other.retiredHead;
+    storage = other.storage;
     data = other.data;
     size = other.size;
     capacity = other.capacity;
-
-    other.nextId = 0;
+    chunks = std::forward<Array<void*>>(other.chunks);
+    occupancy = std::forward<Array<uint64_t>>(other.occupancy);
+    freeObject = other.freeObject;
+    markedIds = std::forward<Array<uint32_t>>(other.markedIds);
+    reorderIds = std::forward<Array<uint32_t>>(other.reorderIds);
+    reorderCursor = other.reorderCursor;
+    reorderPlace = other.reorderPlace;
+    reorderScratch = other.reorderScratch;
+
+    other.freeHead = kEndOfList;
+    other.freeTail = kEndOfList;
+    other.retiredHead = kEndOfList;
     other.data = nullptr;
     other.size = 0;
     other.capacity = 0;
+    other.freeObject = kEndOfList;
+    other.reorderScratch = nullptr;
 
-    uintptr_t obj = uintptr_t(data);
-    for (uint32_t i = 0; i < size; ++i, obj += classInfo->GetSize())
-        reinterpret_cast<BaseObject*>(obj)->pool = this;
+    this->SetPoolPointers();
 
     return (*this);
 }
@@ -99,136 +174,376 @@ BasePool::operator =(BasePool &&other)
 void
 BasePool::Grow()
 {
+    uint32_t oldCapacity = capacity;
     capacity = 8 + capacity * 2;
 
+    if (oldCapacity > 0 && this->GetAllocator().TryExpand(data, classInfo->GetSize() * oldCapacity, classInfo->GetSize() * capacity))
+        return;
+
     void *newData = this->GetAllocator().Allocate(classInfo->GetSize() * capacity, classInfo->GetAlign());
-    this->MoveObjects(newData, data, size);
+    if (!destroyingMarked) {
+        this->MoveObjects(newData, data, size);
+        this->GetAllocator().Free(data);
+        data = newData;
+        return;
+    }
 
-    this->GetAllocator().Free(data);
+    // A destructor run by DestroyMarked added an object. Objects being destroyed stay in the old storage
+    // until their destructor returns, their places here are left dead like the destroyed ones.
+    for (uint32_t i = 0; i < size; ++i) {
+        BaseObject *pointer = this->GetObjectAt(i),
+                   *dst = reinterpret_cast<BaseObject*>(uintptr_t(newData) + objectSize * i);
+        if (nullptr == pointer->pool || destroyingIndices.IndexOf(i) >= 0)
+            dst->pool = nullptr;
+        else
+            this->MoveObjects(dst, pointer, 1);
+    }
+
+    retiredData.PushBack(data);
     data = newData;
 }
 
-bool
-BasePool::IsHashFull() const
+void
+BasePool::AddChunk()
 {
-    const float maxLoadFactor = 0.7f;
-    return (0 == map.Count() || entries.Count() >= (map.Count() * maxLoadFactor));
+    assert(kEndOfList == freeObject);
+
+    void *chunk = this->GetAllocator().Allocate(objectSize * kChunkObjects, classInfo->GetAlign());
+    chunks.PushBack(chunk);
+    occupancy.PushBack(0);
+
+    uint32_t first = capacity;
+    capacity += kChunkObjects;
+
+    uintptr_t obj = uintptr_t(chunk);
+    for (uint32_t i = first + 1; i < capacity; ++i, obj += objectSize)
+        *reinterpret_cast<uint32_t*>(obj) = i;
+    *reinterpret_cast<uint32_t*>(obj) = kEndOfList;
+
+    freeObject = first;
 }
 
 void
-BasePool::Rehash(uint32_t newMapSize)
+BasePool::FreeStorage()
 {
-    map.Resize(newMapSize);
-    uint32_t i = 0;
-    for (; i < newMapSize; ++i)
-        map[i] = kEndOfList;
+    this->GetAllocator().Free(data);
+    data = nullptr;
 
-    entries.Clear();
+    for (void **retired = retiredData.Begin(); retired < retiredData.End(); ++retired)
+        this->GetAllocator().Free(*retired);
+    retiredData.Clear();
 
-    uintptr_t obj = uintptr_t(data);
-    for (i = 0; i < size; ++i, obj += classInfo->GetSize())
-        this->Insert(reinterpret_cast<BaseObject*>(obj));
+    this->GetAllocator().Free(reorderScratch);
+    reorderScratch = nullptr;
+
+    for (void **chunk = chunks.Begin(); chunk < chunks.End(); ++chunk)
+        this->GetAllocator().Free(*chunk);
+    chunks.Clear();
 }
 
 void
-BasePool::Insert(BaseObject *pointer)
+BasePool::CopyStorage(const BasePool &other)
 {
-    assert(nullptr == this->Get(pointer->id));
-
-    if (this->IsHashFull())
-        this->Rehash(map.Count() * 2 + 8);
+    if (Chunked == storage) {
+        // Free places are copied too, they hold the free list.
+        for (uint32_t i = 0, count = other.chunks.Count(); i < count; ++i) {
+            chunks.PushBack(this->GetAllocator().Allocate(objectSize * kChunkObjects, classInfo->GetAlign()));
+            memcpy(chunks[i], other.chunks[i], objectSize * kChunkObjects);
+        }
+    } else {
+        data = this->GetAllocator().Allocate(objectSize * capacity, classInfo->GetAlign());
+    }
 
-    entries.PushBack(Entry());
-    Entry &entry = entries.Back();
+    // Copies keep the ids of the originals, so the copied slots resolve them.
+    uint32_t index = 0;
+    BaseObject *first, *end;
+    while (other.NextRun(index, first, end)) {
+        uint32_t count = uint32_t(uintptr_t(end) - uintptr_t(first)) / objectSize;
+        uintptr_t dst = uintptr_t(this->GetObjectAt(index - count));
+        this->CopyObjects(reinterpret_cast<void*>(dst), first, count);
+
+        for (uintptr_t src = uintptr_t(first); src < uintptr_t(end); src += objectSize, dst += objectSize) {
+            reinterpret_cast<BaseObject*>(dst)->pool = this;
+            reinterpret_cast<BaseObject*>(dst)->id = reinterpret_cast<BaseObject*>(src)->id;
+        }
+    }
+}
 
-    uint32_t entryIndex = &entry - entries.Begin(),
-             entryHash  = pointer->id % map.Count();
+void
+BasePool::SetPoolPointers()
+{
+    uint32_t index = 0;
+    BaseObject *first, *end;
+    while (this->NextRun(index, first, end)) {
+        for (uintptr_t obj = uintptr_t(first); obj < uintptr_t(end); obj += objectSize)
+            reinterpret_cast<BaseObject*>(obj)->pool = this;
+    }
+}
 
-    entry.id    = pointer->id;
-    entry.index = entryIndex;
-    entry.prev  = kEndOfList;
-    entry.next  = kEndOfList;
+bool
+BasePool::NextRun(uint32_t &index, BaseObject *&first, BaseObject *&end) const
+{
+    if (Contiguous == storage) {
+        if (0 == deadCount) {
+            if (index >= size)
+                return false;
+
+            first = this->GetObjectAt(index);
+            end = this->GetObjectAt(size);
+            index = size;
+            return true;
+        }
 
-    uint32_t prevIndex = map[entryHash];
-    map[entryHash] = entryIndex;
+        // DestroyMarked is running, objects it destroyed are still in place with a null pool
+        while (index < size && nullptr == this->GetObjectAt(index)->pool)
+            ++index;
+        if (index >= size)
+            return false;
+
+        first = this->GetObjectAt(index);
+        while (index < size && this->GetObjectAt(index)->pool != nullptr)
+            ++index;
+        end = this->GetObjectAt(index);
+        return true;
+    }
 
-    Entry *firstEntry = kEndOfList == prevIndex ? nullptr : entries.Begin() + prevIndex;
-    if (firstEntry != nullptr) {
-        entry.next = firstEntry->index;
-        firstEntry->prev = entryIndex;
+    for (uint32_t chunk = index >> kChunkBits, count = occupancy.Count(); chunk < count; ++chunk) {
+        uint32_t bit = chunk == (index >> kChunkBits) ? index & kChunkMask : 0;
+        uint64_t word = occupancy[chunk] >> bit;
+        if (0 == word)
+            continue;
+
+        uint32_t start = bit + CountTrailingZeros(word),
+                 stop = start;
+        word = occupancy[chunk] >> start;
+        stop += ~word ? CountTrailingZeros(~word) : kChunkObjects - start;
+
+        index = (chunk << kChunkBits) + stop;
+        first = this->GetObjectAt((chunk << kChunkBits) + start);
+        end = reinterpret_cast<BaseObject*>(uintptr_t(first) + objectSize * (stop - start));
+        return true;
     }
+    return false;
 }
 
-void
-BasePool::Remove(BaseObject *pointer)
+BaseObject*
+BasePool::Allocate()
 {
-    uint32_t objIndex = (uintptr_t(pointer) - uintptr_t(data)) / classInfo->GetSize();
-    assert(objIndex < size);
+    uint32_t objIndex = size;
+    if (Chunked == storage) {
+        if (kEndOfList == freeObject)
+            this->AddChunk();
+
+        objIndex = freeObject;
+        freeObject = *reinterpret_cast<uint32_t*>(this->GetObjectAt(objIndex));
+        occupancy[objIndex >> kChunkBits] |= uint64_t(1) << (objIndex & kChunkMask);
+    } else if (size == capacity) {
+        this->Grow();
+    }
 
-    Entry *entry = entries.Begin() + objIndex;
-    assert(entry->index == objIndex);
+    uint32_t slotIndex;
+    if (freeHead != kEndOfList) {
+        slotIndex = freeHead;
+        freeHead = slots[slotIndex].index;
+        if (kEndOfList == freeHead)
+            freeTail = kEndOfList;
+    } else if (slots.Count() <= kIndexMask || kEndOfList == retiredHead) {
+        slotIndex = slots.Count();
+        assert2(slotIndex <= kIndexMask, "too many objects in pool");
+        slots.PushBack(Slot());
+        slots.Back().generation = 0;
+    } else {
+        // every id was handed out once, from here on ids of retired slots repeat
+        slotIndex = retiredHead;
+        retiredHead = slots[slotIndex].index;
+    }
 
-    if (kEndOfList == entry->prev)
-        map[entry->id % map.Count()] = entry->next;
-    else
-        entries[entry->prev].next = entry->next;
+    Slot &slot = slots[slotIndex];
+    slot.generation &= kGenerationMask;
+    slot.index = objIndex;
+
+    BaseObject *pointer = this->GetObjectAt(objIndex);
+
+    pointer->pool = this;
+    pointer->id   = (slot.generation << kIndexBits) | slotIndex;
 
-    if (entry->next != kEndOfList)
-        entries[entry->next].prev = entry->prev;
+    ++size;
 
-    int index     = entry->index,
-        lastIndex = entries.Count() - 1;
+    return pointer;
+}
 
-    if (index == lastIndex) {
-        entries.PopBack();
+void
+BasePool::Free(BaseObject *pointer)
+{
+    uint32_t slotIndex = pointer->id & kIndexMask,
+             objIndex = slots[slotIndex].index;
+    assert(pointer->pool == this);
+    assert(this->GetObjectAt(objIndex) == pointer);
+
+    if (destroyingMarked && Contiguous == storage) {
+        destroyingIndices.PushBack(objIndex);
+        pointer->~BaseObject();
+        destroyingIndices.PopBack();
+        ++deadCount;
+    } else {
+        pointer->~BaseObject();
+    }
+    pointer->pool = nullptr;
+
+    this->ReleaseSlot(slotIndex);
+
+    if (Chunked == storage) {
+        --size;
+        occupancy[objIndex >> kChunkBits] &= ~(uint64_t(1) << (objIndex & kChunkMask));
+        *reinterpret_cast<uint32_t*>(pointer) = freeObject;
+        freeObject = objIndex;
+    } else if (!destroyingMarked) {
+        --size;
+        if (objIndex < size) {
+            BaseObject *lastPointer = this->GetObjectAt(size);
+            this->MoveObjects(pointer, lastPointer, 1);
+            slots[pointer->id & kIndexMask].index = objIndex;
+        }
+    } // else DestroyMarked compacts once every marked object is gone
+}
+
+void
+BasePool::ReleaseSlot(uint32_t slotIndex)
+{
+    Slot &slot = slots[slotIndex];
+    slot.generation = ((slot.generation + 1) & kGenerationMask) | kFreeSlot;
+
+    if (kFreeSlot == slot.generation) {
+        slot.index = retiredHead;
+        retiredHead = slotIndex;
         return;
     }
 
-    entries[index] = entries[lastIndex];
-    entries.PopBack();
+    slot.index = kEndOfList;
 
-    Entry *movedEntry = entries.Begin() + index;
-    movedEntry->index = index;
-    if (kEndOfList == movedEntry->prev)
-        map[movedEntry->id % map.Count()] = index;
+    if (kEndOfList == freeTail)
+        freeHead = slotIndex;
     else
-        entries[movedEntry->prev].next = index;
+        slots[freeTail].index = slotIndex;
+    freeTail = slotIndex;
+}
 
-    if (movedEntry->next != kEndOfList)
-        entries[movedEntry->next].prev = index;
+void
+BasePool::MarkForDestruction(BaseObject *pointer)
+{
+    assert(pointer->pool == this);
+    markedIds.PushBack(pointer->id);
 }
 
-BaseObject*
-BasePool::Allocate()
+void
+BasePool::DestroyMarked()
 {
-    if (size == capacity)
-        this->Grow();
+    if (markedIds.IsEmpty())
+        return;
 
-    BaseObject *pointer = reinterpret_cast<BaseObject*>(uintptr_t(data) + classInfo->GetSize() * size);
+    // Objects destroyed meanwhile or marked twice don't resolve anymore. Destructors can mark more objects,
+    // so the count is read at every step.
+    if (Chunked == storage) {
+        for (uint32_t i = 0; i < markedIds.Count(); ++i) {
+            BaseObject *pointer = this->Get(markedIds[i]);
+            if (pointer != nullptr)
+                this->Free(pointer);
+        }
+        markedIds.Clear();
+        return;
+    }
 
-    pointer->pool = this;
-    pointer->id   = nextId++;
+    // Destroyed objects stay where they are, with a null pool, then the survivors are packed
+    // in a single pass and their slots pointed to the new places.
+    destroyingMarked = true;
+    for (uint32_t i = 0; i < markedIds.Count(); ++i) {
+        BaseObject *pointer = this->Get(markedIds[i]);
+        if (pointer != nullptr)
+            this->Free(pointer);
+    }
+    destroyingMarked = false;
+    markedIds.Clear();
+
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < size; ++i) {
+        BaseObject *pointer = this->GetObjectAt(i);
+        if (nullptr == pointer->pool)
+            continue;
+
+        if (i != count) {
+            this->MoveObjects(this->GetObjectAt(count), pointer, 1);
+            slots[pointer->id & kIndexMask].index = count;
+        }
+        ++count;
+    }
+    size = count;
+    deadCount = 0;
 
-    this->Insert(pointer);
+    for (void **retired = retiredData.Begin(); retired < retiredData.End(); ++retired)
+        this->GetAllocator().Free(*retired);
+    retiredData.Clear();
+}
 
-    ++size;
+void
+BasePool::SwapObjects(uint32_t index0, uint32_t index1)
+{
+    BaseObject *pointer0 = this->GetObjectAt(index0),
+               *pointer1 = this->GetObjectAt(index1);
 
-    return pointer;
+    this->MoveObjects(reorderScratch, pointer0, 1);
+    this->MoveObjects(pointer0, pointer1, 1);
+    this->MoveObjects(pointer1, reorderScratch, 1);
+
+    slots[pointer0->id & kIndexMask].index = index0;
+    slots[pointer1->id & kIndexMask].index = index1;
 }
 
 void
-BasePool::Free(BaseObject *pointer)
+BasePool::StartReorder()
 {
-    pointer->~BaseObject();
-    pointer->pool = nullptr;
+    assert2(Contiguous == storage, "chunked pools keep their objects in place");
 
-    this->Remove(pointer);
+    reorderCursor = 0;
+    reorderPlace = 0;
+    if (nullptr == reorderScratch)
+        reorderScratch = this->GetAllocator().Allocate(objectSize, classInfo->GetAlign());
+}
+
+bool
+BasePool::IsReordering() const
+{
+    return reorderCursor < reorderIds.Count();
+}
 
-    --size;
-    if (size > 0) {
-        void *lastPointer = reinterpret_cast<void*>(uintptr_t(data) + classInfo->GetSize() * size);
-        this->MoveObjects(pointer, lastPointer, 1);
+bool
+BasePool::StepReorder(uint32_t maxMoves)
+{
+    uint32_t moves = 0;
+    while (moves < maxMoves && reorderCursor < reorderIds.Count() && reorderPlace < size) {
+        BaseObject *pointer = this->Get(reorderIds[reorderCursor++]);
+        if (nullptr == pointer)
+            continue; // destroyed meanwhile
+
+        // An object behind the sorted ones got there by filling a hole, it's left where it is.
+        uint32_t index = slots[pointer->id & kIndexMask].index;
+        if (index < reorderPlace)
+            continue;
+
+        if (index != reorderPlace) {
+            this->SwapObjects(reorderPlace, index);
+            ++moves;
+        }
+        ++reorderPlace;
     }
+
+    if (reorderCursor < reorderIds.Count() && reorderPlace < size)
+        return true;
+
+    reorderIds.Clear();
+    reorderCursor = 0;
+    this->GetAllocator().Free(reorderScratch);
+    reorderScratch = nullptr;
+    return false;
 }
 
 const ClassInfo*
@@ -237,16 +552,22 @@ BasePool::GetBaseObjectClassInfo() const
     return classInfo;
 }
 
+BasePool::Storage
+BasePool::GetStorage() const
+{
+    return storage;
+}
+
 Allocator&
 BasePool::GetAllocator() const
 {
-    return map.GetAllocator();
+    return slots.GetAllocator();
 }
 
 uint32_t
 BasePool::Count() const
 {
-    return size;
+    return size - deadCount;
 }
 
 uint32_t
@@ -258,55 +579,28 @@ BasePool::Capacity() const
 bool
 BasePool::IsEmpty() const
 {
-    return 0 == size;
+    return size == deadCount;
 }
 
 void
 BasePool::Clear()
 {
-    int32_t i = size - 1;
-    uintptr_t obj = uintptr_t(data) + classInfo->GetSize() * i;
-    for (; i >= 0; --i, obj -= classInfo->GetSize())
-        reinterpret_cast<BaseObject*>(obj)->Destroy();
-
-    assert(0 == size);
-}
-
-const BaseObject*
-BasePool::Get(uint32_t id) const
-{
-    uint32_t mapIndex = map[id % map.Count()];
-    if (kEndOfList == mapIndex)
-        return nullptr;
-    else {
-        const Entry *entry = entries.Begin() + mapIndex;
-        while (entry->id != id) {
-            if (kEndOfList == entry->next)
-                return nullptr;
-            entry = entries.Begin() + entry->next;
+    markedIds.Clear();
+
+    // Destructors can destroy or add other objects, so the occupancy words and size are read again
+    // after each one.
+    if (Chunked == storage) {
+        while (size > 0) {
+            for (uint32_t chunk = 0; chunk < occupancy.Count(); ++chunk) {
+                for (uint64_t word; (word = occupancy[chunk]) != 0; )
+                    this->GetObjectAt((chunk << kChunkBits) + CountTrailingZeros(word))->Destroy();
+            }
         }
-        return reinterpret_cast<const BaseObject*>(uintptr_t(data) + classInfo->GetSize() * entry->index);
+        return;
     }
-}
 
-BaseObject*
-BasePool::Get(uint32_t id)
-{
-    if (0 == size)
-        return nullptr;
-
-    uint32_t mapIndex = map[id % map.Count()];
-    if (kEndOfList == mapIndex)
-        return nullptr;
-    else {
-        Entry *entry = entries.Begin() + mapIndex;
-        while (entry->id != id) {
-            if (kEndOfList == entry->next)
-                return nullptr;
-            entry = entries.Begin() + entry->next;
-        }
-        return reinterpret_cast<BaseObject*>(uintptr_t(data) + classInfo->GetSize() * entry->index);
-    }
+    while (size > 0)
+        this->GetObjectAt(size - 1)->Destroy();
 }
 
 BaseObject*
@@ -1,48 +1,91 @@
 #pragma once
 
-#include "Core/Collections/Array_type.h"
+#include "Core/Collections/Array.h"
 
 namespace Framework {
 
 class ClassInfo;
 class BaseObject;
 
+// Ids go through a table of slots so they survive objects being moved around. An id packs the slot index
+// with the slot generation, the generation changes every time the slot is freed so stale ids stop resolving.
+// Contiguous pools keep objects packed, growing and freeing move them. Chunked pools never move objects:
+// they live in fixed size chunks, freed places are linked in a free list and reused first.
 class BasePool {
+public:
+    enum Storage {
+        Contiguous,
+        Chunked
+    };
 protected:
     static const uint32_t kEndOfList = 0xffffffff;
 
-    struct Entry {
-        uint32_t id;
-        uint32_t index;
-        uint32_t prev;
-        uint32_t next;
-    };
+    // Up to 4M slots of 1024 generations each. A slot is retired after its last generation, its ids only
+    // repeat once the whole table is used up. Free slots have kFreeSlot set, no id matches them.
+    static const uint32_t kIndexBits = 22;
+    static const uint32_t kIndexMask = (1 << kIndexBits) - 1;
+    static const uint32_t kGenerationMask = 0xffffffff >> kIndexBits;
+    static const uint32_t kFreeSlot = 0x80000000;
 
-    uint32_t nextId;
+    static const uint32_t kChunkBits = 6;
+    static const uint32_t kChunkObjects = 1 << kChunkBits; // one occupancy word per chunk
+    static const uint32_t kChunkMask = kChunkObjects - 1;
+
+    struct Slot {
+        uint32_t generation;
+        uint32_t index;      // object index, or next free slot
+    };
 
     ClassInfo *classInfo;
+    uint32_t objectSize; // classInfo->GetSize(), kept here to resolve ids without going through classInfo
+
+    Array<Slot> slots;
+    uint32_t freeHead;  // freed slots are reused in FIFO order so they are retired as late as possible
+    uint32_t freeTail;
+    uint32_t retiredHead;
 
-    Array<uint32_t> map;
-    Array<Entry> entries;
+    Storage storage;
 
     void *data;
     uint32_t size;
     uint32_t capacity;
 
+    Array<void*> chunks;
+    Array<uint64_t> occupancy;
+    uint32_t freeObject; // free places in chunks store the index of the next one
+
+    Array<uint32_t> markedIds;
+    Array<uint32_t> destroyingIndices; // objects whose destructor runs inside DestroyMarked
+    Array<void*> retiredData;          // storage left by growing meanwhile, they still live there
+    uint32_t deadCount;                // destroyed by DestroyMarked and not packed away yet
+    bool destroyingMarked;
+
+    Array<uint32_t> reorderIds; // target order
+    uint32_t reorderCursor;
+    uint32_t reorderPlace;
+    void *reorderScratch;
+
     virtual void CopyObjects(void *dest, void *src, uint32_t objectsCount) = 0;
     virtual void MoveObjects(void *dest, void *src, uint32_t objectsCount) = 0;
 
     void Grow();
-    bool IsHashFull() const;
-    void Rehash(uint32_t newMapSize);
+    void AddChunk();
+    void FreeStorage();
+    void CopyStorage(const BasePool &other);
+    void SetPoolPointers();
+    void ReleaseSlot(uint32_t slotIndex);
+    void SwapObjects(uint32_t index0, uint32_t index1);
+    void StartReorder();
+
+    BaseObject* GetObjectAt(uint32_t index) const;
 
-    void Insert(BaseObject *pointer);
-    void Remove(BaseObject *pointer);
+    // Finds the first run of consecutive live objects at or after index, index is moved past it.
+    bool NextRun(uint32_t &index, BaseObject *&first, BaseObject *&end) const;
 
     BaseObject* Allocate();
     void Free(BaseObject *pointer);
 public:
-    BasePool(Allocator &allocator, ClassInfo *_classInfo);
+    BasePool(Allocator &allocator, ClassInfo *_classInfo, Storage _storage = Contiguous);
     BasePool(const BasePool &other);
     BasePool(BasePool &&other);
     virtual ~BasePool();
@@ -51,6 +94,7 @@ public:
     BasePool& operator =(BasePool &&other);
 
     const ClassInfo* GetBaseObjectClassInfo() const;
+    Storage GetStorage() const;
     Allocator& GetAllocator() const;
     uint32_t Count() const;
     uint32_t Capacity() const;
@@ -62,7 +106,49 @@ public:
 
     BaseObject* Clone(uint32_t id);
 
+    // Marked objects stay alive until DestroyMarked, which contiguous pools follow with one compaction pass.
+    // Objects it already destroyed are left out of Count and iteration, destructors can still add objects.
+    void MarkForDestruction(BaseObject *pointer);
+    void DestroyMarked();
+
+    // Moves objects of a contiguous pool towards the order given to Pool<T>::BeginReorder, maxMoves at a time.
+    // Handles follow, pointers don't. Objects added meanwhile stay after the sorted ones.
+    bool IsReordering() const;
+    bool StepReorder(uint32_t maxMoves);
+
     friend class BaseObject;
+    template <typename T> friend class PoolIterator;
 };
 
+inline BaseObject*
+BasePool::GetObjectAt(uint32_t index) const
+{
+    if (Chunked == storage)
+        return reinterpret_cast<BaseObject*>(uintptr_t(chunks.Begin()[index >> kChunkBits]) + objectSize * (index & kChunkMask));
+    else
+        return reinterpret_cast<BaseObject*>(uintptr_t(data) + objectSize * index);
+}
+
+inline const BaseObject*
+BasePool::Get(uint32_t id) const
+{
+    uint32_t slotIndex = id & kIndexMask;
+    if (slotIndex >= slots.Count())
+        return nullptr;
+
+    const Slot &slot = slots.Begin()[slotIndex];
+    return slot.generation == (id >> kIndexBits) ? this->GetObjectAt(slot.index) : nullptr;
+}
+
+inline BaseObject*
+BasePool::Get(uint32_t id)
+{
+    uint32_t slotIndex = id & kIndexMask;
+    if (slotIndex >= slots.Count())
+        return nullptr;
+
+    const Slot &slot = slots.Begin()[slotIndex];
+    return slot.generation == (id >> kIndexBits) ? this->GetObjectAt(slot.index) : nullptr;
+}
+
 } // namespace Framework
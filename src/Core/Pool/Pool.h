@@ -1,5 +1,6 @@
 #pragma once
 
+#include <utility>
 #include "Core/Pool/Pool_type.h"
 #include "Core/Pool/Handle.h"
 
@@ -7,8 +8,86 @@ namespace Framework {
 
 template <typename T>
 inline
-Pool<T>::Pool(Allocator &allocator)
-: BasePool(allocator, &T::RTTI)
+PoolIterator<T>::PoolIterator()
+: pool(nullptr),
+  object(nullptr),
+  runEnd(nullptr),
+  nextIndex(0)
+{ }
+
+template <typename T>
+inline
+PoolIterator<T>::PoolIterator(const BasePool *_pool)
+: pool(_pool),
+  object(nullptr),
+  runEnd(nullptr),
+  nextIndex(0)
+{
+    this->NextRun();
+}
+
+template <typename T>
+inline void
+PoolIterator<T>::NextRun()
+{
+    BaseObject *first, *end;
+    if (pool->NextRun(nextIndex, first, end)) {
+        object = static_cast<T*>(first);
+        runEnd = static_cast<T*>(end);
+    } else {
+        object = nullptr;
+        runEnd = nullptr;
+    }
+}
+
+template <typename T>
+inline PoolIterator<T>&
+PoolIterator<T>::operator ++()
+{
+    if (++object == runEnd)
+        this->NextRun();
+    return (*this);
+}
+
+template <typename T>
+inline bool
+PoolIterator<T>::operator ==(const PoolIterator<T> &other) const
+{
+    return object == other.object;
+}
+
+template <typename T>
+inline bool
+PoolIterator<T>::operator !=(const PoolIterator<T> &other) const
+{
+    return object != other.object;
+}
+
+template <typename T>
+inline
+PoolIterator<T>::operator T*() const
+{
+    return object;
+}
+
+template <typename T>
+inline T*
+PoolIterator<T>::operator ->() const
+{
+    return object;
+}
+
+template <typename T>
+inline T&
+PoolIterator<T>::operator *() const
+{
+    return *object;
+}
+
+template <typename T>
+inline
+Pool<T>::Pool(Allocator &allocator, Storage storage)
+: BasePool(allocator, &T::RTTI, storage)
 { }
 
 template <typename T>
@@ -16,11 +95,7 @@ inline
 Pool<T>::Pool(const Pool<T> &other)
 : BasePool(other)
 {
-    this->MoveObjects(reinterpret_cast<void*>(data), reinterpret_cast<void*>(other.data), other.size);
-
-    uintptr_t obj = uintptr_t(data);
-    for (uint32_t i = 0; i < size; ++i, obj += classInfo->GetSize())
-        reinterpret_cast<BaseObject*>(obj)->pool = this;
+    this->CopyStorage(other);
 }
 
 template <typename T>
@@ -55,31 +130,31 @@ Pool<T>::MoveObjects(void *dest, void *src, uint32_t objectsCount)
 }
 
 template <typename T>
-inline T*
+inline typename Pool<T>::Iterator
 Pool<T>::Begin()
 {
-    return static_cast<T*>(data);
+    return Iterator(this);
 }
 
 template <typename T>
-inline const T*
+inline typename Pool<T>::ConstIterator
 Pool<T>::Begin() const
 {
-    return static_cast<const T*>(data);
+    return ConstIterator(this);
 }
 
 template <typename T>
-inline T*
+inline typename Pool<T>::Iterator
 Pool<T>::End()
 {
-    return reinterpret_cast<T*>(uintptr_t(data) + classInfo->GetSize() * size);
+    return Iterator();
 }
 
 template <typename T>
-inline const T*
+inline typename Pool<T>::ConstIterator
 Pool<T>::End() const
 {
-    return reinterpret_cast<const T*>(uintptr_t(data) + classInfo->GetSize() * size);
+    return ConstIterator();
 }
 
 template <typename T>
@@ -123,4 +198,38 @@ Pool<T>::DeleteInstance(const Handle<T> &handle)
     this->Free(handle.Get());
 }
 
+template <typename T>
+template <typename F>
+inline void
+Pool<T>::BeginReorder(F key)
+{
+    struct KeyedId {
+        uint32_t key;
+        uint32_t index;
+        uint32_t id;
+    };
+
+    // the key loop walks data as one packed array
+    assert2(Contiguous == storage, "chunked pools keep their objects in place");
+    if (0 == size)
+        return;
+
+    Array<KeyedId> keys(this->GetAllocator(), size);
+    keys.Resize(size);
+
+    T *object = static_cast<T*>(data);
+    for (uint32_t i = 0; i < size; ++i, ++object)
+        keys[i] = { key(static_cast<const T*>(object)), i, object->GetInstanceID() };
+
+    Array<KeyedId>::Sort(keys, 0, size, [] (const KeyedId &a, const KeyedId &b) {
+        return a.key < b.key || (a.key == b.key && a.index < b.index);
+    });
+
+    reorderIds.Resize(size);
+    for (uint32_t i = 0; i < size; ++i)
+        reorderIds[i] = keys[i].id;
+
+    this->StartReorder();
+}
+
 } // namespace Framework
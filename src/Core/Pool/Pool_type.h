@@ -6,27 +6,59 @@ template <typename T> class Handle;
 
 namespace Framework {
 
+// Walks live objects in storage order, a run of consecutive objects at a time so
+// stepping inside a run is a pointer increment. Objects can't be added or removed while iterating.
+template <typename T>
+class PoolIterator {
+private:
+    const BasePool *pool;
+    T *object;
+    T *runEnd;
+    uint32_t nextIndex;
+
+    void NextRun();
+public:
+    PoolIterator();
+    PoolIterator(const BasePool *_pool);
+
+    PoolIterator<T>& operator ++();
+
+    bool operator ==(const PoolIterator<T> &other) const;
+    bool operator !=(const PoolIterator<T> &other) const;
+
+    operator T*() const;
+    T* operator ->() const;
+    T& operator *() const;
+};
+
 template <typename T>
 class Pool : public BasePool {
 protected:
     virtual void CopyObjects(void *dest, void *src, uint32_t objectsCount);
     virtual void MoveObjects(void *dest, void *src, uint32_t objectsCount);
 public:
-    Pool(Allocator &allocator);
+    typedef PoolIterator<T> Iterator;
+    typedef PoolIterator<const T> ConstIterator;
+
+    Pool(Allocator &allocator, Storage storage = Contiguous);
     Pool(const Pool<T> &other);
     Pool(Pool<T> &&other);
     virtual ~Pool();
 
-    T* Begin();
-    const T* Begin() const;
-    T* End();
-    const T* End() const;
+    Iterator Begin();
+    ConstIterator Begin() const;
+    Iterator End();
+    ConstIterator End() const;
 
     Handle<T> NewInstance();
     template <typename... Args> Handle<T> NewInstance(Args... arguments);
     Handle<T> GetInstance(uint32_t id);
     Handle<T> CloneInstance(const Handle<T> &handle);
     void DeleteInstance(const Handle<T> &handle);
+
+    // Starts moving objects in ascending key(const T*) order, see StepReorder. Equal keys keep their order,
+    // an empty pool has nothing to reorder. Contiguous pools only.
+    template <typename F> void BeginReorder(F key);
 };
 
 } // namespace Framework
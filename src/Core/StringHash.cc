@@ -29,13 +29,20 @@ StringHash::operator !=(const StringHash &other) const
 StringHash
 StringHash::FromCString(const char *str)
 {
-    uint32_t hash = 2166136261u,
-             length = strlen(str);
+    uint32_t length = strlen(str),
+             hash = StringHash::Compute(str, length);
+    return StringHash(hash, length, StringsTable::Instance()->GetString(hash, str, length));
+}
+
+uint32_t
+StringHash::Compute(const char *str, uint32_t length)
+{
+    uint32_t hash = 2166136261u;
     for (uint32_t i = 0; i < length; ++i) {
         hash ^= str[i];
         hash *= 16777619u;
     }
-    return StringHash(hash, length, StringsTable::Instance()->GetString(hash, str, length));
+    return hash;
 }
 
 } // namespace Framework
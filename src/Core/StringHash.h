@@ -43,6 +43,9 @@ struct StringHash
     bool operator !=(const StringHash &other) const;
 
     static StringHash FromCString(const char *str);
+
+    // Same hash as FromCString, without interning the string.
+    static uint32_t Compute(const char *str, uint32_t length);
 };
 
 } // namespace Framework
@@ -32,6 +32,7 @@ public:
     virtual void OnPause() = 0;
     virtual void OnResume() = 0;
     virtual void OnQuit() = 0;
+    virtual void OnEndFrame() = 0;
 
     virtual Handle<Component> NewComponentInstance(Entity *entity) = 0;
     virtual Handle<Component> NewComponentToDeserialize(Entity *entity) = 0;
@@ -1,11 +1,13 @@
 #pragma once
 
 #include "Core/Pool/BaseObject.h"
+#include "Core/Pool/BasePool.h"
 #include "Core/Pool/HandleList_type.h"
 
 #define DeclareComponent \
 public: \
     static int ExecutionOrder; \
+    static const Framework::BasePool::Storage PoolStorage; \
     static Framework::BaseComponentsList *BaseList; \
  \
     virtual Framework::BaseComponentsList* GetBaseList() const; \
@@ -13,7 +15,12 @@ public: \
     static void EnsureLinking();
 
 #define DefineComponent(type,execOrder) \
+    DefineComponentWithStorage(type,execOrder,Framework::BasePool::Chunked)
+
+// Contiguous storage packs components tighter and can be reordered, but moves them around.
+#define DefineComponentWithStorage(type,execOrder,storage) \
     int type::ExecutionOrder = execOrder | type::RTTI.SetStaticCtor([]{ type::BaseList = Framework::ComponentsList<type>::Instance(); }); \
+    const Framework::BasePool::Storage type::PoolStorage = storage; \
     Framework::BaseComponentsList *type::BaseList = nullptr; \
  \
     Framework::BaseComponentsList* type::GetBaseList() const \
@@ -59,28 +59,28 @@ ComponentsList<T>::AttachToEntity(Entity *entity, Args... arguments)
 }
 
 template <typename T>
-inline T*
+inline typename Pool<T>::Iterator
 ComponentsList<T>::Begin()
 {
     return pool.Begin();
 }
 
 template <typename T>
-inline const T*
+inline typename Pool<T>::ConstIterator
 ComponentsList<T>::Begin() const
 {
     return pool.Begin();
 }
 
 template <typename T>
-inline T*
+inline typename Pool<T>::Iterator
 ComponentsList<T>::End()
 {
     return pool.End();
 }
 
 template <typename T>
-inline const T*
+inline typename Pool<T>::ConstIterator
 ComponentsList<T>::End() const
 {
     return pool.End();
@@ -90,7 +90,8 @@ template <typename T>
 inline
 ComponentsList<T>::ComponentsList()
 : BaseComponentsList(T::ExecutionOrder),
-  pool(Memory::GetAllocator<MallocAllocator>())
+  pool(Memory::GetAllocator<MallocAllocator>(), T::PoolStorage),
+  reorderMovesPerFrame(0)
 {
     assert(instance == nullptr);
     instance = this;
@@ -109,7 +110,7 @@ template <typename T>
 inline void
 ComponentsList<T>::OnUpdate()
 {
-	for (auto it = pool.Begin(), end = pool.End(); it < end; ++it) {
+	for (auto it = pool.Begin(), end = pool.End(); it != end; ++it) {
 		switch (this->GetComponentState(it)) {
             case Component::Deserializing:
                 break;
@@ -158,7 +159,7 @@ template <typename T>
 inline void
 ComponentsList<T>::OnLateUpdate()
 {
-	for (auto it = pool.Begin(), end = pool.End(); it < end; ++it) {
+	for (auto it = pool.Begin(), end = pool.End(); it != end; ++it) {
         if (Component::State::Deserializing == this->GetComponentState(it))
             continue;
 
@@ -173,7 +174,7 @@ template <typename T>
 inline void
 ComponentsList<T>::OnRender()
 {
-	for (auto it = pool.Begin(), end = pool.End(); it < end; ++it) {
+	for (auto it = pool.Begin(), end = pool.End(); it != end; ++it) {
         if (Component::State::Deserializing == this->GetComponentState(it))
             continue;
         
@@ -188,7 +189,7 @@ template <typename T>
 inline void
 ComponentsList<T>::OnPause()
 {
-    for (auto it = pool.Begin(), end = pool.End(); it < end; ++it) {
+    for (auto it = pool.Begin(), end = pool.End(); it != end; ++it) {
         if (Component::State::Deserializing == this->GetComponentState(it))
             continue;
 
@@ -201,7 +202,7 @@ template <typename T>
 inline void
 ComponentsList<T>::OnResume()
 {
-    for (auto it = pool.Begin(), end = pool.End(); it < end; ++it) {
+    for (auto it = pool.Begin(), end = pool.End(); it != end; ++it) {
         if (Component::State::Deserializing == this->GetComponentState(it))
             continue;
 
@@ -214,7 +215,7 @@ template <typename T>
 inline void
 ComponentsList<T>::OnQuit()
 {
-    for (auto it = pool.Begin(), end = pool.End(); it < end; ++it) {
+    for (auto it = pool.Begin(), end = pool.End(); it != end; ++it) {
         if (Component::State::Deserializing == this->GetComponentState(it))
             continue;
 
@@ -223,6 +224,25 @@ ComponentsList<T>::OnQuit()
 	}
 }
 
+template <typename T>
+inline void
+ComponentsList<T>::OnEndFrame()
+{
+    pool.DestroyMarked();
+
+    if (pool.IsReordering())
+        pool.StepReorder(reorderMovesPerFrame);
+}
+
+template <typename T>
+template <typename F>
+inline void
+ComponentsList<T>::ReorderStorage(F key, uint32_t movesPerFrame)
+{
+    pool.BeginReorder(key);
+    reorderMovesPerFrame = movesPerFrame;
+}
+
 template <typename T>
 inline Handle<Component>
 ComponentsList<T>::NewComponentInstance(Entity *entity)
@@ -245,7 +265,7 @@ template <typename T>
 inline bool
 ComponentsList<T>::TryDeserializeComponent(Component *component, SerializationServer *server, const BitStream &stream)
 {
-    if (component < this->Begin() || component >= this->End())
+    if (component->GetPool() != &pool)
         return false;
 
     static_cast<T*>(component)->Deserialize(server, stream);
@@ -266,7 +286,7 @@ template <typename T>
 inline void
 ComponentsList<T>::OnSerializeComponents(BitStream &stream)
 {
-    for (auto it = pool.Begin(), end = pool.End(); it < end; ++it) {
+    for (auto it = pool.Begin(), end = pool.End(); it != end; ++it) {
         if (this->GetComponentSerializationId(it) != kInvalidSerializationId)
             it->OnSerialize(stream);
     }
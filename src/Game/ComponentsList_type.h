@@ -17,6 +17,7 @@ private:
     static void Initialize();
 
     Pool<T> pool;
+    uint32_t reorderMovesPerFrame;
 public:
     ComponentsList();
     virtual ~ComponentsList();
@@ -27,6 +28,7 @@ public:
     virtual void OnPause();
     virtual void OnResume();
     virtual void OnQuit();
+    virtual void OnEndFrame();
 
     virtual Handle<Component> NewComponentInstance(Entity *entity);
     virtual Handle<Component> NewComponentToDeserialize(Entity *entity);
@@ -41,10 +43,15 @@ public:
     template <typename... Args>
     Handle<T> AttachToEntity(Entity *entity, Args... arguments);
 
-    T* Begin();
-    const T* Begin() const;
-    T* End();
-    const T* End() const;
+    typename Pool<T>::Iterator Begin();
+    typename Pool<T>::ConstIterator Begin() const;
+    typename Pool<T>::Iterator End();
+    typename Pool<T>::ConstIterator End() const;
+
+    // Sorts contiguous storage by key(const T*) over the next frames, at most movesPerFrame components are moved
+    // at the end of each frame.
+    template <typename F>
+    void ReorderStorage(F key, uint32_t movesPerFrame);
 
 //#if defined(EDITOR)
     virtual void OnSerializeComponents(BitStream &stream);
@@ -1,6 +1,7 @@
 #include "Game/SerializationServer.h"
 #include "Managers/EntitiesManager.h"
 #include "Managers/ComponentsManager.h"
+#include "Managers/TransformsManager.h"
 #include "Managers/GetManager.h"
 
 namespace Framework {
@@ -68,12 +69,21 @@ SerializationServer::DeserializeEntities(const BitStream &stream)
 
     Log::Instance()->Write(Log::Info, "Loading %d entities...", numEntities);
 
+    // loaded transforms are placed in the hierarchy at once
+    auto trMng = GetManager<TransformsManager>();
+    bool edit = !trMng->IsEditing();
+    if (edit)
+        trMng->BeginEdit();
+
     auto entMng = GetManager<EntitiesManager>();
     for (uint32_t i = 0; i < numEntities; ++i)
         entMng->NewVoidEntity()->Deserialize(this, stream);
 
     GetManager<ComponentsManager>()->DeserializeComponents(this, stream);
 
+    if (edit)
+        trMng->EndEdit();
+
     loadedObjects.Clear();
 }
 
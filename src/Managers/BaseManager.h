@@ -18,6 +18,9 @@ public:
     virtual void OnPause() = 0;
     virtual void OnResume() = 0;
     virtual void OnQuit() = 0;
+
+    // Sync point after the frame has been submitted, objects marked for destruction go away here.
+    virtual void OnEndFrame() = 0;
 };
 
 #define DeclareManager \
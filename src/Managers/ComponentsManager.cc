@@ -115,6 +115,13 @@ ComponentsManager::OnQuit()
         (*it)->OnQuit();
 }
 
+void
+ComponentsManager::OnEndFrame()
+{
+    for (auto it = lists.Begin(), end = lists.End(); it != end; ++it)
+        (*it)->OnEndFrame();
+}
+
 //#if defined(EDITOR)
 void
 ComponentsManager::SerializeMarkedComponents(BitStream &stream)
@@ -33,6 +33,7 @@ public:
     virtual void OnPause();
     virtual void OnResume();
     virtual void OnQuit();
+    virtual void OnEndFrame();
 
 //#if defined(EDITOR)
     void SerializeMarkedComponents(BitStream &stream);
@@ -4,6 +4,8 @@
 #include "Game/Entity.h"
 #include "Game/ComponentsList.h"
 #include "Components/Transform.h"
+#include "Managers/TransformsManager.h"
+#include "Managers/GetManager.h"
 
 namespace Framework {
 
@@ -20,6 +22,12 @@ EntitiesManager::~EntitiesManager()
 Handle<Entity>
 EntitiesManager::CloneRecursively(Handle<Entity> source, Handle<Entity> cloneParent)
 {
+    // the whole copy is placed in the hierarchy at once, by the outermost call
+    TransformsManager *transforms = GetManager<TransformsManager>();
+    bool edit = !transforms->IsEditing();
+    if (edit)
+        transforms->BeginEdit();
+
     Handle<Entity> newEntity = entities.CloneInstance(source);
 
     const TransformChildren &children = source->GetTransform()->GetChildren();
@@ -35,6 +43,9 @@ EntitiesManager::CloneRecursively(Handle<Entity> source, Handle<Entity> clonePar
     if (cloneParent.IsValid())
         newEntity->GetTransform()->SetParent(cloneParent->GetTransform(), false);
 
+    if (edit)
+        transforms->EndEdit();
+
     return newEntity;
 }
 
@@ -132,4 +143,10 @@ EntitiesManager::OnQuit()
     entities.Clear();
 }
 
+void
+EntitiesManager::OnEndFrame()
+{
+    entities.DestroyMarked();
+}
+
 } // namespace Framework
@@ -35,6 +35,7 @@ public:
 	virtual void OnPause();
 	virtual void OnResume();
 	virtual void OnQuit();
+	virtual void OnEndFrame();
 
     friend class SerializationServer;
 };
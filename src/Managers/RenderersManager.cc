@@ -226,8 +226,8 @@ RenderersManager::OnRender()
     Math::Bounds octreeBounds;
 	octreeBounds.Reset();
 
-	MeshRenderer *rndrIt  = ComponentsList<MeshRenderer>::Instance()->Begin(),
-				 *rndrEnd = ComponentsList<MeshRenderer>::Instance()->End();
+	auto rndrIt  = ComponentsList<MeshRenderer>::Instance()->Begin(),
+		 rndrEnd = ComponentsList<MeshRenderer>::Instance()->End();
     for (; rndrIt != rndrEnd; ++rndrIt)
     {
         if (!rndrIt->IsActive())
@@ -272,6 +272,10 @@ void
 RenderersManager::OnQuit()
 { }
 
+void
+RenderersManager::OnEndFrame()
+{ }
+
 uint32_t
 RenderersManager::QueryRenderers(const Math::Matrix &viewProjection)
 {
@@ -57,6 +57,7 @@ public:
 	virtual void OnPause();
 	virtual void OnResume();
 	virtual void OnQuit();
+	virtual void OnEndFrame();
 
     uint32_t QueryRenderers(const Math::Matrix &viewProjection);
     const Handle<Renderer>& GetRenderer(uint32_t index);
@@ -1,31 +1,279 @@
+#include <algorithm>
 #include "Managers/TransformsManager.h"
 #include "Core/Collections/SimplePool.h"
 #include "Core/Collections/Hash.h"
 #include "Core/Pool/Handle.h"
 #include "Components/Transform.h"
+#include "Core/Memory/Memory.h"
 #include "Core/Memory/MallocAllocator.h"
 #include "Core/Memory/ScratchAllocator.h"
 #include "Core/StringHash.h"
 #include "Core/String.h"
+#include "Math/Affine.h"
 
 namespace Framework {
 
 DefineClassInfoWithFactory(Framework::TransformsManager, Framework::BaseManager);
 DefineManager(Framework::TransformsManager, 0);
 
+void
+TransformsManager::InsertEntry(uint32_t index, const Math::Vector3 &position, const Math::Quaternion &rotation, const Math::Vector3 &scale)
+{
+    entries.Insert(index, TransformEntry());
+    localPositions.Insert(index, position);
+    localRotations.Insert(index, rotation);
+    localScales.Insert(index, scale);
+}
+
+void
+TransformsManager::SetDirty(TransformEntry *entry)
+{
+    // descendants are reached through the subtree range by the update
+    entry->flags |= kFlagsDirty;
+
+    if (0 == (entry->flags & kFlagsDirtyRoot)) {
+        entry->flags |= kFlagsDirtyRoot;
+        dirtyRoots.PushBack(entry->id);
+    }
+}
+
+TransformsManager::TransformEntry*
+TransformsManager::FindDirtyRoot(TransformEntry *entry)
+{
+    if (dirtyRoots.IsEmpty())
+        return nullptr;
+
+    // the highest dirty one, its subtree holds every other
+    TransformEntry *dirtyRoot = nullptr;
+    while (true) {
+        if (entry->flags & kFlagsDirty)
+            dirtyRoot = entry;
+        if (kParentNull == entry->parent)
+            return dirtyRoot;
+        entry = entries.Begin() + indices.Get(entry->parent);
+    }
+}
+
+void
+TransformsManager::BeginEdit()
+{
+    assert(!editing);
+    editing = true;
+    editFirstAdded = entries.Count();
+}
+
 uint32_t
-TransformsManager::RegisterTransform(Transform *pointer, const Math::Matrix &world, uint32_t parentId)
+TransformsManager::GetParentAfterEdit(const TransformEntry &entry) const
+{
+    // children of removed transforms go to the closest ancestor left
+    uint32_t parentId = entry.parent;
+    while (parentId != kParentNull) {
+        const TransformEntry &parent = entries[indices.Get(parentId)];
+        if (0 == (parent.flags & kFlagsRemoved))
+            break;
+        parentId = parent.parent;
+    }
+    return parentId;
+}
+
+void
+TransformsManager::EndEdit()
+{
+    assert(editing);
+    editing = false;
+
+    // children lists, roots are the children of rootLink
+    EditLink rootLink = { kParentNull, kParentNull, kParentNull, kParentNull, kParentNull };
+    Array<EditLink> links(Memory::GetAllocator<ScratchAllocator>(), changed.Count());
+    links.Resize(changed.Count());
+    for (EditLink *link = links.Begin(); link < links.End(); ++link) {
+        *link = rootLink;
+        link->parent = kParentRemoved;
+    }
+
+    auto getLink = [&] (uint32_t id) -> EditLink& {
+        return kParentNull == id ? rootLink : links[id];
+    };
+    auto addChild = [&] (uint32_t id, uint32_t parentId) {
+        EditLink &link = links[id], &parent = getLink(parentId);
+        link.parent = parentId;
+        link.prevSibling = parent.lastChild;
+        link.nextSibling = kParentNull;
+        if (kParentNull == parent.lastChild)
+            parent.firstChild = id;
+        else
+            links[parent.lastChild].nextSibling = id;
+        parent.lastChild = id;
+    };
+    // replaces id by the first..last siblings, or drops it if first is kParentNull
+    auto replaceChild = [&] (uint32_t id, uint32_t first, uint32_t last) {
+        EditLink &link = links[id], &parent = getLink(link.parent);
+        uint32_t prev = link.prevSibling, next = link.nextSibling;
+        if (kParentNull == first) {
+            first = next;
+            last = prev;
+        } else {
+            links[first].prevSibling = prev;
+            links[last].nextSibling = next;
+        }
+        if (kParentNull == prev)
+            parent.firstChild = first;
+        else
+            links[prev].nextSibling = first;
+        if (kParentNull == next)
+            parent.lastChild = last;
+        else
+            links[next].prevSibling = last;
+        link.parent = kParentRemoved;
+    };
+
+    // entries removed, moved or getting new children, subtrees without any are copied as they are
+    Array<uint32_t> touched(Memory::GetAllocator<ScratchAllocator>());
+
+    // the hierarchy as it was at BeginEdit, entries are still in that order
+    Array<uint32_t> stack(Memory::GetAllocator<ScratchAllocator>());
+    for (uint32_t index = 0; index < editFirstAdded; ++index) {
+        while (!stack.IsEmpty() && index > stack.Back() + entries[stack.Back()].descendantsCount)
+            stack.PopBack();
+
+        addChild(entries[index].id, stack.IsEmpty() ? kParentNull : entries[stack.Back()].id);
+        if (entries[index].descendantsCount > 0)
+            stack.PushBack(index);
+    }
+    stack.Clear();
+
+    // then the edits, one at a time
+    uint32_t count = entries.Count();
+    for (const EditOp *op = editOps.Begin(); op < editOps.End(); ++op) {
+        uint32_t index = indices.Get(op->id);
+        touched.PushBack(index);
+
+        EditLink &link = links[op->id];
+        if (kParentRemoved == op->parent) {
+            // children go to the parent, in place of the removed one
+            assert(link.parent != kParentRemoved);
+            uint32_t parentId = link.parent;
+            for (uint32_t child = link.firstChild; child != kParentNull; child = links[child].nextSibling) {
+                links[child].parent = parentId;
+
+                TransformEntry *entry = entries.Begin() + indices.Get(child);
+                entry->parent = parentId;
+                this->SetDirty(entry);
+            }
+            replaceChild(op->id, link.firstChild, link.lastChild);
+            --count;
+        } else {
+            if (link.parent != kParentRemoved)
+                replaceChild(op->id, kParentNull, kParentNull);
+            addChild(op->id, op->parent);
+
+            if (op->parent != kParentNull)
+                touched.PushBack(indices.Get(op->parent));
+        }
+    }
+    editOps.Clear();
+
+    if (!touched.IsEmpty())
+        Array<uint32_t>::Sort(touched, 0, touched.Count());
+
+    auto isTouched = [&] (uint32_t first, uint32_t end) {
+        const uint32_t *t = std::lower_bound(touched.Begin(), touched.End(), first);
+        return t < touched.End() && *t < end;
+    };
+
+    uint32_t dirtyCount = 0;
+    for (uint32_t i = 0; i < dirtyRoots.Count(); ++i) {
+        if (0 == (entries[indices.Get(dirtyRoots[i])].flags & kFlagsRemoved))
+            dirtyRoots[dirtyCount++] = dirtyRoots[i];
+    }
+    dirtyRoots.Resize(dirtyCount);
+
+    // depth first walk, the indices of the open subtrees are on the stack
+    Array<TransformEntry> newEntries(Memory::GetAllocator<MallocAllocator>(), count);
+    Array<Math::Vector3> newPositions(Memory::GetAllocator<MallocAllocator>(), count);
+    Array<Math::Quaternion> newRotations(Memory::GetAllocator<MallocAllocator>(), count);
+    Array<Math::Vector3> newScales(Memory::GetAllocator<MallocAllocator>(), count);
+
+    uint32_t id = rootLink.firstChild;
+    while (id != kParentNull) {
+        uint32_t index    = indices.Get(id),
+                 end      = index + entries[index].descendantsCount + 1,
+                 first    = newEntries.Count(),
+                 parentId = stack.IsEmpty() ? kParentNull : newEntries[stack.Back()].id;
+
+        if (!isTouched(index, end)) {
+            newEntries.InsertRange(first, entries.Begin() + index, end - index);
+            newPositions.InsertRange(first, localPositions.Begin() + index, end - index);
+            newRotations.InsertRange(first, localRotations.Begin() + index, end - index);
+            newScales.InsertRange(first, localScales.Begin() + index, end - index);
+
+            for (uint32_t i = first; i < newEntries.Count(); ++i)
+                indices.Set(newEntries[i].id, i);
+        } else {
+            newEntries.PushBack(entries[index]);
+            newPositions.PushBack(localPositions[index]);
+            newRotations.PushBack(localRotations[index]);
+            newScales.PushBack(localScales[index]);
+
+            indices.Set(id, first);
+
+            if (links[id].firstChild != kParentNull) {
+                newEntries[first].parent = parentId;
+                stack.PushBack(first);
+                id = links[id].firstChild;
+                continue;
+            }
+
+            newEntries[first].descendantsCount = 0;
+        }
+        newEntries[first].parent = parentId;
+
+        // next sibling, or the one of the closest open subtree
+        id = links[id].nextSibling;
+        while (kParentNull == id && !stack.IsEmpty()) {
+            TransformEntry &closed = newEntries[stack.Back()];
+            closed.descendantsCount = newEntries.Count() - stack.Back() - 1;
+            stack.PopBack();
+
+            id = links[closed.id].nextSibling;
+        }
+    }
+    assert(newEntries.Count() == count);
+
+    for (const TransformEntry *entry = entries.Begin(); entry < entries.End(); ++entry) {
+        if (entry->flags & kFlagsRemoved)
+            indices.Free(entry->id);
+    }
+
+    entries = std::move(newEntries);
+    localPositions = std::move(newPositions);
+    localRotations = std::move(newRotations);
+    localScales = std::move(newScales);
+}
+
+bool
+TransformsManager::IsEditing() const
+{
+    return editing;
+}
+
+uint32_t
+TransformsManager::RegisterTransform(Transform *pointer, const Math::Vector3 &position, const Math::Quaternion &rotation, const Math::Vector3 &scale, uint32_t parentId)
 {
     if (pointer != nullptr)
         transforms.Add(pointer->GetHashCode(), pointer);
 
+    // the arguments may point into the arrays that are about to grow
+    Math::Vector3 p = position, s = scale;
+    Math::Quaternion r = rotation;
+
     uint32_t id = indices.Allocate();
     TransformEntry *entry = nullptr;
 
-    if (kParentNull == parentId) {
+    if (editing || kParentNull == parentId) {
         // place @ end
         indices.Set(id, entries.Count());
-        entries.PushBack(TransformEntry());
+        this->InsertEntry(entries.Count(), p, r, s);
         entry = &entries.Back();
     } else {
         // place after last parent descendant
@@ -33,7 +281,7 @@ TransformsManager::RegisterTransform(Transform *pointer, const Math::Matrix &wor
         entryIndex += (entries[entryIndex].descendantsCount + 1);
 
         indices.Set(id, entryIndex);
-        entries.Insert(entryIndex, TransformEntry());
+        this->InsertEntry(entryIndex, p, r, s);
         entry = entries.Begin() + entryIndex;
 
         // update descendants
@@ -49,6 +297,35 @@ TransformsManager::RegisterTransform(Transform *pointer, const Math::Matrix &wor
             indices.Set(movedEntry->id, movedEntry - entries.Begin());
     }
 
+    // setup entry, world is computed by the next update
+    entry->id = id;
+    entry->parent = parentId;
+    entry->descendantsCount = 0;
+    entry->flags = 0;
+    Math::AffineCompose(p, r, s, entry->world);
+    this->SetDirty(entry);
+
+    if (editing) {
+        // placed by EndEdit
+        EditOp op = { id, parentId };
+        editOps.PushBack(op);
+    }
+
+    if (id == changed.Count())
+        changed.PushBack(1);
+    else
+        changed[id] = 1;
+    anyChanged = true;
+
+    if (pointer != nullptr)
+        pointer->id = id;
+
+    return id;
+}
+
+uint32_t
+TransformsManager::RegisterTransform(Transform *pointer, const Math::Matrix &world, uint32_t parentId)
+{
     Math::Matrix local;
     if (kParentNull == parentId) {
         local = world;
@@ -58,22 +335,11 @@ TransformsManager::RegisterTransform(Transform *pointer, const Math::Matrix &wor
         local = world.FastMultiply(local);
     }
 
-    // setup entry
-    entry->id = id;
-    entry->parent = parentId;
-    entry->descendantsCount = 0;
-    entry->flags = kFlagsDirty | kFlagsHasChanged;
-    entry->local[0] = Math::Vector4(local[ 0], local[ 4], local[ 8], local[12]);
-    entry->local[1] = Math::Vector4(local[ 1], local[ 5], local[ 9], local[13]);
-    entry->local[2] = Math::Vector4(local[ 2], local[ 6], local[10], local[14]);
-    entry->world[0] = Math::Vector4(world[ 0], world[ 4], world[ 8], world[12]);
-    entry->world[1] = Math::Vector4(world[ 1], world[ 5], world[ 9], world[13]);
-    entry->world[2] = Math::Vector4(world[ 2], world[ 6], world[10], world[14]);
-
-    if (pointer != nullptr)
-        pointer->id = id;
+    Math::Vector3 position, scale;
+    Math::Quaternion rotation;
+    local.Decompose(position, rotation, scale);
 
-    return id;
+    return this->RegisterTransform(pointer, position, rotation, scale, parentId);
 }
 
 void
@@ -95,31 +361,43 @@ TransformsManager::OnTransformNameChanged(Transform *pointer, const StringHash &
 void
 TransformsManager::UnregisterTransform(Transform *pointer, uint32_t id)
 {
-    uint32_t index    = indices.Get(id),
-             parentId = entries[index].parent;
-
-    TransformEntry *descendantsEnd = entries.Begin() + entries[index].descendantsCount + 1;
-
-    entries.RemoveAt(index);
-    indices.Free(id);
+    if (editing) {
+        // dropped by EndEdit, the id stays allocated until then
+        entries[indices.Get(id)].flags |= kFlagsRemoved;
 
-    // move other indices & change parent / assign dirty flag
-    for (TransformEntry *movedEntry = entries.Begin() + index; movedEntry < entries.End(); ++movedEntry) {
-        if (movedEntry < descendantsEnd) {
-            movedEntry->flags |= kFlagsDirty;
-
-            if (movedEntry->parent == id)
+        EditOp op = { id, kParentRemoved };
+        editOps.PushBack(op);
+    } else {
+        uint32_t index            = indices.Get(id),
+                 parentId         = entries[index].parent,
+                 descendantsCount = entries[index].descendantsCount;
+
+        if (entries[index].flags & kFlagsDirtyRoot)
+            dirtyRoots.Remove(id);
+
+        entries.RemoveAt(index);
+        localPositions.RemoveAt(index);
+        localRotations.RemoveAt(index);
+        localScales.RemoveAt(index);
+        indices.Free(id);
+
+        // move other indices, children go to the parent & become dirty
+        TransformEntry *descendantsEnd = entries.Begin() + index + descendantsCount;
+        for (TransformEntry *movedEntry = entries.Begin() + index; movedEntry < entries.End(); ++movedEntry) {
+            if (movedEntry < descendantsEnd && movedEntry->parent == id) {
                 movedEntry->parent = parentId;
-        }
+                this->SetDirty(movedEntry);
+            }
 
-        indices.Set(movedEntry->id, movedEntry - entries.Begin());
-    }
+            indices.Set(movedEntry->id, movedEntry - entries.Begin());
+        }
 
-    // update descendants
-    while (parentId != kParentNull) {
-        TransformEntry *parentEntry = entries.Begin() + indices.Get(parentId);
-        --parentEntry->descendantsCount;
-        parentId = parentEntry->parent;
+        // update descendants
+        while (parentId != kParentNull) {
+            TransformEntry *parentEntry = entries.Begin() + indices.Get(parentId);
+            --parentEntry->descendantsCount;
+            parentId = parentEntry->parent;
+        }
     }
 
     if (pointer != nullptr) {
@@ -137,25 +415,53 @@ TransformsManager::UnregisterTransform(Transform *pointer, uint32_t id)
 bool
 TransformsManager::IsDirty(uint32_t transformId)
 {
-    return kFlagsDirty == (entries[indices.Get(transformId)].flags & kFlagsDirty);
+    return this->FindDirtyRoot(entries.Begin() + indices.Get(transformId)) != nullptr;
 }
 
 bool
 TransformsManager::HasChanged(uint32_t transformId)
 {
-    return kFlagsHasChanged == (entries[indices.Get(transformId)].flags & kFlagsHasChanged);
+    return changed[transformId] != 0;
+}
+
+uint32_t
+TransformsManager::GetHierarchyIndex(uint32_t transformId) const
+{
+    return indices.Get(transformId);
 }
 
 void
 TransformsManager::SetParent(uint32_t transformId, uint32_t newParentId)
 {
+    if (editing) {
+        // moved by EndEdit
+        assert(kParentNull == newParentId || 0 == (entries[indices.Get(newParentId)].flags & kFlagsRemoved));
+        TransformEntry *entry = entries.Begin() + indices.Get(transformId);
+        entry->parent = newParentId;
+        this->SetDirty(entry);
+
+        EditOp op = { transformId, newParentId };
+        editOps.PushBack(op);
+        return;
+    }
+
     uint32_t prevIndex = indices.Get(transformId),
              parentId  = entries[prevIndex].parent;
 
     // copy & remove descendants
-    Array<TransformEntry> entriesToMove(Memory::GetAllocator<ScratchAllocator>(), entries[prevIndex].descendantsCount + 1);
-    entriesToMove.InsertRange(0, &entries[prevIndex], entriesToMove.Capacity());
-    entries.RemoveRange(prevIndex, entriesToMove.Count());
+    uint32_t count = entries[prevIndex].descendantsCount + 1;
+    Array<TransformEntry> entriesToMove(Memory::GetAllocator<ScratchAllocator>(), count);
+    Array<Math::Vector3> positionsToMove(Memory::GetAllocator<ScratchAllocator>(), count);
+    Array<Math::Quaternion> rotationsToMove(Memory::GetAllocator<ScratchAllocator>(), count);
+    Array<Math::Vector3> scalesToMove(Memory::GetAllocator<ScratchAllocator>(), count);
+    entriesToMove.InsertRange(0, &entries[prevIndex], count);
+    positionsToMove.InsertRange(0, &localPositions[prevIndex], count);
+    rotationsToMove.InsertRange(0, &localRotations[prevIndex], count);
+    scalesToMove.InsertRange(0, &localScales[prevIndex], count);
+    entries.RemoveRange(prevIndex, count);
+    localPositions.RemoveRange(prevIndex, count);
+    localRotations.RemoveRange(prevIndex, count);
+    localScales.RemoveRange(prevIndex, count);
 
     // move other indices
     for (TransformEntry *movedEntry = entries.Begin() + prevIndex; movedEntry < entries.End(); ++movedEntry)
@@ -171,20 +477,21 @@ TransformsManager::SetParent(uint32_t transformId, uint32_t newParentId)
     entriesToMove.Front().parent = newParentId;
 
     uint32_t newIndex;
-    TransformEntry *movedEntriesEnd;
     if (kParentNull == newParentId) {
         // place @ end
         newIndex = entries.Count();
-        entries.InsertRange(newIndex, entriesToMove.Begin(), entriesToMove.Count());
-
-        movedEntriesEnd = entries.End();
+        entries.InsertRange(newIndex, entriesToMove.Begin(), count);
+        localPositions.InsertRange(newIndex, positionsToMove.Begin(), count);
+        localRotations.InsertRange(newIndex, rotationsToMove.Begin(), count);
+        localScales.InsertRange(newIndex, scalesToMove.Begin(), count);
     } else {
         // place after last parent descendant
         newIndex = indices.Get(newParentId);
         newIndex += (entries[newIndex].descendantsCount + 1);
-        entries.InsertRange(newIndex, entriesToMove.Begin(), entriesToMove.Count());
-
-        movedEntriesEnd = entries.Begin() + newIndex + entriesToMove.Count();
+        entries.InsertRange(newIndex, entriesToMove.Begin(), count);
+        localPositions.InsertRange(newIndex, positionsToMove.Begin(), count);
+        localRotations.InsertRange(newIndex, rotationsToMove.Begin(), count);
+        localScales.InsertRange(newIndex, scalesToMove.Begin(), count);
 
         // update descendants
         while (newParentId != kParentNull) {
@@ -194,201 +501,407 @@ TransformsManager::SetParent(uint32_t transformId, uint32_t newParentId)
         }
     }
 
-    // move indices & assign dirty flag
-    for (TransformEntry *movedEntry = entries.Begin() + newIndex; movedEntry < entries.End(); ++movedEntry) {
-        if (movedEntry < movedEntriesEnd)
-            movedEntry->flags |= kFlagsDirty;
-
+    // move indices
+    for (TransformEntry *movedEntry = entries.Begin() + newIndex; movedEntry < entries.End(); ++movedEntry)
         indices.Set(movedEntry->id, movedEntry - entries.Begin());
-    }
+
+    this->SetDirty(entries.Begin() + newIndex);
+}
+
+const Math::Vector3&
+TransformsManager::GetLocalPosition(uint32_t transformId) const
+{
+    return localPositions[indices.Get(transformId)];
+}
+
+const Math::Quaternion&
+TransformsManager::GetLocalRotation(uint32_t transformId) const
+{
+    return localRotations[indices.Get(transformId)];
+}
+
+const Math::Vector3&
+TransformsManager::GetLocalScale(uint32_t transformId) const
+{
+    return localScales[indices.Get(transformId)];
 }
 
 void
-TransformsManager::SetLocalMatrix(uint32_t transformId, const Math::Matrix &local)
+TransformsManager::SetLocalPosition(uint32_t transformId, const Math::Vector3 &position)
 {
-    TransformEntry *entry = entries.Begin() + indices.Get(transformId);
+    uint32_t index = indices.Get(transformId);
+    localPositions[index] = position;
+    this->SetDirty(entries.Begin() + index);
+}
 
-    entry->local[0] = Math::Vector4(local[ 0], local[ 4], local[ 8], local[12]);
-    entry->local[1] = Math::Vector4(local[ 1], local[ 5], local[ 9], local[13]);
-    entry->local[2] = Math::Vector4(local[ 2], local[ 6], local[10], local[14]);
-    entry->flags |= kFlagsDirty;
+void
+TransformsManager::SetLocalRotation(uint32_t transformId, const Math::Quaternion &rotation)
+{
+    uint32_t index = indices.Get(transformId);
+    localRotations[index] = rotation;
+    this->SetDirty(entries.Begin() + index);
+}
 
-    TransformEntry *descendantsEnd = entry + entry->descendantsCount + 1;
-    for (TransformEntry *descendant = entry + 1; descendant < descendantsEnd; ++descendant)
-        descendant->flags |= kFlagsDirty;
+void
+TransformsManager::SetLocalScale(uint32_t transformId, const Math::Vector3 &scale)
+{
+    uint32_t index = indices.Get(transformId);
+    localScales[index] = scale;
+    this->SetDirty(entries.Begin() + index);
 }
 
 void
-TransformsManager::SetWorldMatrix(uint32_t transformId, const Math::Matrix &world)
+TransformsManager::SetLocalMatrix(uint32_t transformId, const Math::Matrix &local)
 {
-    TransformEntry *entry = entries.Begin() + indices.Get(transformId);
+    uint32_t index = indices.Get(transformId);
+    local.Decompose(localPositions[index], localRotations[index], localScales[index]);
+    this->SetDirty(entries.Begin() + index);
+}
 
-    entry->world[0] = Math::Vector4(world[ 0], world[ 4], world[ 8], world[12]);
-    entry->world[1] = Math::Vector4(world[ 1], world[ 5], world[ 9], world[13]);
-    entry->world[2] = Math::Vector4(world[ 2], world[ 6], world[10], world[14]);
+void
+TransformsManager::SetWorldMatrix(uint32_t transformId, const Math::Matrix &world)
+{
+    uint32_t index = indices.Get(transformId);
+    TransformEntry *entry = entries.Begin() + index;
 
-    if (kParentNull == entry->parent) {
-        entry->local[0] = entry->world[0];
-        entry->local[1] = entry->world[1];
-        entry->local[2] = entry->world[2];
+    uint32_t parentId = this->GetParentAfterEdit(*entry);
+    if (kParentNull == parentId) {
+        world.Decompose(localPositions[index], localRotations[index], localScales[index]);
     } else {
-        Math::Matrix local = this->GetWorldMatrix(entry->parent);
+        Math::Matrix local = this->GetWorldMatrix(parentId);
         local.FastInvert();
         local = world.FastMultiply(local);
 
-        entry->local[0] = Math::Vector4(local[ 0], local[ 4], local[ 8], local[12]);
-        entry->local[1] = Math::Vector4(local[ 1], local[ 5], local[ 9], local[13]);
-        entry->local[2] = Math::Vector4(local[ 2], local[ 6], local[10], local[14]);
+        local.Decompose(localPositions[index], localRotations[index], localScales[index]);
     }
 
-    TransformEntry *descendantsEnd = entry + entry->descendantsCount + 1;
-    for (TransformEntry *descendant = entry + 1; descendant < descendantsEnd; ++descendant)
-        descendant->flags |= kFlagsDirty;
+    // world is composed again from the decomposed local, like for the other setters
+    this->SetDirty(entry);
 }
 
-Math::Matrix
-TransformsManager::GetLocalMatrix(uint32_t transformId)
+void
+TransformsManager::SetWorldPosition(uint32_t transformId, const Math::Vector3 &position)
 {
-    TransformEntry *entry = entries.Begin() + indices.Get(transformId);
+    uint32_t index = indices.Get(transformId);
+    TransformEntry *entry = entries.Begin() + index;
 
-    Math::Matrix local;
-    local.GetColumn(0) = entry->local[0];
-    local.GetColumn(1) = entry->local[1];
-    local.GetColumn(2) = entry->local[2];
-    local.GetColumn(3) = Math::Vector4(0.0f, 0.0f, 0.0f, 1.0f);
-    local.Transpose();
+    uint32_t parentId = this->GetParentAfterEdit(*entry);
+    if (kParentNull == parentId)
+        localPositions[index] = position;
+    else
+        localPositions[index] = this->GetWorldMatrix(parentId).GetFastInverse().FastMultiplyPoint(position);
+
+    this->SetDirty(entry);
+}
 
-    return local;
+Math::Matrix
+TransformsManager::GetLocalMatrix(uint32_t transformId)
+{
+    uint32_t index = indices.Get(transformId);
+    return Math::Matrix(localPositions[index], localRotations[index], localScales[index]);
 }
 
 Math::Matrix
 TransformsManager::GetWorldMatrix(uint32_t transformId)
 {
     TransformEntry *entry = entries.Begin() + indices.Get(transformId);
-    if (entry->flags & kFlagsDirty) {
-        // find a parent that isn't dirty or root
-        TransformEntry *parent = nullptr, *node = entry;
-		while (node->parent != kParentNull) {
-			parent = entries.Begin() + indices.Get(node->parent);
-			if (0 == (parent->flags & kFlagsDirty))
-                break;
-			node = parent;
+    const Math::Vector4 *rows = entry->world;
+
+    Math::Vector4 editedWorld[3];
+    if (editing) {
+        // entries aren't in hierarchy order until EndEdit, compose from the root down like the update does
+        Array<uint32_t> chain(Memory::GetAllocator<ScratchAllocator>());
+        for (uint32_t id = transformId; id != kParentNull; id = this->GetParentAfterEdit(entries[chain.Back()]))
+            chain.PushBack(indices.Get(id));
+
+        uint32_t index = chain.Back();
+        Math::AffineCompose(localPositions[index], localRotations[index], localScales[index], editedWorld);
+        for (uint32_t i = chain.Count() - 1; i > 0; --i) {
+            Math::Vector4 local[3], parent[3] = { editedWorld[0], editedWorld[1], editedWorld[2] };
+            index = chain[i - 1];
+            Math::AffineCompose(localPositions[index], localRotations[index], localScales[index], local);
+            Math::AffineMultiply(parent, local, editedWorld);
+        }
+        rows = editedWorld;
+    } else {
+        TransformEntry *dirtyRoot = this->FindDirtyRoot(entry);
+        if (dirtyRoot != nullptr) {
+            // stays in dirtyRoots, the frame update skips it once it's clean
+            this->UpdateTransforms(dirtyRoot);
+            anyChanged = true;
         }
-        this->UpdateTransforms(node, false);
     }
 
     Math::Matrix world;
-    world.GetColumn(0) = entry->world[0];
-    world.GetColumn(1) = entry->world[1];
-    world.GetColumn(2) = entry->world[2];
+    world.GetColumn(0) = rows[0];
+    world.GetColumn(1) = rows[1];
+    world.GetColumn(2) = rows[2];
     world.GetColumn(3) = Math::Vector4(0.0f, 0.0f, 0.0f, 1.0f);
     world.Transpose();
 
     return world;
 }
 
-TransformsManager::TransformEntry*
-TransformsManager::UpdateTransforms(TransformEntry *startTransform, bool clearHasChanged)
-{
-    uint32_t lastParentId = startTransform->id;
-    Math::Matrix lastParentWorld, world, local;
-
-    if (startTransform->flags & kFlagsDirty) {
-        if (kParentNull == startTransform->parent) {
-            startTransform->world[0] = startTransform->local[0];
-            startTransform->world[1] = startTransform->local[1];
-            startTransform->world[2] = startTransform->local[2];
-
-            lastParentWorld.GetColumn(0) = startTransform->world[0];
-            lastParentWorld.GetColumn(1) = startTransform->world[1];
-            lastParentWorld.GetColumn(2) = startTransform->world[2];
-            lastParentWorld.GetColumn(3) = Math::Vector4(0.0f, 0.0f, 0.0f, 1.0f);
-            lastParentWorld.Transpose();
-        } else {
-            TransformEntry *parentEntry = entries.Begin() + indices.Get(startTransform->parent);
-            assert(0 == (parentEntry->flags & kFlagsDirty));
-
-            world.GetColumn(0) = parentEntry->world[0];
-            world.GetColumn(1) = parentEntry->world[1];
-            world.GetColumn(2) = parentEntry->world[2];
-            world.GetColumn(3) = Math::Vector4(0.0f, 0.0f, 0.0f, 1.0f);
-            world.Transpose();
-
-            local.GetColumn(0) = startTransform->local[0];
-            local.GetColumn(1) = startTransform->local[1];
-            local.GetColumn(2) = startTransform->local[2];
-            local.GetColumn(3) = Math::Vector4(0.0f, 0.0f, 0.0f, 1.0f);
-            local.Transpose();
-
-            lastParentWorld = local.FastMultiply(world);
-
-            startTransform->world[0] = Math::Vector4(lastParentWorld[ 0], lastParentWorld[ 4], lastParentWorld[ 8], lastParentWorld[12]);
-            startTransform->world[1] = Math::Vector4(lastParentWorld[ 1], lastParentWorld[ 5], lastParentWorld[ 9], lastParentWorld[13]);
-            startTransform->world[2] = Math::Vector4(lastParentWorld[ 2], lastParentWorld[ 6], lastParentWorld[10], lastParentWorld[14]);
-        }
+void
+TransformsManager::UpdateRange(TransformEntry *first, TransformEntry *end)
+{
+    uint32_t lastParentId = kParentNull;
+    TransformEntry *lastParent = nullptr;
 
-        startTransform->flags &= ~kFlagsDirty;
-        startTransform->flags |= kFlagsHasChanged;
-    } else {
-        lastParentWorld.GetColumn(0) = startTransform->world[0];
-        lastParentWorld.GetColumn(1) = startTransform->world[1];
-        lastParentWorld.GetColumn(2) = startTransform->world[2];
-        lastParentWorld.GetColumn(3) = Math::Vector4(0.0f, 0.0f, 0.0f, 1.0f);
-        lastParentWorld.Transpose();
+    TransformEntry *entry = first;
+    while (entry < end) {
+        if (kParentNull == entry->parent) {
+            uint32_t index = entry - entries.Begin();
+            Math::AffineCompose(localPositions[index], localRotations[index], localScales[index], entry->world);
 
-        if (clearHasChanged)
-            startTransform->flags &= ~kFlagsHasChanged;
-    }
+            entry->flags &= ~kFlagsDirty;
+            changed[entry->id] = 1;
 
-    TransformEntry *entry = startTransform + 1, *end = startTransform + startTransform->descendantsCount + 1;
-    while (entry < end) {
-        if (0 == (entry->flags & kFlagsDirty))
-        {
-            if (clearHasChanged)
-                entry->flags &= ~kFlagsHasChanged;
             ++entry;
             continue;
         }
 
         if (entry->parent != lastParentId) {
-            TransformEntry *parent = entries.Begin() + indices.Get(entry->parent);
-            lastParentWorld.GetColumn(0) = parent->world[0];
-            lastParentWorld.GetColumn(1) = parent->world[1];
-            lastParentWorld.GetColumn(2) = parent->world[2];
-            lastParentWorld.GetColumn(3) = Math::Vector4(0.0f, 0.0f, 0.0f, 1.0f);
-            lastParentWorld.Transpose();
+            lastParent = entries.Begin() + indices.Get(entry->parent);
             lastParentId = entry->parent;
+            assert(0 == (lastParent->flags & kFlagsDirty));
+        }
+
+        // siblings without descendants are next to each other, multiply them in one go
+        TransformEntry *run = entry;
+        do {
+            entry->flags &= ~kFlagsDirty;
+            changed[entry->id] = 1;
+            ++entry;
+        } while (entry < end && entry->parent == lastParentId);
+
+        uint32_t index = run - entries.Begin();
+        Math::AffineComposeMultiplyBatch(lastParent->world,
+            localPositions.Begin() + index, localRotations.Begin() + index, localScales.Begin() + index,
+            run->world, sizeof(TransformEntry), entry - run);
+    }
+}
+
+TransformsManager::TransformEntry*
+TransformsManager::UpdateTransforms(TransformEntry *startTransform)
+{
+    TransformEntry *end = startTransform + startTransform->descendantsCount + 1;
+    this->UpdateRange(startTransform, end);
+    return end;
+}
+
+uint32_t
+TransformsManager::CollectDirtyRanges()
+{
+    dirtyRanges.Clear();
+    for (const uint32_t *id = dirtyRoots.Begin(); id < dirtyRoots.End(); ++id) {
+        uint32_t index = indices.Get(*id);
+        TransformEntry *entry = entries.Begin() + index;
+
+        // may have been updated already by GetWorldMatrix
+        entry->flags &= ~kFlagsDirtyRoot;
+        if (0 == (entry->flags & kFlagsDirty))
+            continue;
+
+        EntryRange range = { index, index + entry->descendantsCount + 1 };
+        dirtyRanges.PushBack(range);
+    }
+    dirtyRoots.Clear();
+
+    if (dirtyRanges.IsEmpty())
+        return 0;
+
+    Array<EntryRange>::Sort(dirtyRanges, 0, dirtyRanges.Count(), [] (const EntryRange &a, const EntryRange &b) {
+        return a.first < b.first;
+    });
+
+    // subtrees are either nested or disjoint, keep the outer ones
+    uint32_t count = 0, total = 0;
+    for (uint32_t i = 0; i < dirtyRanges.Count(); ++i) {
+        if (count > 0 && dirtyRanges[i].first < dirtyRanges[count - 1].end)
+            continue;
+
+        dirtyRanges[count++] = dirtyRanges[i];
+        total += dirtyRanges[i].end - dirtyRanges[i].first;
+    }
+    dirtyRanges.Resize(count);
+
+    return total;
+}
+
+void
+TransformsManager::SplitWork(uint32_t itemSize)
+{
+    updateRanges.Clear();
+    workItems.Clear();
+    splitStack.Clear();
+
+    for (uint32_t i = dirtyRanges.Count(); i > 0; --i)
+        splitStack.PushBack(dirtyRanges[i - 1]);
+
+    // ranges are grouped in items of about itemSize entries
+    uint32_t itemFirst = 0, itemEntries = 0;
+    auto addRange = [&] (uint32_t first, uint32_t end) {
+        EntryRange range = { first, end };
+        updateRanges.PushBack(range);
+
+        itemEntries += end - first;
+        if (itemEntries >= itemSize) {
+            EntryRange item = { itemFirst, updateRanges.Count() };
+            workItems.PushBack(item);
+            itemFirst = updateRanges.Count();
+            itemEntries = 0;
         }
+    };
+
+    while (!splitStack.IsEmpty()) {
+        // siblings subtrees, their parent is up to date
+        EntryRange range = splitStack.Back();
+        splitStack.PopBack();
+
+        uint32_t parentId = entries[range.first].parent,
+                 first    = range.first;
+        while (first < range.end) {
+            if (range.end - first <= itemSize) {
+                addRange(first, range.end);
+                break;
+            }
+
+            // cut after the subtree holding the entry itemSize ahead, without walking the ones before it
+            TransformEntry *child = entries.Begin() + first;
+            if (child->descendantsCount < itemSize) {
+                child = entries.Begin() + first + itemSize;
+                while (child->parent != parentId)
+                    child = entries.Begin() + indices.Get(child->parent);
+            }
+
+            uint32_t childIndex = child - entries.Begin(),
+                     childEnd   = childIndex + child->descendantsCount + 1;
+
+            if (childEnd - childIndex <= itemSize) {
+                addRange(first, childEnd);
+            } else {
+                // too large, update its root here and split its children again
+                if (childIndex > first)
+                    addRange(first, childIndex);
 
-        local.GetColumn(0) = entry->local[0];
-        local.GetColumn(1) = entry->local[1];
-        local.GetColumn(2) = entry->local[2];
-        local.GetColumn(3) = Math::Vector4(0.0f, 0.0f, 0.0f, 1.0f);
-        local.Transpose();
+                this->UpdateRange(child, child + 1);
 
-        world = local.FastMultiply(lastParentWorld);
+                if (childEnd > childIndex + 1) {
+                    EntryRange children = { childIndex + 1, childEnd };
+                    splitStack.PushBack(children);
+                }
+            }
 
-        entry->world[0] = Math::Vector4(world[ 0], world[ 4], world[ 8], world[12]);
-        entry->world[1] = Math::Vector4(world[ 1], world[ 5], world[ 9], world[13]);
-        entry->world[2] = Math::Vector4(world[ 2], world[ 6], world[10], world[14]);
+            first = childEnd;
+        }
+    }
 
-        entry->flags &= ~kFlagsDirty;
-        entry->flags |= kFlagsHasChanged;
+    if (itemFirst < updateRanges.Count()) {
+        EntryRange item = { itemFirst, updateRanges.Count() };
+        workItems.PushBack(item);
+    }
+}
 
-        ++entry;
+void
+TransformsManager::RunWorkItems()
+{
+    uint32_t count = workItems.Count();
+    for (uint32_t i = nextWorkItem++; i < count; i = nextWorkItem++) {
+        const EntryRange &item = workItems[i];
+        for (uint32_t j = item.first; j < item.end; ++j)
+            this->UpdateRange(entries.Begin() + updateRanges[j].first, entries.Begin() + updateRanges[j].end);
     }
+}
+
+void
+TransformsManager::UpdateThread(uint32_t frame)
+{
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(updateMutex);
+            while (!quitRequest && frame == updateFrame)
+                updateSignal.wait(lock);
+            if (quitRequest)
+                return;
+            frame = updateFrame;
+        }
 
-    return entry;
+        this->RunWorkItems();
+
+        {
+            std::lock_guard<std::mutex> guard(updateMutex);
+            --runningThreads;
+        }
+        updateSignal.notify_all();
+    }
+}
+
+void
+TransformsManager::StopUpdateThreads()
+{
+    {
+        std::lock_guard<std::mutex> guard(updateMutex);
+        quitRequest = true;
+    }
+    updateSignal.notify_all();
+
+    for (uint32_t i = 0; i < numUpdateThreads - 1; ++i)
+        updateThreads[i].join();
+
+    quitRequest = false;
+    numUpdateThreads = 1;
+}
+
+void
+TransformsManager::SetUpdateThreads(uint32_t count)
+{
+    assert(count > 0 && count <= kMaxUpdateThreads);
+
+    this->StopUpdateThreads();
+
+    numUpdateThreads = count;
+    for (uint32_t i = 0; i < count - 1; ++i)
+        updateThreads[i] = std::thread(&TransformsManager::UpdateThread, this, updateFrame);
+}
+
+uint32_t
+TransformsManager::GetUpdateThreads() const
+{
+    return numUpdateThreads;
 }
 
 TransformsManager::TransformsManager()
 : entries(Memory::GetAllocator<MallocAllocator>()),
+  localPositions(Memory::GetAllocator<MallocAllocator>()),
+  localRotations(Memory::GetAllocator<MallocAllocator>()),
+  localScales(Memory::GetAllocator<MallocAllocator>()),
   indices(Memory::GetAllocator<MallocAllocator>()),
-  transforms(Memory::GetAllocator<MallocAllocator>())
-{ }
+  transforms(Memory::GetAllocator<MallocAllocator>()),
+  editing(false),
+  editFirstAdded(0),
+  editOps(Memory::GetAllocator<MallocAllocator>()),
+  dirtyRoots(Memory::GetAllocator<MallocAllocator>()),
+  dirtyRanges(Memory::GetAllocator<MallocAllocator>()),
+  changed(Memory::GetAllocator<MallocAllocator>()),
+  anyChanged(false),
+  updateRanges(Memory::GetAllocator<MallocAllocator>()),
+  workItems(Memory::GetAllocator<MallocAllocator>()),
+  splitStack(Memory::GetAllocator<MallocAllocator>()),
+  nextWorkItem(0),
+  numUpdateThreads(1),
+  updateFrame(0),
+  runningThreads(0),
+  quitRequest(false)
+{
+    uint32_t count = std::thread::hardware_concurrency();
+    this->SetUpdateThreads(count < 1 ? 1 : (count > kMaxUpdateThreads ? kMaxUpdateThreads : count));
+}
 
 TransformsManager::~TransformsManager()
-{ }
+{
+    this->StopUpdateThreads();
+}
 
 Handle<Transform>
 TransformsManager::Find(const String &path) const
@@ -459,9 +972,38 @@ TransformsManager::OnLateUpdate()
 void
 TransformsManager::OnRender()
 {
-    TransformEntry *entry = entries.Begin(), *end = entries.End();
-    while (entry < end)
-        entry = this->UpdateTransforms(entry, true);
+    assert(!editing);
+
+    // only the dirty subtrees are visited
+    uint32_t count = this->CollectDirtyRanges();
+    if (0 == count)
+        return;
+
+    anyChanged = true;
+
+    uint32_t itemSize = count / (numUpdateThreads * 4);
+    if (numUpdateThreads < 2 || itemSize < kMinWorkItemSize) {
+        for (const EntryRange *range = dirtyRanges.Begin(); range < dirtyRanges.End(); ++range)
+            this->UpdateRange(entries.Begin() + range->first, entries.Begin() + range->end);
+        return;
+    }
+
+    // a few items per thread, so that uneven subtrees still balance out
+    this->SplitWork(itemSize);
+
+    nextWorkItem = 0;
+    {
+        std::lock_guard<std::mutex> guard(updateMutex);
+        ++updateFrame;
+        runningThreads = numUpdateThreads - 1;
+    }
+    updateSignal.notify_all();
+
+    this->RunWorkItems();
+
+    std::unique_lock<std::mutex> lock(updateMutex);
+    while (runningThreads > 0)
+        updateSignal.wait(lock);
 }
 
 void
@@ -476,4 +1018,13 @@ void
 TransformsManager::OnQuit()
 { }
 
+void
+TransformsManager::OnEndFrame()
+{
+    if (anyChanged) {
+        Memory::Zero(changed.Begin(), changed.Count());
+        anyChanged = false;
+    }
+}
+
 } // namespace Managers
@@ -1,7 +1,14 @@
 #pragma once
 
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
 #include "Managers/BaseManager.h"
+#include "Math/Vector3.h"
 #include "Math/Vector4.h"
+#include "Math/Quaternion.h"
 #include "Math/Matrix.h"
 #include "Core/Collections/SimplePool_type.h"
 #include "Core/Collections/Hash_type.h"
@@ -17,41 +24,140 @@ class TransformsManager : public BaseManager {
     DeclareManager;
 public:
     static const uint32_t kParentNull = 0xffffffff;
+
+    static const uint32_t kMaxUpdateThreads = 8;
 private:
-    static const uint32_t kFlagsDirty      = 1 << 0;
-    static const uint32_t kFlagsHasChanged = 1 << 1;
+    // only the roots of the stale subtrees are flagged dirty, their descendants aren't
+    static const uint32_t kFlagsDirty     = 1 << 0;
+    static const uint32_t kFlagsDirtyRoot = 1 << 1; // id is in dirtyRoots
+    static const uint32_t kFlagsRemoved   = 1 << 2; // while editing
+
+    // parent of the edits removing a transform, and of the transforms not linked in EndEdit
+    static const uint32_t kParentRemoved = 0xfffffffe;
 
+    // Local position, rotation and scale are in the arrays below, at the same index.
     struct TransformEntry {
         uint32_t id;
         uint32_t parent;
         uint32_t descendantsCount;
         uint32_t flags;
-        // ToDo: look if storing pos, quat & scaling is faster
-        Math::Vector4 local[3];
         Math::Vector4 world[3];
         //Skeleton* skel;
     };
 
+    // Transform added, moved or removed while editing, in call order.
+    struct EditOp {
+        uint32_t id;
+        uint32_t parent;
+    };
+
+    // Children lists built by EndEdit, by id.
+    struct EditLink {
+        uint32_t parent;
+        uint32_t firstChild;
+        uint32_t lastChild;
+        uint32_t prevSibling;
+        uint32_t nextSibling;
+    };
+
+    // Fewer transforms than this aren't worth handing to another thread.
+    static const uint32_t kMinWorkItemSize = 2048;
+
+    // Range of entries made of whole subtrees, whose parents are up to date.
+    struct EntryRange {
+        uint32_t first;
+        uint32_t end;
+    };
+
     Array<TransformEntry> entries;
+    Array<Math::Vector3> localPositions;
+    Array<Math::Quaternion> localRotations;
+    Array<Math::Vector3> localScales;
     SimplePool<uint32_t> indices;
 
     Hash<Handle<Transform>> transforms;
 
-    TransformEntry* UpdateTransforms(TransformEntry *startTransform, bool clearHasChanged);
+    bool editing;
+    uint32_t editFirstAdded; // entries from here on were added while editing
+    Array<EditOp> editOps;
+
+    Array<uint32_t> dirtyRoots;
+    Array<EntryRange> dirtyRanges; // disjoint subtrees in hierarchy order
+    // by id, cleared at the end of the frame. A byte per id so that update threads don't share words.
+    Array<uint8_t> changed;
+    bool anyChanged;
+
+    Array<EntryRange> updateRanges;
+    Array<EntryRange> workItems; // ranges of updateRanges
+    Array<EntryRange> splitStack;
+    std::atomic<uint32_t> nextWorkItem;
+
+    uint32_t                numUpdateThreads;
+    std::thread             updateThreads[kMaxUpdateThreads - 1];
+    std::mutex              updateMutex;
+    std::condition_variable updateSignal;
+    uint32_t                updateFrame, runningThreads;
+    bool                    quitRequest;
+
+    void InsertEntry(uint32_t index, const Math::Vector3 &position, const Math::Quaternion &rotation, const Math::Vector3 &scale);
+    void SetDirty(TransformEntry *entry);
+    TransformEntry* FindDirtyRoot(TransformEntry *entry);
+    uint32_t GetParentAfterEdit(const TransformEntry &entry) const;
+
+    void UpdateRange(TransformEntry *first, TransformEntry *end);
+    TransformEntry* UpdateTransforms(TransformEntry *startTransform);
+
+    uint32_t CollectDirtyRanges();
+    void SplitWork(uint32_t itemSize);
+    void RunWorkItems();
+    void UpdateThread(uint32_t frame);
+    void StopUpdateThreads();
 public:
     TransformsManager();
     virtual ~TransformsManager();
 
+    // Threads updating the world matrices in OnRender, the calling one included. Results are the same for any count.
+    void SetUpdateThreads(uint32_t count);
+    uint32_t GetUpdateThreads() const;
+
+    // Transforms added, removed or moved in the hierarchy between BeginEdit and EndEdit are placed
+    // by EndEdit in a single pass, instead of shifting the hierarchy at each call. The hierarchy order
+    // is the same the calls would have given one at a time: added and moved transforms go after the
+    // children their parent has at the time of the call, children of removed ones take their place.
+    // World matrices read in between are composed up the parent chain at each call, which is slower.
+    void BeginEdit();
+    void EndEdit();
+    bool IsEditing() const;
+
+    uint32_t RegisterTransform(Transform *pointer, const Math::Vector3 &position, const Math::Quaternion &rotation, const Math::Vector3 &scale, uint32_t parentId = kParentNull);
     uint32_t RegisterTransform(Transform *pointer, const Math::Matrix &world, uint32_t parentId = kParentNull);
     void OnTransformNameChanged(Transform *pointer, const StringHash &oldName);
     void UnregisterTransform(Transform *pointer, uint32_t id);
 
     bool IsDirty(uint32_t transformId);
+    // World matrix was recomputed during the current frame.
     bool HasChanged(uint32_t transformId);
 
+    // Position in depth first hierarchy order, parents come before their descendants.
+    uint32_t GetHierarchyIndex(uint32_t transformId) const;
+
     void SetParent(uint32_t transformId, uint32_t newParentId);
+
+    // References are valid until transforms are added, removed or moved in the hierarchy.
+    const Math::Vector3& GetLocalPosition(uint32_t transformId) const;
+    const Math::Quaternion& GetLocalRotation(uint32_t transformId) const;
+    const Math::Vector3& GetLocalScale(uint32_t transformId) const;
+
+    void SetLocalPosition(uint32_t transformId, const Math::Vector3 &position);
+    void SetLocalRotation(uint32_t transformId, const Math::Quaternion &rotation);
+    void SetLocalScale(uint32_t transformId, const Math::Vector3 &scale);
+
+    // Matrices are decomposed into the local position, rotation and scale, mirroring becomes a negative x scale.
+    // Shear is lost, so is the shear a world matrix needs in the local one under a rotated, non-uniformly
+    // scaled parent. SetWorldPosition only moves the local position and is exact.
     void SetLocalMatrix(uint32_t transformId, const Math::Matrix &local);
     void SetWorldMatrix(uint32_t transformId, const Math::Matrix &world);
+    void SetWorldPosition(uint32_t transformId, const Math::Vector3 &position);
 
     Math::Matrix GetLocalMatrix(uint32_t transformId);
     Math::Matrix GetWorldMatrix(uint32_t transformId);
@@ -70,6 +176,7 @@ public:
     virtual void OnPause();
     virtual void OnResume();
     virtual void OnQuit();
+    virtual void OnEndFrame();
 };
 
 } // namespace Framework
@@ -0,0 +1,159 @@
+#include "Math/Affine.h"
+#include "Math/Vector3.h"
+#include "Math/Vector4.h"
+#include "Math/Quaternion.h"
+
+namespace Framework {
+	namespace Math {
+
+#if defined(AFFINE_SSE)
+const char *kAffineKernelName = "sse";
+#else
+const char *kAffineKernelName = "scalar";
+#endif
+
+#if defined(AFFINE_SSE)
+static inline void
+MultiplySSE(const __m128 *p, const __m128 *t, __m128 l0, __m128 l1, __m128 l2, float *world)
+{
+    for (uint32_t r = 0; r < 3; ++r) {
+        __m128 w = _mm_add_ps(_mm_mul_ps(p[r * 3], l0), _mm_mul_ps(p[r * 3 + 1], l1));
+        w = _mm_add_ps(w, _mm_mul_ps(p[r * 3 + 2], l2));
+        _mm_storeu_ps(world + r * 4, _mm_add_ps(w, t[r]));
+    }
+}
+
+static inline void
+MultiplySSE(const __m128 *p, const __m128 *t, const float *local, float *world)
+{
+    MultiplySSE(p, t, _mm_loadu_ps(local), _mm_loadu_ps(local + 4), _mm_loadu_ps(local + 8), world);
+}
+
+static inline void
+LoadParentSSE(const Vector4 *parent, __m128 *p, __m128 *t)
+{
+    const __m128 wMask = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+    for (uint32_t r = 0; r < 3; ++r) {
+        p[r * 3    ] = _mm_set1_ps(parent[r].x);
+        p[r * 3 + 1] = _mm_set1_ps(parent[r].y);
+        p[r * 3 + 2] = _mm_set1_ps(parent[r].z);
+        t[r] = _mm_and_ps(_mm_loadu_ps(parent[r].xyzw), wMask);
+    }
+}
+#else
+static inline void
+MultiplyScalar(const Vector4 *parent, const float *local, float *world)
+{
+    for (uint32_t r = 0; r < 3; ++r) {
+        for (uint32_t c = 0; c < 4; ++c) {
+            float w = parent[r].x * local[c] + parent[r].y * local[4 + c];
+            w = w + parent[r].z * local[8 + c];
+            world[r * 4 + c] = w + (3 == c ? parent[r].w : 0.0f);
+        }
+    }
+}
+#endif
+
+void
+AffineMultiply(const Vector4 *parent, const Vector4 *local, Vector4 *world)
+{
+#if defined(AFFINE_SSE)
+    __m128 p[9], t[3];
+    LoadParentSSE(parent, p, t);
+    MultiplySSE(p, t, local->xyzw, world->xyzw);
+#else
+    // local may be world
+    float result[12];
+    MultiplyScalar(parent, local->xyzw, result);
+    for (uint32_t i = 0; i < 12; ++i)
+        world[i >> 2].xyzw[i & 3] = result[i];
+#endif
+}
+
+void
+AffineMultiplyBatch(const Vector4 *parent, const Vector4 *locals, uint32_t localStride, Vector4 *worlds, uint32_t worldStride, uint32_t count)
+{
+    const uint8_t *local = reinterpret_cast<const uint8_t*>(locals);
+    uint8_t *world = reinterpret_cast<uint8_t*>(worlds);
+
+#if defined(AFFINE_SSE)
+    __m128 p[9], t[3];
+    LoadParentSSE(parent, p, t);
+
+    for (; count > 0; --count, local += localStride, world += worldStride)
+        MultiplySSE(p, t, reinterpret_cast<const float*>(local), reinterpret_cast<float*>(world));
+#else
+    for (; count > 0; --count, local += localStride, world += worldStride)
+        MultiplyScalar(parent, reinterpret_cast<const float*>(local), reinterpret_cast<float*>(world));
+#endif
+}
+
+// Terms of Matrix(position, rotation, scale), same operations in the same order as its constructor.
+struct ComposeTerms {
+    float xy2, xz2, xw2, yz2, yw2, zw2, xx, yy, zz, ww;
+
+    ComposeTerms(const Quaternion &r)
+    : xy2(2.0f * r.i * r.j), xz2(2.0f * r.i * r.k), xw2(2.0f * r.i * r.w),
+      yz2(2.0f * r.j * r.k), yw2(2.0f * r.j * r.w),
+      zw2(2.0f * r.k * r.w),
+      xx(r.i * r.i), yy(r.j * r.j), zz(r.k * r.k), ww(r.w * r.w)
+    { }
+};
+
+static inline void
+ComposeRows(const Vector3 &position, const Quaternion &rotation, const Vector3 &scale, float *rows)
+{
+    ComposeTerms c(rotation);
+
+    rows[ 0] = (c.xx - c.yy - c.zz + c.ww) * scale.x;
+    rows[ 1] = (c.xy2 - c.zw2) * scale.y;
+    rows[ 2] = (c.xz2 + c.yw2) * scale.z;
+    rows[ 3] = position.x;
+    rows[ 4] = (c.xy2 + c.zw2) * scale.x;
+    rows[ 5] = (-c.xx + c.yy - c.zz + c.ww) * scale.y;
+    rows[ 6] = (c.yz2 - c.xw2) * scale.z;
+    rows[ 7] = position.y;
+    rows[ 8] = (c.xz2 - c.yw2) * scale.x;
+    rows[ 9] = (c.yz2 + c.xw2) * scale.y;
+    rows[10] = (-c.xx - c.yy + c.zz + c.ww) * scale.z;
+    rows[11] = position.z;
+}
+
+void
+AffineCompose(const Vector3 &position, const Quaternion &rotation, const Vector3 &scale, Vector4 *rows)
+{
+    ComposeRows(position, rotation, scale, rows->xyzw);
+}
+
+void
+AffineComposeMultiplyBatch(const Vector4 *parent, const Vector3 *positions, const Quaternion *rotations, const Vector3 *scales,
+                           Vector4 *worlds, uint32_t worldStride, uint32_t count)
+{
+    uint8_t *world = reinterpret_cast<uint8_t*>(worlds);
+
+#if defined(AFFINE_SSE)
+    __m128 p[9], t[3];
+    LoadParentSSE(parent, p, t);
+
+    // rows built in registers, going through memory stalls on store forwarding
+    for (uint32_t i = 0; i < count; ++i, world += worldStride) {
+        const Vector3 &position = positions[i], &scale = scales[i];
+        ComposeTerms c(rotations[i]);
+
+        __m128 l0 = _mm_set_ps(position.x, (c.xz2 + c.yw2) * scale.z, (c.xy2 - c.zw2) * scale.y, (c.xx - c.yy - c.zz + c.ww) * scale.x),
+               l1 = _mm_set_ps(position.y, (c.yz2 - c.xw2) * scale.z, (-c.xx + c.yy - c.zz + c.ww) * scale.y, (c.xy2 + c.zw2) * scale.x),
+               l2 = _mm_set_ps(position.z, (-c.xx - c.yy + c.zz + c.ww) * scale.z, (c.yz2 + c.xw2) * scale.y, (c.xz2 - c.yw2) * scale.x);
+
+        MultiplySSE(p, t, l0, l1, l2, reinterpret_cast<float*>(world));
+    }
+#else
+    float local[12];
+    for (uint32_t i = 0; i < count; ++i, world += worldStride) {
+        ComposeRows(positions[i], rotations[i], scales[i], local);
+        MultiplyScalar(parent, local, reinterpret_cast<float*>(world));
+    }
+#endif
+}
+
+	} // namespace Math
+} // namespace Framework
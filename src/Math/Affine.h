@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   include <emmintrin.h>
+#   define AFFINE_SSE
+#endif
+
+namespace Framework {
+	namespace Math {
+
+class Vector3;
+class Vector4;
+class Quaternion;
+
+// Affine transforms stored as three rows, the last row is implicitly (0, 0, 0, 1).
+// Rows hold the columns of Matrix, so the translation is in w.
+
+// Every path does the same operations in the same order, results don't depend on the kernel in use.
+extern const char *kAffineKernelName;
+
+// world = parent * local
+void AffineMultiply(const Vector4 *parent, const Vector4 *local, Vector4 *world);
+
+// Same parent for count transforms, strides are the bytes from one transform rows to the next.
+void AffineMultiplyBatch(const Vector4 *parent, const Vector4 *locals, uint32_t localStride, Vector4 *worlds, uint32_t worldStride, uint32_t count);
+
+// Rows of Matrix(position, rotation, scale).
+void AffineCompose(const Vector3 &position, const Quaternion &rotation, const Vector3 &scale, Vector4 *rows);
+
+// AffineMultiplyBatch with the locals composed from count consecutive positions, rotations and scales.
+void AffineComposeMultiplyBatch(const Vector4 *parent, const Vector3 *positions, const Quaternion *rotations, const Vector3 *scales,
+                                Vector4 *worlds, uint32_t worldStride, uint32_t count);
+
+	} // namespace Math
+} // namespace Framework
@@ -426,5 +426,29 @@ Matrix::FastMultiplyVector(const Vector3 &v) const
                    v.x * M[ 2] + v.y * M[ 6] + v.z * M[10]);
 }
 
+void
+Matrix::Decompose(Vector3 &t, Quaternion &r, Vector3 &s) const
+{
+    t = this->GetColumn(3);
+
+    s.x = this->GetColumn(0).GetMagnitude();
+    s.y = this->GetColumn(1).GetMagnitude();
+    s.z = this->GetColumn(2).GetMagnitude();
+
+    // A mirroring matrix goes into a negative x scale, what's left is a proper rotation.
+    if (this->GetFastDeterminant() < 0.0f)
+        s.x = -s.x;
+
+    Matrix rotation(*this);
+    if (fabs(s.x) > Math::Epsilon)
+        rotation.GetColumn(0) *= 1.0f / s.x;
+    if (s.y > Math::Epsilon)
+        rotation.GetColumn(1) *= 1.0f / s.y;
+    if (s.z > Math::Epsilon)
+        rotation.GetColumn(2) *= 1.0f / s.z;
+
+    r = Quaternion::FromMatrix(rotation);
+}
+
 	} // namespace Math
 } // namespace Framework
@@ -59,6 +59,9 @@ public:
 	Matrix FastMultiply(const Matrix &m) const;
     Vector3 FastMultiplyPoint(const Vector3 &v) const;
     Vector3 FastMultiplyVector(const Vector3 &v) const;
+
+    // Inverse of Matrix(t, r, s), without shear.
+    void Decompose(Vector3 &t, Quaternion &r, Vector3 &s) const;
 };
     
 	} // namespace Math
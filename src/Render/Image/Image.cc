@@ -42,6 +42,9 @@ Image::Image(Image &&other)
   height(other.height),
   pixels(other.pixels)
 {
+    if (pixels != nullptr)
+        allocator->SetRelocationHandle(pixels, &pixels);
+
     other.allocator = nullptr;
     other.format = ImageFormat::InvalidFormat;
     other.width = other.height = 0;
@@ -69,6 +72,8 @@ Image::operator =(Image &&other)
     width = other.width;
     height = other.height;
     pixels = other.pixels;
+    if (pixels != nullptr)
+        allocator->SetRelocationHandle(pixels, &pixels);
 
     other.allocator = nullptr;
     other.format = ImageFormat::InvalidFormat;
@@ -91,6 +96,7 @@ Image::Allocate(Allocator &_allocator, ImageFormat::Type _format, uint32_t _widt
     width = _width;
     height = _height;
     pixels = allocator->Allocate(ImageFormat(format).GetSurfaceSize(width, height), 1);
+    allocator->SetRelocationHandle(pixels, &pixels);
 }
 
 void
@@ -234,6 +240,7 @@ Image::Convert(ImageFormat::Type newFormat)
 
     format = newFormat;
     pixels = newPixels;
+    allocator->SetRelocationHandle(pixels, &pixels);
 }
 
 } // namespace Framework
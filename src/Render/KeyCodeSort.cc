@@ -0,0 +1,87 @@
+#include <cstring>
+#include <thread>
+#include "Render/KeyCodeSort.h"
+#include "Core/Collections/Sort.h"
+#include "Core/Debug.h"
+
+namespace Framework {
+	namespace RHI {
+
+typedef uint32_t Histograms[kKeyCodeSortBytes][256];
+
+static void
+BuildHistograms(const KeyCode *keys, uint32_t count, Histograms &histograms)
+{
+    memset(histograms, 0, sizeof(Histograms));
+    for (const KeyCode *key = keys, *end = keys + count; key < end; ++key) {
+        for (uint32_t i = 0; i < kKeyCodeSortBytes; ++i)
+            ++histograms[i][key->bytes[i]];
+    }
+}
+
+void
+RadixSort(KeyCode *keys, KeyCode *scratch, uint32_t count, uint32_t numThreads)
+{
+    if (count < 2)
+        return;
+
+    assert(numThreads > 0 && numThreads <= kKeyCodeSortMaxThreads);
+
+    Histograms histograms;
+    if (numThreads > 1 && count >= numThreads * kKeyCodeRadixSortThreshold) {
+        // Every thread counts a slice, this one included, then the partial histograms are summed.
+        Histograms partial[kKeyCodeSortMaxThreads - 1];
+        std::thread threads[kKeyCodeSortMaxThreads - 1];
+
+        uint32_t slice = count / numThreads;
+        for (uint32_t i = 1; i < numThreads; ++i) {
+            uint32_t first = i * slice,
+                     last = i == numThreads - 1 ? count : first + slice;
+            threads[i - 1] = std::thread(BuildHistograms, keys + first, last - first, std::ref(partial[i - 1]));
+        }
+
+        BuildHistograms(keys, slice, histograms);
+
+        for (uint32_t i = 1; i < numThreads; ++i) {
+            threads[i - 1].join();
+            for (uint32_t j = 0; j < kKeyCodeSortBytes; ++j) {
+                for (uint32_t k = 0; k < 256; ++k)
+                    histograms[j][k] += partial[i - 1][j][k];
+            }
+        }
+    } else {
+        BuildHistograms(keys, count, histograms);
+    }
+
+    KeyCode *src = keys, *dst = scratch;
+    for (int32_t i = kKeyCodeSortBytes - 1; i >= 0; --i) {
+        const uint32_t *histogram = histograms[i];
+        if (histogram[keys->bytes[i]] == count)
+            continue;
+
+        uint32_t offsets[256], sum = 0;
+        for (uint32_t k = 0; k < 256; ++k) {
+            offsets[k] = sum;
+            sum += histogram[k];
+        }
+
+        for (const KeyCode *key = src, *end = src + count; key < end; ++key)
+            dst[offsets[key->bytes[i]]++] = *key;
+
+        std::swap(src, dst);
+    }
+
+    if (src != keys)
+        memcpy(keys, src, sizeof(KeyCode) * count);
+}
+
+void
+ComparisonSort(KeyCode *keys, uint32_t count)
+{
+    Sorting::Sort(keys, keys + count, [] (const KeyCode &a, const KeyCode &b) {
+        return memcmp(a.bytes, b.bytes, kKeyCodeSortBytes) < 0;
+    });
+}
+
+	} // namespace RHI
+} // namespace Framework
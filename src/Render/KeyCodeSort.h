@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Render/KeyCode.h"
+
+namespace Framework {
+	namespace RHI {
+
+// Leading KeyCode bytes that define the order, compared like memcmp.
+static const uint32_t kKeyCodeSortBytes = 14;
+
+// Below this many keys a comparison sort is faster than the radix passes.
+static const uint32_t kKeyCodeRadixSortThreshold = 128;
+
+static const uint32_t kKeyCodeSortMaxThreads = 8;
+
+// Stable LSD radix sort, one scatter pass per byte, skipping the bytes all keys share.
+// scratch must hold count keys, with numThreads > 1 the histograms are built in parallel.
+void RadixSort(KeyCode *keys, KeyCode *scratch, uint32_t count, uint32_t numThreads = 1);
+
+// Same order, no scratch buffer needed.
+void ComparisonSort(KeyCode *keys, uint32_t count);
+
+	} // namespace RHI
+} // namespace Framework
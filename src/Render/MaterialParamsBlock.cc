@@ -1,5 +1,5 @@
 #include "Render/MaterialParamsBlock.h"
-#include "Core/Collections/Array.h"
+#include "Core/Collections/InlineArray.h"
 #include "Core/Memory/MallocAllocator.h"
 
 namespace Framework {
@@ -12,6 +12,14 @@ MaterialParamsBlock::MaterialParamsBlock()
   bufferParams (Memory::GetAllocator<MallocAllocator>())
 { }
 
+MaterialParamsBlock::MaterialParamsBlock(Allocator &allocator)
+: floatParams  (allocator),
+  vectorParams (allocator),
+  matrixParams (allocator),
+  textureParams(allocator),
+  bufferParams (allocator)
+{ }
+
 MaterialParamsBlock::MaterialParamsBlock(const MaterialParamsBlock &other)
 : floatParams  (other.floatParams),
   vectorParams (other.vectorParams),
@@ -21,11 +29,11 @@ MaterialParamsBlock::MaterialParamsBlock(const MaterialParamsBlock &other)
 { }
 
 MaterialParamsBlock::MaterialParamsBlock(MaterialParamsBlock &&other)
-: floatParams  (std::forward<Array<Materials::FloatParam>>  (other.floatParams)),
-  vectorParams (std::forward<Array<Materials::VectorParam>> (other.vectorParams)),
-  matrixParams (std::forward<Array<Materials::MatrixParam>> (other.matrixParams)),
-  textureParams(std::forward<Array<Materials::TextureParam>>(other.textureParams)),
-  bufferParams (std::forward<Array<Materials::BufferParam>> (other.bufferParams))
+: floatParams  (std::forward<InlineArray<Materials::FloatParam, 4>>  (other.floatParams)),
+  vectorParams (std::forward<InlineArray<Materials::VectorParam, 4>> (other.vectorParams)),
+  matrixParams (std::forward<InlineArray<Materials::MatrixParam, 2>> (other.matrixParams)),
+  textureParams(std::forward<InlineArray<Materials::TextureParam, 4>>(other.textureParams)),
+  bufferParams (std::forward<InlineArray<Materials::BufferParam, 2>> (other.bufferParams))
 { }
 
 MaterialParamsBlock::~MaterialParamsBlock()
@@ -45,11 +53,11 @@ MaterialParamsBlock::operator =(const MaterialParamsBlock &other)
 MaterialParamsBlock&
 MaterialParamsBlock::operator =(MaterialParamsBlock &&other)
 {
-	floatParams   = std::forward<Array<Materials::FloatParam>>  (other.floatParams);
-	vectorParams  = std::forward<Array<Materials::VectorParam>> (other.vectorParams);
-	matrixParams  = std::forward<Array<Materials::MatrixParam>> (other.matrixParams);
-    textureParams = std::forward<Array<Materials::TextureParam>>(other.textureParams);
-    bufferParams  = std::forward<Array<Materials::BufferParam>> (other.bufferParams);
+	floatParams   = std::forward<InlineArray<Materials::FloatParam, 4>>  (other.floatParams);
+	vectorParams  = std::forward<InlineArray<Materials::VectorParam, 4>> (other.vectorParams);
+	matrixParams  = std::forward<InlineArray<Materials::MatrixParam, 2>> (other.matrixParams);
+    textureParams = std::forward<InlineArray<Materials::TextureParam, 4>>(other.textureParams);
+    bufferParams  = std::forward<InlineArray<Materials::BufferParam, 2>> (other.bufferParams);
 	return (*this);
 }
 
@@ -63,6 +71,18 @@ MaterialParamsBlock::Clear()
 	bufferParams.Clear();
 }
 
+void
+MaterialParamsBlock::Reset()
+{
+    this->Clear();
+
+    floatParams.Trim();
+    vectorParams.Trim();
+    matrixParams.Trim();
+    textureParams.Trim();
+    bufferParams.Trim();
+}
+
 void
 MaterialParamsBlock::AddFloat(const StringHash &name, float value)
 {
@@ -7,6 +7,7 @@
 #include "Core/WeakPtr.h"
 #include "Render/Resources/Texture.h"
 #include "Render/RenderObjects.h"
+#include "Core/Collections/InlineArray_type.h"
 
 namespace Framework {
     namespace Materials {
@@ -27,13 +28,14 @@ typedef Param<SmartPtr<RHI::ComputeBuffer>> BufferParam;
 
 class MaterialParamsBlock {
 private:
-    Array<Materials::FloatParam>   floatParams;
-    Array<Materials::VectorParam>  vectorParams;
-    Array<Materials::MatrixParam>  matrixParams;
-    Array<Materials::TextureParam> textureParams;
-	Array<Materials::BufferParam>  bufferParams;
+    InlineArray<Materials::FloatParam,   4> floatParams;
+    InlineArray<Materials::VectorParam,  4> vectorParams;
+    InlineArray<Materials::MatrixParam,  2> matrixParams;
+    InlineArray<Materials::TextureParam, 4> textureParams;
+	InlineArray<Materials::BufferParam,  2> bufferParams;
 public:
     MaterialParamsBlock();
+    MaterialParamsBlock(Allocator &allocator);
     MaterialParamsBlock(const MaterialParamsBlock &other);
     MaterialParamsBlock(MaterialParamsBlock &&other);
     ~MaterialParamsBlock();
@@ -42,6 +44,7 @@ public:
     MaterialParamsBlock& operator =(MaterialParamsBlock &&other);
 
     void Clear();
+    void Reset();
 
     void AddFloat(const StringHash &name, float value);
     void AddFloat(const Materials::FloatParam &param);
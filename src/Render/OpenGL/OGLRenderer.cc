@@ -1,6 +1,8 @@
 #include "Render/OpenGL/OGLRenderer.h"
 #include "Core/Collections/Hash.h"
+#include "Core/Collections/InlineArray.h"
 #include "Core/Memory/MallocAllocator.h"
+#include "Core/Memory/ThreadCachingAllocator.h"
 #include "Math/Math.h"
 
 namespace Framework {
@@ -10,8 +12,8 @@ namespace Framework {
 DefineClassInfo(Framework::RHI::OpenGL::OGLRenderer, Framework::RHI::BaseRenderer);
 
 OGLRenderer::OGLRenderer()
-: fboHash(Memory::GetAllocator<MallocAllocator>()),
-  vaoHash(Memory::GetAllocator<MallocAllocator>()),
+: fboHash(Memory::GetAllocator<ThreadCachingAllocator>()), // grown by the render thread, trimmed by the main one
+  vaoHash(Memory::GetAllocator<ThreadCachingAllocator>()),
   unloadedMeshes(Memory::GetAllocator<MallocAllocator>()),
   unloadedShaders(Memory::GetAllocator<MallocAllocator>()),
   rtDestroyed(Memory::GetAllocator<MallocAllocator>())
@@ -1,7 +1,9 @@
 #include "Render/RenderQueue.h"
 #include "Core/Collections/SimplePool.h"
 #include "Render/Key.h"
+#include "Render/KeyCodeSort.h"
 #include "Core/Memory/MallocAllocator.h"
+#include "Core/Memory/FrameAllocator.h"
 #include "Core/Time/TimeServer.h"
 #include "Core/Log.h"
 #include "imgui.h"
@@ -16,8 +18,9 @@ DefineClassInfo(Framework::RenderQueue, Framework::RefCounted);
 RenderQueue::RenderQueue()
 : paramsBlocks(Memory::GetAllocator<MallocAllocator>()),
   clientParamsBlocks(Memory::GetAllocator<MallocAllocator>()),
-  commands(Memory::GetAllocator<MallocAllocator>()),
-  clientCommands(Memory::GetAllocator<MallocAllocator>()),
+  commands(Memory::GetAllocator<FrameAllocator>()),
+  clientCommands(Memory::GetAllocator<FrameAllocator>()),
+  sortScratch(nullptr),
   renderTargets(Memory::GetAllocator<MallocAllocator>()),
   frameCount(0),
   renderThread(&RenderQueue::RenderFrames, this),
@@ -55,7 +58,7 @@ RenderQueue::GetMaterialParamsBlock(MaterialParamsBlock **outPointer)
 {
     uint32_t index = clientParamsBlocks.Allocate();
     *outPointer = clientParamsBlocks.Begin() + index;
-    (*outPointer)->Clear();
+    **outPointer = MaterialParamsBlock(Memory::GetAllocator<FrameAllocator>());
     return index;
 }
 
@@ -109,10 +112,25 @@ RenderQueue::EndFrameCommands()
 
     std::swap(commands, clientCommands);
     std::swap(paramsBlocks, clientParamsBlocks);
+
+    // The frame arena isn't thread safe, so the render thread gets its sort buffer from here.
+    sortScratch = nullptr;
+    if (commands.Count() >= RHI::kKeyCodeRadixSortThreshold)
+        sortScratch = static_cast<RHI::KeyCode*>(Memory::GetAllocator<FrameAllocator>().Allocate(sizeof(RHI::KeyCode) * commands.Count(), __alignof(RHI::KeyCode)));
 	
     assert(0 == clientCommands.Count());
     assert(0 == clientParamsBlocks.Count());
 
+    // The render thread is done with the previous frame, drop everything it
+    // allocated before its arena gets reused for the next one.
+    for (MaterialParamsBlock *it = clientParamsBlocks.Begin(), *end = clientParamsBlocks.End(); it < end; ++it)
+        it->Reset();
+    clientCommands.Trim();
+
+    Memory::GetAllocator<FrameAllocator>().NextFrame();
+
+    clientCommands.Reserve(commands.Count());
+
     {
 		std::lock_guard<std::mutex> guard(rtMutex);
 		newFrame = true;
@@ -144,9 +162,10 @@ RenderQueue::RenderFrames()
         uint32_t cmdsCount = commands.Count();
         if (cmdsCount > 0)
         {
-            Array<RHI::KeyCode>::Sort(commands, 0, cmdsCount, [](const RHI::KeyCode &a, const RHI::KeyCode &b) {
-                return memcmp(a.bytes, b.bytes, 14) < 0;//sizeof(KeyCode)
-            });
+            if (sortScratch != nullptr)
+                RHI::RadixSort(commands.Begin(), sortScratch, cmdsCount);
+            else
+                RHI::ComparisonSort(commands.Begin(), cmdsCount);
 
             for (uint32_t i = 0; i < cmdsCount; ++i) {
                 RHI::Key key = commands[i];
@@ -22,6 +22,7 @@ protected:
 
     Array<RHI::KeyCode> commands;
 	Array<RHI::KeyCode> clientCommands;
+    RHI::KeyCode        *sortScratch; // radix sort buffer for commands, from the same frame arena
 
     Resource::IntrusiveList resourcesList;
 
@@ -1,7 +1,7 @@
 #include "Render/Resources/DDSLoader.h"
 #include "Core/Collections/Array.h"
 #include "Core/Memory/Memory.h"
-#include "Core/Memory/MallocAllocator.h"
+#include "Core/Memory/CompactingAllocator.h"
 #include "Core/Memory/ScratchAllocator.h"
 #include "Core/IO/FileServer.h"
 #include "Core/IO/BitStream.h"
@@ -305,7 +305,7 @@ bool DDSLoader::Load(const char *filename, Array<Image> &images)
                 if(w==0)w=1;
                 if(h==0)h=1;
 
-                Image level(Memory::GetAllocator<MallocAllocator>(), internalFormat, w, h);
+                Image level(Memory::GetAllocator<CompactingAllocator>(), internalFormat, w, h);
 
                 if(format==DDS_FORMAT_RGBA8)
                 {
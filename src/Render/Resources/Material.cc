@@ -1,6 +1,6 @@
 #include "Render/Resources/Material.h"
 #include "Render/Resources/ResourceServer.h"
-#include "Core/Memory/MallocAllocator.h"
+#include "Core/Memory/TLSFAllocator.h"
 #include "Core/Log.h"
 
 namespace Framework {
@@ -8,10 +8,10 @@ namespace Framework {
 DefineClassInfoWithFactory(Framework::Material, Framework::Resource);
 
 Material::Material()
-: floatParams (Memory::GetAllocator<MallocAllocator>()),
-  vectorParams(Memory::GetAllocator<MallocAllocator>()),
-  matrixParams(Memory::GetAllocator<MallocAllocator>()),
-  textures    (Memory::GetAllocator<MallocAllocator>())
+: floatParams (Memory::GetAllocator<TLSFAllocator>()),
+  vectorParams(Memory::GetAllocator<TLSFAllocator>()),
+  matrixParams(Memory::GetAllocator<TLSFAllocator>()),
+  textures    (Memory::GetAllocator<TLSFAllocator>())
 { }
 
 Material::~Material()
@@ -50,10 +50,10 @@ Material::UnloadImpl()
 {
     shader.Invalidate();
 
-    floatParams  = Hash<Materials::FloatParam>  (Memory::GetAllocator<MallocAllocator>());
-    vectorParams = Hash<Materials::VectorParam> (Memory::GetAllocator<MallocAllocator>());
-    matrixParams = Hash<Materials::MatrixParam> (Memory::GetAllocator<MallocAllocator>());
-    textures     = Hash<Materials::TextureParam>(Memory::GetAllocator<MallocAllocator>());
+    floatParams  = Hash<Materials::FloatParam>  (Memory::GetAllocator<TLSFAllocator>());
+    vectorParams = Hash<Materials::VectorParam> (Memory::GetAllocator<TLSFAllocator>());
+    matrixParams = Hash<Materials::MatrixParam> (Memory::GetAllocator<TLSFAllocator>());
+    textures     = Hash<Materials::TextureParam>(Memory::GetAllocator<TLSFAllocator>());
 }
 
 bool
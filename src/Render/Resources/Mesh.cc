@@ -1,6 +1,8 @@
 #include "Render/Resources/Mesh.h"
 #include "Core/Collections/Array.h"
-#include "Core/Memory/MallocAllocator.h"
+#include "Core/Collections/InlineArray.h"
+#include "Core/Memory/TLSFAllocator.h"
+#include "Core/Memory/CompactingAllocator.h"
 #include "Core/Memory/BlocksAllocator.h"
 #include "Core/IO/FileServer.h"
 #include "Core/Log.h"
@@ -10,16 +12,16 @@ namespace Framework {
     namespace RHI {
 
 MeshRenderData::MeshRenderData()
-: dc(Memory::GetAllocator<MallocAllocator>())
+: dc(Memory::GetAllocator<TLSFAllocator>())
 { }
 
 MeshRenderData::MeshRenderData(MeshRenderData &&other)
-: dc(Memory::GetAllocator<MallocAllocator>())
+: dc(Memory::GetAllocator<TLSFAllocator>())
 {
     vd = std::forward<VertexDecl>(other.vd);
     vb = std::forward<SmartPtr<RHI::VertexBuffer>>(other.vb);
     ib = std::forward<SmartPtr<RHI::IndexBuffer>>(other.ib);
-    dc = std::forward<Array<DrawPrimitives>>(other.dc);
+    dc = std::forward<InlineArray<DrawPrimitives, 4>>(other.dc);
 }
 
 MeshRenderData&
@@ -28,7 +30,7 @@ MeshRenderData::operator = (MeshRenderData &&other)
     vd = std::forward<VertexDecl>(other.vd);
     vb = std::forward<SmartPtr<RHI::VertexBuffer>>(other.vb);
     ib = std::forward<SmartPtr<RHI::IndexBuffer>>(other.ib);
-    dc = std::forward<Array<DrawPrimitives>>(other.dc);
+    dc = std::forward<InlineArray<DrawPrimitives, 4>>(other.dc);
     return (*this);
 }
 
@@ -45,10 +47,10 @@ MeshRenderData::Invalidate()
 DefineClassInfoWithFactory(Framework::Mesh, Framework::Resource);
 
 Mesh::Mesh()
-: vertexBufferData(Memory::GetAllocator<MallocAllocator>()),
-  indexBufferData(Memory::GetAllocator<MallocAllocator>()),
-  subMeshesBounds(Memory::GetAllocator<MallocAllocator>()),
-  subMeshesPrimitives(Memory::GetAllocator<MallocAllocator>())
+: vertexBufferData(Memory::GetAllocator<CompactingAllocator>()),
+  indexBufferData(Memory::GetAllocator<CompactingAllocator>()),
+  subMeshesBounds(Memory::GetAllocator<TLSFAllocator>()),
+  subMeshesPrimitives(Memory::GetAllocator<TLSFAllocator>())
 { }
 
 Mesh::~Mesh()
@@ -227,8 +229,8 @@ Mesh::UnloadImpl()
     vertexBuffer.Reset();
     indexBuffer.Reset();
 
-    vertexBufferData = BitStream(Memory::GetAllocator<MallocAllocator>());
-    indexBufferData = BitStream(Memory::GetAllocator<MallocAllocator>());
+    vertexBufferData = BitStream(Memory::GetAllocator<CompactingAllocator>());
+    indexBufferData = BitStream(Memory::GetAllocator<CompactingAllocator>());
 
     subMeshesBounds.SetCapacity(0);
     subMeshesPrimitives.SetCapacity(0);
@@ -4,6 +4,7 @@
 #include "Render/Resources/RenderResource.h"
 #include "Render/RenderObjects.h"
 #include "Core/Collections/Array_type.h"
+#include "Core/Collections/InlineArray_type.h"
 #include "Core/IO/BitStream.h"
 #include "Math/Bounds.h"
 
@@ -12,10 +13,10 @@ namespace Framework {
 
 struct MeshRenderData : RenderData
 {
-    VertexDecl                  vd;
-    SmartPtr<RHI::VertexBuffer> vb;
-    SmartPtr<RHI::IndexBuffer>  ib;
-    Array<DrawPrimitives>       dc;
+    VertexDecl                     vd;
+    SmartPtr<RHI::VertexBuffer>    vb;
+    SmartPtr<RHI::IndexBuffer>     ib;
+    InlineArray<DrawPrimitives, 4> dc;
 
     MeshRenderData();
     MeshRenderData(MeshRenderData &&other);
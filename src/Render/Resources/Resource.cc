@@ -2,6 +2,7 @@
 #include "Render/Resources/ResourceServer.h"
 #include "Core/Collections/List.h"
 #include "Render/RenderQueue.h"
+#include "Core/Memory/MemoryStats.h"
 
 namespace Framework {
 
@@ -26,6 +27,7 @@ Resource::Load()
     if (filename.IsEmpty())
         return isLoaded;
 
+    Memory::TagScope tagScope(this->GetRTTI()->GetMemoryTag());
     if (ReadOnly == access) {
         isLoaded = this->LoadImpl();
 
@@ -2,7 +2,7 @@
 #include "Core/Collections/Hash.h"
 #include "Core/String.h"
 #include "Core/StringHash.h"
-#include "Core/Memory/MallocAllocator.h"
+#include "Core/Memory/TLSFAllocator.h"
 #include "Core/Memory/BlocksAllocator.h"
 
 namespace Framework {
@@ -95,8 +95,8 @@ ResourceServer::CloneResource(const StringHash& name, Resource::Access access)
 
 ResourceServer::ResourceServer()
 : nextId(0),
-  resourcesById(Memory::GetAllocator<MallocAllocator>()),
-  resourcesByName(Memory::GetAllocator<MallocAllocator>())
+  resourcesById(Memory::GetAllocator<TLSFAllocator>()),
+  resourcesByName(Memory::GetAllocator<TLSFAllocator>())
 { }
 
 ResourceServer::~ResourceServer()
@@ -1,7 +1,7 @@
 #include "Render/Resources/Texture.h"
 #include "Core/Collections/Array.h"
 #include "Core/IO/Path.h"
-#include "Core/Memory/MallocAllocator.h"
+#include "Core/Memory/CompactingAllocator.h"
 #include "Core/Memory/BlocksAllocator.h"
 #include "Render/Resources/DDSLoader.h"
 
@@ -119,7 +119,7 @@ Texture::Load(const RHI::TextureBufferDesc &desc)
     images.Resize(desc.mipmapsRangeMax + 1);
 
     for (uint8_t lvl = desc.mipmapsRangeMin; lvl <= desc.mipmapsRangeMax; ++lvl) {
-        images[lvl] = Image(Memory::GetAllocator<MallocAllocator>(),
+        images[lvl] = Image(Memory::GetAllocator<CompactingAllocator>(),
                             buffer->GetFormat(),
                             RHI::MipmapSize(buffer->GetWidth(), lvl),
                             RHI::MipmapSize(buffer->GetHeight(), lvl));
@@ -200,7 +200,7 @@ Texture::LoadImages()
     RHI::LockInfo lockInfo;
     Memory::Zero(&lockInfo);
     for (uint8_t lvl = lvlMin; lvl <= lvlMax; ++lvl) {
-        images[lvl] = Image(Memory::GetAllocator<MallocAllocator>(),
+        images[lvl] = Image(Memory::GetAllocator<CompactingAllocator>(),
                             buffer->GetFormat(),
                             RHI::MipmapSize(buffer->GetWidth(), lvl),
                             RHI::MipmapSize(buffer->GetHeight(), lvl));
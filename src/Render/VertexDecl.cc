@@ -1,5 +1,5 @@
 #include "Render/VertexDecl.h"
-#include "Core/Collections/Array.h"
+#include "Core/Collections/InlineArray.h"
 #include "Core/Memory/MallocAllocator.h"
 
 namespace Framework {
@@ -14,7 +14,7 @@ VertexDecl::VertexDecl(const VertexDecl &other)
 { }
 
 VertexDecl::VertexDecl(VertexDecl &&other)
-: elements(std::forward<Array<VertexElement>>(other.elements))
+: elements(std::forward<InlineArray<VertexElement, 8>>(other.elements))
 { }
 
 VertexDecl::~VertexDecl ( )
@@ -30,7 +30,7 @@ VertexDecl::operator =(const VertexDecl &other)
 VertexDecl&
 VertexDecl::operator =(VertexDecl &&other)
 {
-	elements = std::forward<Array<VertexElement>>(other.elements);
+	elements = std::forward<InlineArray<VertexElement, 8>>(other.elements);
     return (*this);
 }
 
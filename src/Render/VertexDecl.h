@@ -1,6 +1,6 @@
 #pragma once
 
-#include "Core/Collections/Array_type.h"
+#include "Core/Collections/InlineArray_type.h"
 
 namespace Framework {
 	namespace RHI {
@@ -32,7 +32,7 @@ public:
         uint32_t   offset;
     };
 private:
-    Array<VertexElement> elements;
+    InlineArray<VertexElement, 8> elements;
 public:
     VertexDecl();
     VertexDecl(const VertexDecl &other);